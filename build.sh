@@ -1,16 +1,38 @@
 cd ./src/
+# the code cache ignores entries written by a build of other sources
+BUILD_ID=$(find . -name '*.cpp' -o -name '*.hpp' -o -name 'subcc.[ly]' | LC_ALL=C sort | xargs cat | sha1sum | cut -c1-16)
+
 bison -d subcc.y
 g++ -w -c subcc.tab.c
 
 flex -o subcc.yy.c subcc.l
 g++ -w -c subcc.yy.c
 
-g++ subcc.tab.o subcc.yy.o \
+g++ -pthread -DSUBCC_BUILD_ID="\"$BUILD_ID\"" subcc.tab.o subcc.yy.o \
     ./symbol-table/ScopeTable/ScopeTable.cpp \
     ./symbol-table/ScopeTable/SymbolInfoHashTable/SymbolInfoHashTable.cpp \
     ./symbol-table/SymbolInfo/SymbolInfo.cpp \
     ./symbol-table/SymbolTable/SymbolTable.cpp \
     ./symbol-table/SymbolInfo/CodeGenInfo/CodeGenInfo.cpp \
+    ./symbol-table/SymbolInfo/SemanticType.cpp \
+    ./ast/ASTNode/ASTNode.cpp \
+    ./code-generator/CodeGenerator/CodeGenerator.cpp \
+    ./code-generator/AsmBuffer/AsmBuffer.cpp \
+    ./code-generator/CodeCache/CodeCache.cpp \
+    ./code-generator/Instruction/Instruction.cpp \
+    ./code-generator/RegisterAllocator/RegisterAllocator.cpp \
+    ./code-generator/ConstantEvaluator/ConstantEvaluator.cpp \
+    ./code-generator/LoopAnalyzer/LoopAnalyzer.cpp \
+    ./optimizer/PeepholeOptimizer/PeepholeOptimizer.cpp \
+    ./optimizer/DeadCodeEliminator/DeadCodeEliminator.cpp \
+    ./optimizer/Inliner/Inliner.cpp \
+    ./source-buffer/SourceBuffer/SourceBuffer.cpp \
+    ./arena/Arena/Arena.cpp \
+    ./symbol-table/StringInterner/StringInterner.cpp \
+    ./symbol-table/SignatureInterner/SignatureInterner.cpp \
+    ./compiler-context/CompilerContext/CompilerContext.cpp \
+    ./compiler-context/CompilerStats/CompilerStats.cpp \
+    ./worker-pool/WorkerPool/WorkerPool.cpp \
     -o ./../subcc.out
 
 rm *.c *.h *.o
\ No newline at end of file
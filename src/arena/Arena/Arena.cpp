@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include "Arena.hpp"
+
+using namespace std;
+
+const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+Arena::Arena()
+    : Arena(DEFAULT_BLOCK_SIZE) {
+}
+
+Arena::Arena(size_t block_size)
+    : current_block_ptr(nullptr), last_finalizer_ptr(nullptr), block_size(block_size),
+    allocation_count(0), block_count(0), bytes_allocated(0) {
+}
+
+Arena::~Arena() {
+    this->release();
+}
+
+/**
+ * @brief Allocates raw memory from the current block, or from a new block if it does not fit.
+ * Allocations larger than the block size get a block of their own.
+ *
+ * @param size Size in bytes
+ * @param alignment Alignment in bytes, a power of two
+ * @return void* Pointer to the memory
+ */
+void* Arena::allocate(size_t size, size_t alignment) {
+    void* memory_ptr = this->allocate_from_block(size, alignment);
+    if (memory_ptr != nullptr) {
+        return memory_ptr;
+    }
+
+    size_t header_size = (sizeof(Block) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+    size_t data_size = size + alignment > this->block_size ? size + alignment : this->block_size;
+    Block* block_ptr = static_cast<Block*>(malloc(header_size + data_size));
+    if (block_ptr == nullptr) {
+        throw bad_alloc();
+    }
+    block_ptr->prev_block_ptr = this->current_block_ptr;
+    block_ptr->size = header_size + data_size;
+    block_ptr->used = header_size;
+    this->current_block_ptr = block_ptr;
+    this->block_count++;
+
+    return this->allocate_from_block(size, alignment);
+}
+
+/**
+ * @brief Destroys all objects created in the arena, in reverse order of creation, and frees all blocks.
+ * The arena can be used again afterwards. The counters are kept.
+ */
+void Arena::release() {
+    while (this->last_finalizer_ptr != nullptr) {
+        this->last_finalizer_ptr->destroy(this->last_finalizer_ptr->object_ptr);
+        this->last_finalizer_ptr = this->last_finalizer_ptr->prev_finalizer_ptr;
+    }
+
+    while (this->current_block_ptr != nullptr) {
+        Block* prev_block_ptr = this->current_block_ptr->prev_block_ptr;
+        free(this->current_block_ptr);
+        this->current_block_ptr = prev_block_ptr;
+    }
+}
+
+/**
+ * @brief Returns the number of objects created in the arena so far.
+ */
+size_t Arena::get_allocation_count() {
+    return this->allocation_count;
+}
+
+/**
+ * @brief Returns the number of blocks allocated from the heap so far, i.e. the heap allocations that
+ * served all the objects.
+ */
+size_t Arena::get_block_count() {
+    return this->block_count;
+}
+
+size_t Arena::get_bytes_allocated() {
+    return this->bytes_allocated;
+}
+
+void* Arena::allocate_from_block(size_t size, size_t alignment) {
+    if (this->current_block_ptr == nullptr) {
+        return nullptr;
+    }
+
+    char* block_start = reinterpret_cast<char*>(this->current_block_ptr);
+    size_t start = this->current_block_ptr->used;
+    size_t misalignment = reinterpret_cast<size_t>(block_start + start) & (alignment - 1);
+    if (misalignment != 0) {
+        start += alignment - misalignment;
+    }
+    if (start + size > this->current_block_ptr->size) {
+        return nullptr;
+    }
+
+    this->current_block_ptr->used = start + size;
+    this->bytes_allocated += size;
+    return block_start + start;
+}
+
+void Arena::add_finalizer(void* object_ptr, void (*destroy)(void*)) {
+    Finalizer* finalizer_ptr = static_cast<Finalizer*>(this->allocate(sizeof(Finalizer), alignof(Finalizer)));
+    finalizer_ptr->prev_finalizer_ptr = this->last_finalizer_ptr;
+    finalizer_ptr->destroy = destroy;
+    finalizer_ptr->object_ptr = object_ptr;
+    this->last_finalizer_ptr = finalizer_ptr;
+}
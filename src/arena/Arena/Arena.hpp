@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+/**
+ * @brief Bump allocator for objects that all die together, e.g. the semantic values of the parser and the
+ * AST. Objects are carved out of large blocks, so creating one is a pointer bump instead of a malloc, and
+ * all of them are destroyed at once by release(). Counts the objects created and the blocks allocated
+ * from the heap to serve them.
+ */
+class Arena {
+    struct Block {
+        Block* prev_block_ptr;
+        size_t size;
+        size_t used;
+    };
+
+    // destructor to be run on release, for objects that are not trivially destructible
+    struct Finalizer {
+        Finalizer* prev_finalizer_ptr;
+        void (*destroy)(void*);
+        void* object_ptr;
+    };
+
+    Block* current_block_ptr;
+    Finalizer* last_finalizer_ptr;
+    const size_t block_size;
+
+    size_t allocation_count;
+    size_t block_count;
+    size_t bytes_allocated;
+
+public:
+    Arena();
+
+    Arena(size_t);
+
+    ~Arena();
+
+    void* allocate(size_t, size_t);
+
+    /**
+     * @brief Constructs an object in the arena. The object must not be deleted, it is destroyed by release().
+     *
+     * @param args Constructor arguments
+     * @return T* Pointer to the object
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* object_ptr = new (this->allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+        if (!is_trivially_destructible<T>::value) {
+            this->add_finalizer(object_ptr, [](void* ptr) { static_cast<T*>(ptr)->~T(); });
+        }
+        this->allocation_count++;
+        return object_ptr;
+    }
+
+    void release();
+
+    size_t get_allocation_count();
+
+    size_t get_block_count();
+
+    size_t get_bytes_allocated();
+
+private:
+    void* allocate_from_block(size_t, size_t);
+
+    void add_finalizer(void*, void (*)(void*));
+};
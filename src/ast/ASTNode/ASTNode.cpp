@@ -0,0 +1,78 @@
+#include "ASTNode.hpp"
+
+using namespace std;
+
+ASTNode::ASTNode(NodeKind kind, const SourceSpan& span, SemanticType semantic_type)
+    : kind(kind), span(span), name_id{ 0 }, semantic_type(semantic_type), count{ 0 }, codegeninfo{}, children{} {
+}
+
+ASTNode::ASTNode(NodeKind kind, const SourceSpan& span, SemanticType semantic_type, int name_id)
+    : ASTNode(kind, span, semantic_type) {
+    this->name_id = name_id;
+}
+
+NodeKind ASTNode::get_kind() {
+    return this->kind;
+}
+
+SourceSpan ASTNode::get_span() {
+    return this->span;
+}
+
+/**
+ * @brief Returns the handle of the name in the string interner.
+ */
+int ASTNode::get_name_id() {
+    return this->name_id;
+}
+
+SemanticType ASTNode::get_semantic_type() {
+    return this->semantic_type;
+}
+
+int ASTNode::get_count() {
+    return this->count;
+}
+
+CodeGenInfo* ASTNode::get_codegen_info_ptr() {
+    return &this->codegeninfo;
+}
+
+vector<ASTNode*>& ASTNode::get_children() {
+    return this->children;
+}
+
+ASTNode* ASTNode::get_child(int idx) {
+    return this->children[idx];
+}
+
+int ASTNode::get_num_children() {
+    return this->children.size();
+}
+
+void ASTNode::set_span(const SourceSpan& span) {
+    this->span = span;
+}
+
+void ASTNode::set_semantic_type(SemanticType semantic_type) {
+    this->semantic_type = semantic_type;
+}
+
+void ASTNode::set_count(int count) {
+    this->count = count;
+}
+
+void ASTNode::add_child(ASTNode* child) {
+    this->children.push_back(child);
+}
+
+/**
+ * @brief Moves all children of the other node to the end of this node's children. The other node is
+ * left without children.
+ *
+ * @param other Node whose children are taken
+ */
+void ASTNode::adopt_children(ASTNode* other) {
+    this->children.insert(this->children.end(), other->children.begin(), other->children.end());
+    other->children.clear();
+}
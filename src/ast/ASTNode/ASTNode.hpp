@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../../symbol-table/SymbolInfo/CodeGenInfo/CodeGenInfo.hpp"
+#include "../../symbol-table/SymbolInfo/SemanticType.hpp"
+#include "../../symbol-table/StringInterner/StringInterner.hpp"
+#include "../SourceSpan/SourceSpan.hpp"
+
+using namespace std;
+
+/**
+ * @brief Kinds of nodes of the abstract syntax tree. List is only used by the parser to collect
+ * parameters, declarators and arguments before they are adopted by their parent node.
+ */
+enum class NodeKind {
+    Program, List,
+    VarDeclaration, Declarator, FuncDeclaration, FuncDefinition, Parameter,
+    CompoundStatement, ExpressionStatement, ForStatement, IfStatement, WhileStatement, PrintlnStatement,
+    ReturnStatement,
+    Assignment, LogicExpression, RelExpression, AddExpression, MulExpression, UnaryExpression, NotExpression,
+    Variable, Call, ConstInt, ConstFloat, PostIncrement, PostDecrement
+};
+
+/**
+ * @brief Node of the typed abstract syntax tree built by the Analysis actions of the parser. Contains the
+ * span of the node in the source buffer, the semantic type, the name of the identifier/operator/literal and
+ * the children of the node. Storage of variables (local or global, stack offset) is resolved during Analysis
+ * and kept in the node's code gen info, so code generation never consults the symbol table.
+ *
+ * Children of each kind, in order:
+ *  Program: units (VarDeclaration, FuncDeclaration, FuncDefinition)
+ *  VarDeclaration: Declarators
+ *  FuncDeclaration, FuncDefinition: Parameters, body CompoundStatement (definition only)
+ *  CompoundStatement: statements
+ *  ExpressionStatement: expression (none for empty statement)
+ *  ForStatement: init ExpressionStatement, condition ExpressionStatement, step expression, body
+ *  IfStatement: condition, body, else body (optional)
+ *  WhileStatement: condition, body
+ *  PrintlnStatement: Variable
+ *  ReturnStatement: expression
+ *  Assignment: Variable, expression
+ *  LogicExpression, RelExpression, AddExpression, MulExpression: left and right operand
+ *  UnaryExpression, NotExpression: operand
+ *  Variable: index expression (array element only)
+ *  Call: arguments
+ *  PostIncrement, PostDecrement: Variable
+ *
+ * Count holds the array length of a Declarator, and the number of stack slots of all the locals of a
+ * FuncDefinition, its frame.
+ *
+ * The name is kept as its handle in the string interner of the compilation, handle 0 is the empty name.
+ *
+ * Nodes are created in an arena and destroyed together with it, a node does not delete its children.
+ */
+class ASTNode {
+    NodeKind kind;
+    SourceSpan span;
+    int name_id;
+    SemanticType semantic_type;
+    int count;
+    CodeGenInfo codegeninfo;
+    vector<ASTNode*> children;
+
+public:
+    ASTNode(NodeKind, const SourceSpan&, SemanticType);
+    ASTNode(NodeKind, const SourceSpan&, SemanticType, int);
+
+    NodeKind get_kind();
+    SourceSpan get_span();
+    int get_name_id();
+    SemanticType get_semantic_type();
+    int get_count();
+    CodeGenInfo* get_codegen_info_ptr();
+    vector<ASTNode*>& get_children();
+    ASTNode* get_child(int);
+    int get_num_children();
+
+    void set_span(const SourceSpan&);
+    void set_semantic_type(SemanticType);
+    void set_count(int);
+    void add_child(ASTNode*);
+    void adopt_children(ASTNode*);
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Byte range [begin, end) of a construct in the source buffer. The text of a construct is not
+ * copied into the tree, it is read from the source buffer only when it is written to the log.
+ */
+struct SourceSpan {
+    size_t begin;
+    size_t end;
+};
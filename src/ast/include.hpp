@@ -0,0 +1,4 @@
+#pragma once
+// headers
+#include "SourceSpan/SourceSpan.hpp"
+#include "ASTNode/ASTNode.hpp"
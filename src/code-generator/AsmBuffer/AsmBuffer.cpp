@@ -0,0 +1,184 @@
+#include <fstream>
+#include "AsmBuffer.hpp"
+
+using namespace std;
+
+AsmLine AsmLine::op(Opcode opcode, Operand dst, Operand src) {
+    return AsmLine{LineKind::Instruction, 0, Instruction{opcode, dst, src}, 0};
+}
+
+AsmLine AsmLine::label(const Operand& label) {
+    AsmLine line = AsmLine::blank();
+    line.kind = LineKind::Label;
+    line.instruction.dst = label;
+    return line;
+}
+
+AsmLine AsmLine::comment(int text_id) {
+    AsmLine line = AsmLine::blank();
+    line.kind = LineKind::Comment;
+    line.text_id = text_id;
+    return line;
+}
+
+AsmLine AsmLine::proc_begin(int proc_name_id) {
+    AsmLine line = AsmLine::blank();
+    line.kind = LineKind::ProcBegin;
+    line.text_id = proc_name_id;
+    return line;
+}
+
+/**
+ * @param proc_name_id Handle of the procedure name to repeat after ENDP, 0 for none
+ */
+AsmLine AsmLine::proc_end(int proc_name_id) {
+    AsmLine line = AsmLine::blank();
+    line.kind = LineKind::ProcEnd;
+    line.text_id = proc_name_id;
+    return line;
+}
+
+AsmLine AsmLine::blank() {
+    return AsmLine{LineKind::Blank, 0, Instruction{Opcode::MOV, Operand::none(), Operand::none()}, 0};
+}
+
+bool AsmLine::is_op(Opcode opcode) const {
+    return this->kind == LineKind::Instruction && this->instruction.opcode == opcode;
+}
+
+/**
+ * @brief Appends the line in MASM syntax, with its indentation and newline.
+ */
+void AsmLine::print(string& out, StringInterner& string_interner) const {
+    out.append(this->indentation, '\t');
+
+    switch (this->kind) {
+        case LineKind::Instruction:
+            this->instruction.print(out, string_interner);
+            break;
+        case LineKind::Label:
+            this->instruction.dst.print(out, string_interner);
+            out += ':';
+            break;
+        case LineKind::Comment:
+            out += "; ";
+            out += string_interner.get_string(this->text_id);
+            break;
+        case LineKind::ProcBegin:
+            out += string_interner.get_string(this->text_id);
+            out += " PROC";
+            break;
+        case LineKind::ProcEnd:
+            out += "ENDP";
+            if (this->text_id != 0) {
+                out += ' ';
+                out += string_interner.get_string(this->text_id);
+            }
+            break;
+        case LineKind::Blank:
+            break;
+    }
+    out += '\n';
+}
+
+AsmBuffer::AsmBuffer()
+    : data_section{}, code_section{} {
+}
+
+/**
+ * @brief Appends a global variable to the data section.
+ *
+ * @param symbol_id Handle of the variable name
+ * @param array_size Number of elements of an array, 0 for a variable that is not an array
+ */
+void AsmBuffer::write_data(int symbol_id, int array_size) {
+    this->data_section.push_back(DataDefinition{symbol_id, array_size, false, -1});
+}
+
+/**
+ * @brief Appends bytes to the data section, that directly follow the data written before them.
+ *
+ * @param symbol_id Handle of the name of the first byte
+ * @param buffer_size Number of bytes left uninitialized, 0 if values are given
+ * @param values_id Handle of the values of the bytes, -1 for a buffer
+ */
+void AsmBuffer::write_byte_data(int symbol_id, int buffer_size, int values_id) {
+    this->data_section.push_back(DataDefinition{symbol_id, buffer_size, true, values_id});
+}
+
+/**
+ * @brief Appends a line to the end of the code section.
+ *
+ * @param line Code line
+ * @param indentation Number of tabs before the line
+ */
+void AsmBuffer::write_code(AsmLine line, int indentation) {
+    line.indentation = indentation;
+    this->code_section.push_back(line);
+}
+
+void AsmBuffer::write_code(const vector<AsmLine>& lines, int indentation) {
+    for (const AsmLine& line : lines) {
+        this->write_code(line, indentation);
+    }
+}
+
+/**
+ * @brief Appends code that was written into another buffer, with its indentation. Its numbered labels are
+ * renumbered after the labels of the code before it.
+ *
+ * @param lines Code lines, with labels numbered from 0
+ * @param label_offset Number of the labels of the code before the lines
+ */
+void AsmBuffer::append_code(const vector<AsmLine>& lines, int label_offset) {
+    for (AsmLine line : lines) {
+        for (Operand* operand_ptr : {&line.instruction.dst, &line.instruction.src}) {
+            if (operand_ptr->kind == OperandKind::Label && operand_ptr->value >= 0) {
+                operand_ptr->value += label_offset;
+            }
+        }
+        this->code_section.push_back(line);
+    }
+}
+
+vector<AsmLine>& AsmBuffer::get_code_section() {
+    return this->code_section;
+}
+
+void AsmBuffer::print_data_section(string& out, StringInterner& string_interner) {
+    for (const DataDefinition& data_def : this->data_section) {
+        out += '\t';
+        out += string_interner.get_string(data_def.symbol_id);
+        if (data_def.is_byte && data_def.values_id >= 0) {
+            out += " DB " + string_interner.get_string(data_def.values_id) + "\n";
+        } else if (data_def.is_byte) {
+            out += " DB " + to_string(data_def.array_size) + " DUP(?)\n";
+        } else if (data_def.array_size > 0) {
+            out += " DW " + to_string(data_def.array_size) + " DUP(0)\n";
+        } else {
+            out += " DW 0\n";
+        }
+    }
+}
+
+void AsmBuffer::print_code_section(string& out, StringInterner& string_interner) {
+    for (const AsmLine& line : this->code_section) {
+        line.print(out, string_interner);
+    }
+}
+
+/**
+ * @brief Writes the text to a file with a single write.
+ *
+ * @param file_name Path of the file, overwritten if it exists
+ * @param text Text to write
+ * @return true if the file was written
+ */
+bool AsmBuffer::write_to_file(const string& file_name, const string& text) {
+    ofstream file(file_name, ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.write(text.data(), text.size());
+    return bool(file);
+}
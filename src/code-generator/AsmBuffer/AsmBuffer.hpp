@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../Instruction/Instruction.hpp"
+
+using namespace std;
+
+enum class LineKind : unsigned char {
+    Instruction, Label, Comment, ProcBegin, ProcEnd, Blank
+};
+
+/**
+ * @brief Line of the code section. Comments and procedure names are interned strings, referred to by
+ * text_id (0 for a procedure end without a name), and spelt from the string interner when printed.
+ */
+struct AsmLine {
+    LineKind kind;
+    unsigned char indentation;
+    Instruction instruction;
+    int text_id;
+
+    static AsmLine op(Opcode, Operand = Operand::none(), Operand = Operand::none());
+    static AsmLine label(const Operand&);
+    static AsmLine comment(int);
+    static AsmLine proc_begin(int);
+    static AsmLine proc_end(int = 0);
+    static AsmLine blank();
+
+    bool is_op(Opcode) const;
+
+    void print(string&, StringInterner&) const;
+};
+
+/**
+ * @brief Global variable of the data segment, an array when array_size is positive. Byte data of the runtime
+ * is either a buffer of array_size bytes, or the bytes of the interned values_id, e.g. "10, 13".
+ */
+struct DataDefinition {
+    int symbol_id;
+    int array_size;
+    bool is_byte;
+    int values_id;
+};
+
+/**
+ * @brief In-memory output of the code generator. The data section holds the global variables and the code
+ * section the lines of the procedures, so globals are placed before the code however late they are
+ * generated. Code is kept as structured instructions that optimizations can match and rewrite, and is only
+ * printed to MASM syntax once the program is complete.
+ */
+class AsmBuffer {
+    vector<DataDefinition> data_section;
+    vector<AsmLine> code_section;
+
+public:
+    AsmBuffer();
+
+    void write_data(int, int = 0);
+
+    void write_byte_data(int, int, int = -1);
+
+    void write_code(AsmLine, int = 0);
+
+    void write_code(const vector<AsmLine>&, int = 0);
+
+    void append_code(const vector<AsmLine>&, int);
+
+    vector<AsmLine>& get_code_section();
+
+    void print_data_section(string&, StringInterner&);
+
+    void print_code_section(string&, StringInterner&);
+
+    static bool write_to_file(const string&, const string&);
+};
@@ -0,0 +1,327 @@
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include "CodeCache.hpp"
+
+using namespace std;
+
+// bumped whenever the entries or the code generated for them change
+const int CACHE_FORMAT_VERSION = 1;
+// hash of the sources of the compiler, passed by build.sh, so a rebuild of changed sources ignores older entries
+#ifndef SUBCC_BUILD_ID
+#define SUBCC_BUILD_ID "unknown"
+#endif
+// entries written by another version or build of the compiler may hold other code
+const string CACHE_VERSION = "subcc " + to_string(CACHE_FORMAT_VERSION) + " " SUBCC_BUILD_ID;
+const string CACHE_SECTION_NAMES[NUM_CACHE_SECTIONS] = {"code", "optimized"};
+// temporary files of the process, the caches of a batch write into the same directory
+static atomic<int> next_temp_id{ 0 };
+
+/**
+ * @param dir_name Directory of the entries, created when the first entry is written
+ * @param is_hit_verified Whether the work of a hit is redone and compared with the entry
+ * @param string_interner Interner of the names of the lines
+ */
+CodeCache::CodeCache(const string& dir_name, bool is_hit_verified, StringInterner& string_interner)
+    : dir_name(dir_name), is_hit_verified(is_hit_verified), string_interner(string_interner), hit_counts{},
+    miss_counts{}, mismatch_counts{} {
+}
+
+bool CodeCache::is_verified() const {
+    return this->is_hit_verified;
+}
+
+/**
+ * @brief Reads the entry of a key, counting a hit or a miss.
+ *
+ * @param section Kind of the entry
+ * @param key Input of the work the entry saves
+ * @param label_base Number the labels of the entry are renumbered from
+ * @param lines Set to the lines of the entry
+ * @param counts Set to the counts of the entry
+ * @return false if there is no entry of the key, or it cannot be read
+ */
+bool CodeCache::load(CacheSection section, const string& key, int label_base, vector<AsmLine>& lines,
+    vector<int>& counts) {
+    string value;
+    lines.clear();
+    counts.clear();
+    bool is_hit = this->read_entry(section, key, value) && this->decode_entry(value, label_base, lines, counts);
+    if (is_hit) {
+        this->hit_counts[(int)section]++;
+    } else {
+        this->miss_counts[(int)section]++;
+        lines.clear();
+        counts.clear();
+    }
+    return is_hit;
+}
+
+/**
+ * @brief Writes the entry of a key, replacing any entry of it.
+ *
+ * @param section Kind of the entry
+ * @param key Input of the work the entry saves
+ * @param label_base Number the labels of the lines are numbered from
+ * @param lines Lines produced by the work
+ * @param counts Counts produced by the work
+ */
+void CodeCache::store(CacheSection section, const string& key, int label_base, const vector<AsmLine>& lines,
+    const vector<int>& counts) {
+    error_code dir_error;
+    filesystem::create_directories(this->dir_name, dir_error);
+
+    string entry_path = this->get_entry_path(section, key);
+    string temp_path = entry_path + "." + to_string(getpid()) + "." + to_string(next_temp_id++) + ".tmp";
+    string value = this->encode_entry(label_base, lines, counts);
+    string key_size = to_string(key.size()) + "\n";
+    ofstream temp_file(temp_path, ios::binary);
+    temp_file.write(key_size.data(), key_size.size());
+    temp_file.write(key.data(), key.size());
+    temp_file.write(value.data(), value.size());
+    temp_file.close();
+
+    // a failed write leaves no entry, the work is redone next time
+    if (!temp_file || rename(temp_path.c_str(), entry_path.c_str()) != 0) {
+        remove(temp_path.c_str());
+    }
+}
+
+/**
+ * @brief Compares the redone work of a hit with its entry. The entry is replaced if they do not match.
+ *
+ * @param section Kind of the entry
+ * @param key Input of the work the entry saves
+ * @param label_base Number the labels of the lines are numbered from
+ * @param lines Lines produced by the work
+ * @param counts Counts produced by the work
+ */
+void CodeCache::verify(CacheSection section, const string& key, int label_base, const vector<AsmLine>& lines,
+    const vector<int>& counts) {
+    string value;
+    if (this->read_entry(section, key, value) && value == this->encode_entry(label_base, lines, counts)) {
+        return;
+    }
+    this->mismatch_counts[(int)section]++;
+    this->store(section, key, label_base, lines, counts);
+}
+
+/**
+ * @brief Writes the hits and misses of each kind of entry, and the hits that did not match their redone work
+ * when they are verified.
+ */
+void CodeCache::write_stats(ostream& ostrm) const {
+    ostrm << "Code cache: " << this->dir_name << "\n";
+    for (int i = 0; i < NUM_CACHE_SECTIONS; i++) {
+        int hit_count = this->hit_counts[i], miss_count = this->miss_counts[i];
+        ostringstream hit_rate_stream;
+        hit_rate_stream << fixed << setprecision(1) <<
+            (hit_count + miss_count > 0 ? 100.0 * hit_count / (hit_count + miss_count) : 0.0);
+        ostrm << "\t" << CACHE_SECTION_NAMES[i] << ": " << hit_count << " hits, " << miss_count << " misses, " <<
+            hit_rate_stream.str() << "% hit rate";
+        if (this->is_hit_verified) {
+            ostrm << ", " << this->mismatch_counts[i] << " mismatches";
+        }
+        ostrm << "\n";
+    }
+}
+
+/**
+ * @brief Appends the lines as text, each name written out and each numbered label relative to the base.
+ *
+ * @param lines Code lines
+ * @param label_base Number subtracted from the numbered labels
+ * @param out Text the lines are appended to
+ */
+void CodeCache::encode_lines(const vector<AsmLine>& lines, int label_base, string& out) const {
+    out += to_string(lines.size());
+    out += '\n';
+    for (const AsmLine& line : lines) {
+        out += to_string((int)line.kind) + ' ' + to_string(line.indentation) + ' ' +
+            to_string((int)line.instruction.opcode);
+        this->encode_operand(line.instruction.dst, label_base, out);
+        this->encode_operand(line.instruction.src, label_base, out);
+        CodeCache::encode_string(this->string_interner.get_string(line.text_id), out);
+        out += '\n';
+    }
+}
+
+/**
+ * @brief Lowest number of the numbered labels of the lines, 0 if there are none.
+ */
+int CodeCache::get_label_base(const vector<AsmLine>& lines) {
+    int label_base = -1;
+    for (const AsmLine& line : lines) {
+        for (const Operand* operand_ptr : {&line.instruction.dst, &line.instruction.src}) {
+            if (operand_ptr->kind == OperandKind::Label && operand_ptr->value >= 0 &&
+                (label_base < 0 || operand_ptr->value < label_base)) {
+                label_base = operand_ptr->value;
+            }
+        }
+    }
+    return label_base < 0 ? 0 : label_base;
+}
+
+/**
+ * @brief Reads the value of the entry of a key, if the file of the entry holds that key.
+ */
+bool CodeCache::read_entry(CacheSection section, const string& key, string& value) {
+    ifstream entry_file(this->get_entry_path(section, key), ios::binary);
+    if (!entry_file) {
+        return false;
+    }
+    stringstream entry_stream;
+    entry_stream << entry_file.rdbuf();
+    string entry = entry_stream.str();
+
+    size_t key_start = entry.find('\n');
+    if (key_start == string::npos || entry.compare(0, key_start, to_string(key.size())) != 0 ||
+        entry.compare(key_start + 1, key.size(), key) != 0) {
+        return false;
+    }
+    value = entry.substr(key_start + 1 + key.size());
+    return true;
+}
+
+/**
+ * @brief Path of the file of an entry, named after the FNV-1a hash of the section, the build and the key.
+ */
+string CodeCache::get_entry_path(CacheSection section, const string& key) const {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const string* part_ptr : {&CACHE_SECTION_NAMES[(int)section], &CACHE_VERSION, &key}) {
+        for (unsigned char ch : *part_ptr) {
+            hash = (hash ^ ch) * 1099511628211ULL;
+        }
+        hash = (hash ^ '\n') * 1099511628211ULL;
+    }
+    ostringstream name_stream;
+    name_stream << hex << setw(16) << setfill('0') << hash;
+    return (filesystem::path(this->dir_name) / (name_stream.str() + ".entry")).string();
+}
+
+string CodeCache::encode_entry(int label_base, const vector<AsmLine>& lines, const vector<int>& counts) const {
+    string value = to_string(counts.size());
+    for (int count : counts) {
+        value += ' ' + to_string(count);
+    }
+    value += '\n';
+    this->encode_lines(lines, label_base, value);
+    return value;
+}
+
+bool CodeCache::decode_entry(const string& value, int label_base, vector<AsmLine>& lines, vector<int>& counts) {
+    size_t pos = 0;
+    int count_size, line_count;
+    if (!CodeCache::decode_int(value, pos, count_size) || count_size < 0 || count_size > value.size()) {
+        return false;
+    }
+    counts.resize(count_size);
+    for (int& count : counts) {
+        if (!CodeCache::decode_int(value, pos, count)) {
+            return false;
+        }
+    }
+
+    if (!CodeCache::decode_int(value, pos, line_count) || line_count < 0 || line_count > value.size()) {
+        return false;
+    }
+    lines.reserve(line_count);
+    for (int i = 0; i < line_count; i++) {
+        AsmLine line = AsmLine::blank();
+        int kind, indentation, opcode;
+        string text;
+        if (!CodeCache::decode_int(value, pos, kind) || !CodeCache::decode_int(value, pos, indentation) ||
+            !CodeCache::decode_int(value, pos, opcode) ||
+            !this->decode_operand(value, pos, label_base, line.instruction.dst) ||
+            !this->decode_operand(value, pos, label_base, line.instruction.src) ||
+            !CodeCache::decode_string(value, pos, text)) {
+            return false;
+        }
+        line.kind = (LineKind)kind;
+        line.indentation = indentation;
+        line.instruction.opcode = (Opcode)opcode;
+        line.text_id = this->string_interner.intern(text);
+        lines.push_back(line);
+    }
+    return true;
+}
+
+void CodeCache::encode_operand(const Operand& operand, int label_base, string& out) const {
+    int value = operand.value;
+    if (operand.kind == OperandKind::Label && value >= 0) {
+        value -= label_base;
+    }
+    out += ' ' + to_string((int)operand.kind) + ' ' + to_string((int)operand.reg) + ' ' +
+        to_string((int)operand.format) + ' ' + to_string((int)operand.label) + ' ' + to_string(operand.is_indexed) +
+        ' ' + to_string(operand.displacement);
+    if (operand.kind == OperandKind::Symbol) {
+        CodeCache::encode_string(this->string_interner.get_string(value), out);
+    } else {
+        out += ' ' + to_string(value);
+    }
+}
+
+bool CodeCache::decode_operand(const string& value, size_t& pos, int label_base, Operand& operand) {
+    int kind, reg, format, label, is_indexed;
+    if (!CodeCache::decode_int(value, pos, kind) || !CodeCache::decode_int(value, pos, reg) ||
+        !CodeCache::decode_int(value, pos, format) || !CodeCache::decode_int(value, pos, label) ||
+        !CodeCache::decode_int(value, pos, is_indexed) || !CodeCache::decode_int(value, pos, operand.displacement)) {
+        return false;
+    }
+    operand.kind = (OperandKind)kind;
+    operand.reg = (Register)reg;
+    operand.format = (ImmediateFormat)format;
+    operand.label = (Label)label;
+    operand.is_indexed = is_indexed;
+
+    if (operand.kind == OperandKind::Symbol) {
+        string name;
+        if (!CodeCache::decode_string(value, pos, name)) {
+            return false;
+        }
+        operand.value = this->string_interner.intern(name);
+        return true;
+    }
+    if (!CodeCache::decode_int(value, pos, operand.value)) {
+        return false;
+    }
+    if (operand.kind == OperandKind::Label && operand.value >= 0) {
+        operand.value += label_base;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a string as its length and its characters, so it may hold any character.
+ */
+void CodeCache::encode_string(const string& str, string& out) {
+    out += ' ' + to_string(str.size()) + ':';
+    out += str;
+}
+
+bool CodeCache::decode_int(const string& value, size_t& pos, int& number) {
+    const char* start_ptr = value.c_str() + pos;
+    char* end_ptr;
+    long parsed = strtol(start_ptr, &end_ptr, 10);
+    if (end_ptr == start_ptr) {
+        return false;
+    }
+    number = parsed;
+    pos += end_ptr - start_ptr;
+    return true;
+}
+
+bool CodeCache::decode_string(const string& value, size_t& pos, string& str) {
+    int size;
+    if (!CodeCache::decode_int(value, pos, size) || size < 0 || pos >= value.size() || value[pos] != ':' ||
+        pos + 1 + size > value.size()) {
+        return false;
+    }
+    str = value.substr(pos + 1, size);
+    pos += 1 + size;
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../AsmBuffer/AsmBuffer.hpp"
+
+using namespace std;
+
+/**
+ * @brief Kinds of cache entries: the code of a function as generated, and the code of a procedure as
+ * rewritten by the peephole optimizer.
+ */
+enum class CacheSection : unsigned char {
+    Code, OptimizedCode
+};
+
+const int NUM_CACHE_SECTIONS = 2;
+
+/**
+ * @brief On-disk cache of code, that lets a compilation skip the functions that are unchanged since an
+ * earlier one. An entry maps a key, the complete input of the work it saves, to the lines it produced and a
+ * few counts. The file of an entry is named after the hash of its key, and holds the key, which must match
+ * for a hit. Entries written by another build of the compiler never match.
+ *
+ * Names in the lines are written as text, labels relative to a base, so an entry can be read into another
+ * compilation, with its own interner and label numbers. Entries are written into a temporary file that is
+ * renamed, so compilations can share the directory, also the ones of a batch.
+ *
+ * When verified, the caller redoes the work of a hit, and the entry is replaced if it does not match.
+ */
+class CodeCache {
+    string dir_name;
+    bool is_hit_verified;
+    // interner of the compilation the lines are read into and written from
+    StringInterner& string_interner;
+    atomic<int> hit_counts[NUM_CACHE_SECTIONS];
+    atomic<int> miss_counts[NUM_CACHE_SECTIONS];
+    atomic<int> mismatch_counts[NUM_CACHE_SECTIONS];
+
+public:
+    CodeCache(const string&, bool, StringInterner&);
+
+    bool is_verified() const;
+
+    bool load(CacheSection, const string&, int, vector<AsmLine>&, vector<int>&);
+
+    void store(CacheSection, const string&, int, const vector<AsmLine>&, const vector<int>&);
+
+    void verify(CacheSection, const string&, int, const vector<AsmLine>&, const vector<int>&);
+
+    void write_stats(ostream&) const;
+
+    void encode_lines(const vector<AsmLine>&, int, string&) const;
+
+    static int get_label_base(const vector<AsmLine>&);
+
+private:
+    bool read_entry(CacheSection, const string&, string&);
+
+    string get_entry_path(CacheSection, const string&) const;
+
+    string encode_entry(int, const vector<AsmLine>&, const vector<int>&) const;
+
+    bool decode_entry(const string&, int, vector<AsmLine>&, vector<int>&);
+
+    void encode_operand(const Operand&, int, string&) const;
+
+    bool decode_operand(const string&, size_t&, int, Operand&);
+
+    static void encode_string(const string&, string&);
+
+    static bool decode_int(const string&, size_t&, int&);
+
+    static bool decode_string(const string&, size_t&, string&);
+};
@@ -0,0 +1,1767 @@
+#include <algorithm>
+#include "CodeGenerator.hpp"
+
+using namespace std;
+
+const Operand AX = Operand::reg_of(Register::AX), BX = Operand::reg_of(Register::BX),
+    CX = Operand::reg_of(Register::CX), DX = Operand::reg_of(Register::DX), SI = Operand::reg_of(Register::SI),
+    DI = Operand::reg_of(Register::DI), BP = Operand::reg_of(Register::BP), SP = Operand::reg_of(Register::SP),
+    DS = Operand::reg_of(Register::DS), ES = Operand::reg_of(Register::ES), SS = Operand::reg_of(Register::SS),
+    AL = Operand::reg_of(Register::AL), AH = Operand::reg_of(Register::AH), BL = Operand::reg_of(Register::BL),
+    DL = Operand::reg_of(Register::DL);
+
+/**
+    @param asm_buffer Buffer the data and code sections are written into
+    @param string_interner Interner of the names of the AST and of the code
+    @param is_fast_call Whether functions are called with the fast calling convention
+    @param is_output_buffered Whether printed lines are collected and written together
+    @param job_count Number of threads the functions are generated on
+    @param code_cache_ptr Cache of the code of functions, nullptr if none
+**/
+CodeGenerator::CodeGenerator(AsmBuffer& asm_buffer, StringInterner& string_interner, bool is_fast_call,
+    bool is_output_buffered, int job_count, CodeCache* code_cache_ptr)
+    : asm_buffer(asm_buffer), string_interner(string_interner), is_fast_call(is_fast_call),
+    is_output_buffered(is_output_buffered), job_count(job_count), code_cache_ptr(code_cache_ptr),
+    program_generator_ptr(this), constant_evaluator(string_interner), label_count{ 0 }, label_depth{ 0 },
+    is_print_proc_called{ false }, reduced_index_offset{ 0 }, frame_slot_count{ 0 }, current_func_id{ 0 },
+    register_param_count{ 0 }, stack_param_count{ 0 }, has_frame_pointer{ true }, is_frame_pointer_saved{ false },
+    entry_label_id{ -1 } {
+}
+
+/**
+    Generates the code of one function of a program, into its own buffer.
+
+    @param asm_buffer Buffer the code of the function is written into
+    @param program_generator Generator of the program
+**/
+CodeGenerator::CodeGenerator(AsmBuffer& asm_buffer, const CodeGenerator& program_generator)
+    : CodeGenerator(asm_buffer, program_generator.string_interner, program_generator.is_fast_call,
+        program_generator.is_output_buffered) {
+    this->program_generator_ptr = &program_generator;
+    this->is_print_proc_called = program_generator.is_print_proc_called;
+}
+
+/**
+    Writes the entry procedure, the code of all function definitions of the program, followed by the print
+    procedure if the program prints. Global variables are written into the data section.
+
+    @param program_ptr Root of the AST
+**/
+void CodeGenerator::generate(ASTNode* program_ptr) {
+    this->is_print_proc_called = this->_has_println(program_ptr);
+    this->gen_entry_proc();
+
+    // globals are written in source order, the callers of a function must know how it takes its params,
+    // wherever it is defined
+    vector<ASTNode*> func_defs;
+    for (ASTNode* unit_ptr : program_ptr->get_children()) {
+        if (unit_ptr->get_kind() == NodeKind::VarDeclaration) {
+            this->gen_var_declaration(unit_ptr);
+        } else if (unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            func_defs.push_back(unit_ptr);
+        }
+        if (this->is_fast_call && unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            this->register_param_counts[unit_ptr->get_name_id()] = this->count_register_params(unit_ptr);
+        }
+    }
+
+    vector<AsmBuffer> func_buffers(func_defs.size());
+    vector<int> func_label_counts(func_defs.size());
+    WorkerPool(this->job_count).run(func_defs.size(), [&](int i) {
+        func_label_counts[i] = this->gen_func_code(func_defs[i], func_buffers[i]);
+    });
+    for (int i = 0; i < func_defs.size(); i++) {
+        this->asm_buffer.append_code(func_buffers[i].get_code_section(), this->label_count);
+        this->label_count += func_label_counts[i];
+    }
+
+    if (this->is_print_proc_called) {
+        this->append_print_proc_def();
+    }
+    if (this->is_print_proc_called && this->is_output_buffered) {
+        this->write_code(AsmLine::blank());
+        this->append_flush_proc_def();
+    }
+}
+
+/**
+    Writes the MAIN procedure, that sets up the data segment and calls the source main function. The lines
+    left in the output buffer are written before the program ends.
+**/
+void CodeGenerator::gen_entry_proc() {
+    int main_proc_id = this->string_interner.intern("MAIN");
+    this->write_code(AsmLine::proc_begin(main_proc_id));
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::MOV, AX, Operand::symbol(this->string_interner.intern("@DATA"))),
+        AsmLine::op(Opcode::MOV, DS, AX),
+        AsmLine::op(Opcode::MOV, BP, SP),
+        AsmLine::op(Opcode::CALL, Operand::symbol(this->string_interner.intern(SOURCE_MAIN_FUNC_NAME)))
+    };
+    if (this->is_print_proc_called && this->is_output_buffered) {
+        code.push_back(AsmLine::op(Opcode::CALL, Operand::symbol(this->string_interner.intern("FLUSH_OUTPUT"))));
+    }
+    code.insert(code.end(), {
+        AsmLine::op(Opcode::MOV, AH, Operand::imm(0x4C, ImmediateFormat::Hex)),
+        AsmLine::op(Opcode::INT, Operand::imm(0x21, ImmediateFormat::Hex)) // end prog
+    });
+    this->write_code(code, 1);
+    this->write_code(AsmLine::proc_end(main_proc_id));
+}
+
+/**
+    Writes the code of a function into a buffer of its own, with labels numbered from 0. With a code cache, the
+    code is read from it if it holds the function, and is written into it otherwise.
+
+    @param func_def_ptr FuncDefinition node
+    @param func_buffer Buffer of the function
+    @return Number of labels of the function
+**/
+int CodeGenerator::gen_func_code(ASTNode* func_def_ptr, AsmBuffer& func_buffer) {
+    string cache_key;
+    vector<AsmLine> cached_code;
+    vector<int> cached_counts;
+    bool is_cached = false;
+    if (this->code_cache_ptr != nullptr) {
+        cache_key = this->get_cache_key(func_def_ptr);
+        is_cached = this->code_cache_ptr->load(CacheSection::Code, cache_key, 0, cached_code, cached_counts) &&
+            cached_counts.size() == 1;
+    }
+    if (is_cached && !this->code_cache_ptr->is_verified()) {
+        func_buffer.append_code(cached_code, 0);
+        return cached_counts[0];
+    }
+
+    CodeGenerator func_generator(func_buffer, *this);
+    func_generator.gen_func_definition(func_def_ptr);
+    func_generator.write_code(AsmLine::blank());
+    if (is_cached) {
+        this->code_cache_ptr->verify(CacheSection::Code, cache_key, 0, func_buffer.get_code_section(),
+            {func_generator.label_count});
+    } else if (this->code_cache_ptr != nullptr) {
+        this->code_cache_ptr->store(CacheSection::Code, cache_key, 0, func_buffer.get_code_section(),
+            {func_generator.label_count});
+    }
+    return func_generator.label_count;
+}
+
+/**
+    Key of the code of a function in the code cache: the options, and the subtree of the function, with the
+    params that it and the functions it calls take in registers.
+
+    @param func_def_ptr FuncDefinition node
+**/
+string CodeGenerator::get_cache_key(ASTNode* func_def_ptr) {
+    string cache_key = to_string(this->is_fast_call) + ' ' + to_string(this->is_output_buffered) + ' ' +
+        to_string(this->is_print_proc_called) + '\n';
+    this->write_cache_key(func_def_ptr, cache_key);
+    return cache_key;
+}
+
+/**
+    Appends a node and its children, with everything the code generator reads from them, one line each.
+**/
+void CodeGenerator::write_cache_key(ASTNode* node_ptr, string& cache_key) {
+    CodeGenInfo* cgi_ptr = node_ptr->get_codegen_info_ptr();
+    const string& name = this->get_name(node_ptr);
+    cache_key += to_string((int)node_ptr->get_kind()) + ' ' + to_string(name.size()) + ':' + name + ' ' +
+        to_string((int)node_ptr->get_semantic_type()) + ' ' + to_string(node_ptr->get_count()) + ' ' +
+        to_string(cgi_ptr->is_local()) + ' ' + to_string(cgi_ptr->get_stack_offset()) + ' ' +
+        to_string(node_ptr->get_num_children());
+    NodeKind kind = node_ptr->get_kind();
+    if (this->is_fast_call && (kind == NodeKind::FuncDefinition || kind == NodeKind::Call)) {
+        cache_key += ' ' + to_string(this->get_register_param_count(node_ptr->get_name_id()));
+    }
+    cache_key += '\n';
+
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->write_cache_key(child_ptr, cache_key);
+    }
+}
+
+void CodeGenerator::gen_var_declaration(ASTNode* var_decl_ptr) {
+    for (ASTNode* declarator_ptr : var_decl_ptr->get_children()) {
+        SemanticType var_type = declarator_ptr->get_semantic_type();
+        if (var_type == SemanticType::IntArray || var_type == SemanticType::FloatArray) {
+            this->_alloc_int_array(declarator_ptr);
+        } else {
+            this->_alloc_int_var(declarator_ptr);
+        }
+    }
+}
+
+/**
+    Writes the procedure of a function. With the fast calling convention, the function keeps the BP of its
+    caller, unless it needs no BP at all, and a call of itself whose value it returns jumps back to its entry.
+
+    @param func_def_ptr FuncDefinition node
+**/
+void CodeGenerator::gen_func_definition(ASTNode* func_def_ptr) {
+    string func_name = this->get_name(func_def_ptr);
+    func_name = func_name == "main" ? SOURCE_MAIN_FUNC_NAME : func_name;
+    this->write_code(AsmLine::proc_begin(this->string_interner.intern(func_name)), this->label_depth++);
+
+    ASTNode* body_ptr = func_def_ptr->get_child(func_def_ptr->get_num_children() - 1);
+    int param_count = func_def_ptr->get_num_children() - 1;
+    this->current_func_id = func_def_ptr->get_name_id();
+    this->register_param_count = this->is_fast_call ?
+        this->program_generator_ptr->get_register_param_count(this->current_func_id) : 0;
+    this->stack_param_count = param_count - this->register_param_count;
+
+    this->register_allocator.reset();
+    this->bind_hot_variables(func_def_ptr);
+    this->constant_evaluator.forget_all();
+    this->place_params(func_def_ptr);
+
+    // the entry procedure ends the program after main, that need not keep its BP
+    this->is_frame_pointer_saved = this->is_fast_call && this->has_frame_pointer && func_name != SOURCE_MAIN_FUNC_NAME;
+    if (this->has_frame_pointer) {
+        if (this->is_frame_pointer_saved) {
+            this->write_code(AsmLine::op(Opcode::PUSH, BP), this->label_depth);
+        }
+        // set new BP, with params above, locals below - return IP pointed at
+        this->write_code(AsmLine::op(Opcode::MOV, BP, SP), this->label_depth);
+    }
+    this->entry_label_id = -1;
+    if (this->is_fast_call && this->_has_self_tail_call(body_ptr)) {
+        Operand entry_label = this->get_label(FUNC_ENTRY);
+        this->entry_label_id = entry_label.value;
+        this->write_code(AsmLine::label(entry_label), this->label_depth);
+    }
+    this->gen_frame_setup(func_def_ptr);
+
+    // params bound to registers are loaded once, locals when they are declared
+    for (int stack_offset = 1; stack_offset <= param_count; stack_offset++) {
+        Register reg;
+        bool is_bound = this->register_allocator.find_variable(stack_offset, reg);
+        if (stack_offset <= this->register_param_count) {
+            Operand arg_reg = Operand::reg_of(ARG_REGISTERS[this->register_param_count - stack_offset]);
+            if (is_bound) {
+                this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(reg), arg_reg), this->label_depth);
+            } else if (this->param_displacements.count(stack_offset) > 0) {
+                this->write_code(AsmLine::op(Opcode::MOV, this->_get_slot(stack_offset), arg_reg), this->label_depth);
+            }
+        } else if (is_bound) {
+            this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(reg), this->_get_slot(stack_offset)),
+                this->label_depth);
+        }
+    }
+
+    for (ASTNode* statement_ptr : body_ptr->get_children()) {
+        this->gen_statement(statement_ptr);
+    }
+
+    if (func_def_ptr->get_semantic_type() == SemanticType::Void) {
+        vector<AsmLine> code = this->_get_activation_record_teardown_code();
+        this->write_code(code, this->label_depth);
+    }
+
+    this->write_code(AsmLine::proc_end(), --this->label_depth);
+}
+
+/**
+    Decides where the params of a function are read from, and whether the function needs BP. Params passed on
+    the stack are above the return IP, and the BP of the caller with the fast calling convention. A param
+    passed in a register that is not bound to a register is kept in a slot below the locals, if it is used.
+    Only the fast calling convention can leave out BP, when neither params nor locals are on the stack.
+
+    @param func_def_ptr FuncDefinition node
+**/
+void CodeGenerator::place_params(ASTNode* func_def_ptr) {
+    ASTNode* body_ptr = func_def_ptr->get_child(func_def_ptr->get_num_children() - 1);
+    int param_count = func_def_ptr->get_num_children() - 1;
+    this->frame_slot_count = func_def_ptr->get_count();
+    this->param_displacements.clear();
+
+    for (int stack_offset = 1; stack_offset <= param_count; stack_offset++) {
+        Register reg;
+        if (!this->is_fast_call) {
+            this->param_displacements[stack_offset] = DW_SZ * stack_offset;
+        } else if (stack_offset > this->register_param_count) {
+            this->param_displacements[stack_offset] = DW_SZ * (stack_offset - this->register_param_count + 1);
+        } else if (!this->register_allocator.find_variable(stack_offset, reg) &&
+            this->_is_local_used(body_ptr, stack_offset)) {
+            this->param_displacements[stack_offset] = -DW_SZ * ++this->frame_slot_count;
+        }
+    }
+    this->has_frame_pointer = !this->is_fast_call || this->frame_slot_count > 0 || this->stack_param_count > 0;
+}
+
+/**
+    Reserves the stack slots of all the locals of a function with a single adjustment of SP, so each local has
+    its slot from the entry wherever it is declared. Arrays and the scalars that can be read before they are
+    assigned start as 0, their slots are zeroed here, with REP STOSW when there are many of them.
+
+    @param func_def_ptr FuncDefinition node
+**/
+void CodeGenerator::gen_frame_setup(ASTNode* func_def_ptr) {
+    this->zeroed_offsets.clear();
+    if (this->frame_slot_count == 0) {
+        return;
+    }
+    this->write_code(AsmLine::op(Opcode::SUB, SP, Operand::imm(DW_SZ * this->frame_slot_count)), this->label_depth);
+
+    // a scalar bound to a register is zeroed in the register when it is declared
+    this->find_zeroed_locals(func_def_ptr->get_child(func_def_ptr->get_num_children() - 1));
+    vector<int> zeroed_slots;
+    for (int stack_offset : this->zeroed_offsets) {
+        Register reg;
+        if (!this->register_allocator.find_variable(stack_offset, reg)) {
+            zeroed_slots.push_back(stack_offset);
+        }
+    }
+    if (zeroed_slots.empty()) {
+        return;
+    }
+
+    vector<AsmLine> code;
+    if (zeroed_slots.size() < MIN_BLOCK_FILL_WORDS) {
+        code.push_back(AsmLine::op(Opcode::MOV, AX, Operand::imm(0)));
+        for (int stack_offset : zeroed_slots) {
+            code.push_back(AsmLine::op(Opcode::MOV, Operand::local(DW_SZ * stack_offset), AX));
+        }
+    } else {
+        // the slots in between are assigned before they are read, zeroing them too does no harm
+        int word_count = zeroed_slots.back() - zeroed_slots.front() + 1;
+        code = {
+            this->comment("ZEROING " + to_string(word_count) + " WORDS OF THE FRAME"),
+            AsmLine::op(Opcode::PUSH, SS), // STOSW stores into the extra segment
+            AsmLine::op(Opcode::POP, ES),
+            AsmLine::op(Opcode::CLD),
+            AsmLine::op(Opcode::MOV, AX, Operand::imm(0)),
+            AsmLine::op(Opcode::MOV, CX, Operand::imm(word_count)),
+            AsmLine::op(Opcode::LEA, DI, Operand::local(DW_SZ * zeroed_slots.front())),
+            AsmLine::op(Opcode::REP_STOSW)
+        };
+    }
+    this->write_code(code, this->label_depth);
+}
+
+/**
+    Collects the stack offsets of the locals that have to start as 0 into zeroed_offsets: the slots of the
+    arrays, and the scalars that a statement of their block can read before one assigns them.
+
+    @param node_ptr Node of the function body
+**/
+void CodeGenerator::find_zeroed_locals(ASTNode* node_ptr) {
+    for (int i = 0; i < node_ptr->get_num_children(); i++) {
+        ASTNode* child_ptr = node_ptr->get_child(i);
+        if (child_ptr->get_kind() != NodeKind::VarDeclaration) {
+            this->find_zeroed_locals(child_ptr);
+            continue;
+        }
+
+        for (ASTNode* declarator_ptr : child_ptr->get_children()) {
+            int stack_offset = declarator_ptr->get_codegen_info_ptr()->get_stack_offset();
+            SemanticType var_type = declarator_ptr->get_semantic_type();
+            if (var_type == SemanticType::IntArray || var_type == SemanticType::FloatArray) {
+                // elements are below the first one
+                for (int idx = 0; idx < declarator_ptr->get_count(); idx++) {
+                    this->zeroed_offsets.insert(stack_offset - idx);
+                }
+            } else if (node_ptr->get_kind() != NodeKind::CompoundStatement ||
+                this->_is_read_before_assigned(node_ptr, i + 1, stack_offset)) {
+                this->zeroed_offsets.insert(stack_offset);
+            }
+        }
+    }
+}
+
+void CodeGenerator::gen_statement(ASTNode* statement_ptr) {
+    switch (statement_ptr->get_kind()) {
+        case NodeKind::VarDeclaration:
+            this->gen_var_declaration(statement_ptr);
+            break;
+        case NodeKind::CompoundStatement:
+            for (ASTNode* child_ptr : statement_ptr->get_children()) {
+                this->gen_statement(child_ptr);
+            }
+            break;
+        case NodeKind::ExpressionStatement:
+            if (statement_ptr->get_num_children() > 0) {
+                this->gen_effect(statement_ptr->get_child(0));
+            }
+            break;
+        case NodeKind::ForStatement:
+            this->gen_for_statement(statement_ptr);
+            break;
+        case NodeKind::IfStatement:
+            this->gen_if_statement(statement_ptr);
+            break;
+        case NodeKind::WhileStatement:
+            this->gen_while_statement(statement_ptr);
+            break;
+        case NodeKind::PrintlnStatement:
+            this->gen_println_statement(statement_ptr);
+            break;
+        case NodeKind::ReturnStatement: {
+            ASTNode* value_ptr = statement_ptr->get_child(0);
+            if (this->entry_label_id >= 0 && value_ptr->get_kind() == NodeKind::Call &&
+                value_ptr->get_name_id() == this->current_func_id) {
+                this->gen_tail_call(value_ptr);
+                break;
+            }
+            Register value_reg = this->gen_expression(statement_ptr->get_child(0));
+            this->register_allocator.release(value_reg);
+            if (value_reg != Register::AX) {
+                this->write_code(AsmLine::op(Opcode::MOV, AX, Operand::reg_of(value_reg)), this->label_depth);
+            }
+            vector<AsmLine> code = this->_get_activation_record_teardown_code();
+            this->write_code(code, this->label_depth);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+    The condition of a loop is checked at its bottom, the loop is entered by jumping to the check. Each
+    iteration then takes a single conditional jump back to the body.
+**/
+void CodeGenerator::gen_for_statement(ASTNode* for_ptr) {
+    this->gen_statement(for_ptr->get_child(0));
+    for (int i = 1; i < for_ptr->get_num_children(); i++) {
+        this->constant_evaluator.forget_assigned(for_ptr->get_child(i));
+    }
+
+    // a missing condition is always true
+    ASTNode* condition_ptr = for_ptr->get_child(1);
+    bool has_condition = condition_ptr->get_num_children() > 0;
+
+    this->write_code(this->comment("FOR LOOP START"), this->label_depth);
+    LoopContext loop_context = this->gen_loop_entry(for_ptr);
+    // label id is shared by the labels of this loop
+    Operand body_label = this->get_label(FOR_LOOP_BODY);
+    const int CURR_LABEL_ID = this->label_count - 1;
+    if (has_condition) {
+        this->write_code(AsmLine::op(Opcode::JMP, this->get_label(FOR_LOOP_CONDITION, CURR_LABEL_ID)),
+            this->label_depth);
+    }
+    this->write_code(AsmLine::label(body_label), this->label_depth++);
+
+    // values known at the loop head hold at the condition check too, values learnt in the body do not
+    map<int, int> known_values = this->constant_evaluator.get_known_values();
+    this->gen_statement(for_ptr->get_child(3));
+    this->label_depth--;
+    this->gen_effect(for_ptr->get_child(2));
+    this->constant_evaluator.set_known_values(known_values);
+
+    if (has_condition) {
+        vector<AsmLine> code{
+            this->comment("FOR LOOP CONDITION CHECK"),
+            AsmLine::label(this->get_label(FOR_LOOP_CONDITION, CURR_LABEL_ID))
+        };
+        this->write_code(code, this->label_depth);
+        this->gen_condition_jump(condition_ptr->get_child(0), true, body_label);
+    } else {
+        this->write_code(AsmLine::op(Opcode::JMP, body_label), this->label_depth);
+    }
+    this->end_loop(loop_context);
+}
+
+void CodeGenerator::gen_if_statement(ASTNode* if_ptr) {
+    this->write_code(this->comment("IF STATEMENT START"), this->label_depth);
+    bool has_else = if_ptr->get_num_children() == 3;
+    // label id is shared by the labels of this if-else
+    Operand else_label = this->get_label(has_else ? ELSE_BODY : IF_ELSE_END);
+    const int CURR_LABEL_ID = this->label_count - 1;
+    this->gen_condition_jump(if_ptr->get_child(0), false, else_label);
+
+    // values known after the if-else are the ones known after both bodies
+    map<int, int> known_values = this->constant_evaluator.get_known_values();
+    this->label_depth++;
+    this->gen_statement(if_ptr->get_child(1));
+
+    if (!has_else) {
+        this->constant_evaluator.meet(known_values);
+        this->write_code(AsmLine::label(else_label), --this->label_depth);
+    } else {
+        vector<AsmLine> code{
+            // if body execution ends in jumping over else body
+            AsmLine::op(Opcode::JMP, this->get_label(IF_ELSE_END, CURR_LABEL_ID)),
+            AsmLine::label(else_label)
+        };
+        this->write_code(code, this->label_depth - 1);
+
+        map<int, int> if_known_values = this->constant_evaluator.get_known_values();
+        this->constant_evaluator.set_known_values(known_values);
+        this->gen_statement(if_ptr->get_child(2));
+        this->constant_evaluator.meet(if_known_values);
+        this->write_code(AsmLine::label(this->get_label(IF_ELSE_END, CURR_LABEL_ID)), --this->label_depth);
+    }
+}
+
+void CodeGenerator::gen_while_statement(ASTNode* while_ptr) {
+    this->constant_evaluator.forget_assigned(while_ptr);
+    this->write_code(this->comment("WHILE LOOP START"), this->label_depth);
+    LoopContext loop_context = this->gen_loop_entry(while_ptr);
+    // label id is shared by the labels of this loop
+    Operand body_label = this->get_label(WHILE_LOOP_BODY);
+    const int CURR_LABEL_ID = this->label_count - 1;
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::JMP, this->get_label(WHILE_LOOP_CONDITION, CURR_LABEL_ID)),
+        AsmLine::label(body_label)
+    };
+    this->write_code(code, this->label_depth++);
+
+    map<int, int> known_values = this->constant_evaluator.get_known_values();
+    this->gen_statement(while_ptr->get_child(1));
+    this->constant_evaluator.set_known_values(known_values);
+
+    code = {
+        this->comment("WHILE LOOP CONDITION CHECK"),
+        AsmLine::label(this->get_label(WHILE_LOOP_CONDITION, CURR_LABEL_ID))
+    };
+    this->write_code(code, --this->label_depth);
+    this->gen_condition_jump(while_ptr->get_child(0), true, body_label);
+    this->end_loop(loop_context);
+}
+
+/**
+    Sets up the optimizations of a loop at its entry. Twice the index variable is put in SI, unless an
+    enclosing loop keeps its own index variable there. The hoisted invariant is evaluated into a register that
+    is bound to it for the whole loop, if the registers left are enough for the expressions of the loop, and
+    at least two.
+
+    @param loop_ptr ForStatement or WhileStatement node
+    @return LoopContext Optimizations to be undone by end_loop at the exit
+**/
+LoopContext CodeGenerator::gen_loop_entry(ASTNode* loop_ptr) {
+    LoopContext loop_context{false, Register::AX, {}};
+    LoopAnalyzer loop_analyzer(loop_ptr, this->constant_evaluator);
+
+    int index_offset;
+    if (this->reduced_index_offset == 0 && loop_analyzer.get_index_variable(index_offset)) {
+        Register reg;
+        Operand index_var = this->register_allocator.find_variable(index_offset, reg) ? Operand::reg_of(reg) :
+            this->_get_slot(index_offset);
+        vector<AsmLine> code{
+            this->comment("INDEX VARIABLE AT STACK OFFSET " + to_string(index_offset) + " DOUBLED IN SI"),
+            AsmLine::op(Opcode::MOV, SI, index_var),
+            AsmLine::op(Opcode::ADD, SI, SI)
+        };
+        this->write_code(code, this->label_depth);
+        this->reduced_index_offset = index_offset;
+        loop_context.is_index_reduced = true;
+    }
+
+    const vector<ASTNode*>& hoisted_exprs = loop_analyzer.get_hoisted_expressions();
+    if (!hoisted_exprs.empty() &&
+        this->register_allocator.get_free_count() - 1 >= max(2, loop_analyzer.get_register_need()) &&
+        this->register_allocator.can_bind_invariant()) {
+        this->write_code(this->comment("LOOP INVARIANT HOISTED"), this->label_depth);
+        Register value_reg = this->gen_expression(hoisted_exprs[0]);
+        Register invariant_reg = value_reg;
+        if (find(begin(INVARIANT_REGISTERS), end(INVARIANT_REGISTERS), value_reg) == end(INVARIANT_REGISTERS)) {
+            this->register_allocator.try_allocate(invariant_reg, {Register::AX, Register::DX});
+            this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(invariant_reg), Operand::reg_of(value_reg)),
+                this->label_depth);
+            this->register_allocator.release(value_reg);
+        }
+        this->register_allocator.bind_invariant(invariant_reg);
+
+        loop_context.hoisted_reg = invariant_reg;
+        loop_context.hoisted_exprs = hoisted_exprs;
+        for (ASTNode* expr_ptr : hoisted_exprs) {
+            this->hoisted_values[expr_ptr] = invariant_reg;
+        }
+    }
+    return loop_context;
+}
+
+void CodeGenerator::end_loop(const LoopContext& loop_context) {
+    if (loop_context.is_index_reduced) {
+        this->reduced_index_offset = 0;
+    }
+    if (!loop_context.hoisted_exprs.empty()) {
+        this->register_allocator.unbind_invariant(loop_context.hoisted_reg);
+        for (ASTNode* expr_ptr : loop_context.hoisted_exprs) {
+            this->hoisted_values.erase(expr_ptr);
+        }
+    }
+}
+
+/**
+    Writes the code of a condition in branch position, that jumps to the target if the condition has the
+    given truth value and falls through otherwise. A comparison jumps on the flags of its CMP, && and || jump
+    as soon as an operand decides them. No value is materialized, except for the operands of comparisons and
+    for conditions that are neither, which are compared with 0.
+
+    @param cond_ptr Expression node of the condition
+    @param jump_if Truth value on which to jump
+    @param target Label to jump to
+**/
+void CodeGenerator::gen_condition_jump(ASTNode* cond_ptr, bool jump_if, const Operand& target) {
+    int value;
+    if (this->constant_evaluator.evaluate(cond_ptr, value)) {
+        if ((value != 0) == jump_if) {
+            this->write_code(AsmLine::op(Opcode::JMP, target), this->label_depth);
+        }
+        return;
+    }
+
+    switch (cond_ptr->get_kind()) {
+        case NodeKind::RelExpression: {
+            Register left_reg;
+            Opcode jump_opcode = this->gen_comparison(cond_ptr, left_reg, false);
+            this->register_allocator.release(left_reg);
+            jump_opcode = jump_if ? jump_opcode : get_inverse_cond_jump(jump_opcode);
+            this->write_code(AsmLine::op(jump_opcode, target), this->label_depth);
+            break;
+        }
+        case NodeKind::LogicExpression:
+            if (jump_if != (this->get_name(cond_ptr) == "&&")) {
+                // false && or true ||, either operand decides
+                this->gen_condition_jump(cond_ptr->get_child(0), jump_if, target);
+                this->gen_condition_jump(cond_ptr->get_child(1), jump_if, target);
+            } else {
+                // left operand can only decide against the jump, skipping the right operand
+                Operand skip_label = this->get_label(SHORT_CIRC);
+                this->gen_condition_jump(cond_ptr->get_child(0), !jump_if, skip_label);
+                this->gen_condition_jump(cond_ptr->get_child(1), jump_if, target);
+                this->write_code(AsmLine::label(skip_label), this->label_depth);
+            }
+            break;
+        case NodeKind::NotExpression:
+            this->gen_condition_jump(cond_ptr->get_child(0), !jump_if, target);
+            break;
+        default: {
+            Register value_reg = this->gen_expression(cond_ptr);
+            this->register_allocator.release(value_reg);
+            vector<AsmLine> code{
+                AsmLine::op(Opcode::CMP, Operand::reg_of(value_reg), Operand::imm(0)),
+                AsmLine::op(jump_if ? Opcode::JNE : Opcode::JE, target)
+            };
+            this->write_code(code, this->label_depth);
+            break;
+        }
+    }
+}
+
+void CodeGenerator::gen_println_statement(ASTNode* println_ptr) {
+    ASTNode* var_ptr = println_ptr->get_child(0);
+    Register value_reg = this->gen_expression(var_ptr);
+    this->write_code(this->comment("PRINT STATEMENT VAR " + this->get_name(var_ptr)), this->label_depth);
+
+    // the print procedure overwrites AX, BX, CX and DX
+    vector<RegisterState> saved;
+    for (Register reg : this->register_allocator.get_used_registers()) {
+        if (reg != value_reg && reg != Register::DI) {
+            this->save_register(reg, saved);
+        }
+    }
+    if (value_reg != Register::AX) {
+        this->write_code(AsmLine::op(Opcode::MOV, AX, Operand::reg_of(value_reg)), this->label_depth);
+    }
+    this->write_code(AsmLine::op(Opcode::CALL, Operand::symbol(this->string_interner.intern("PRINT_INT_IN_AX"))),
+        this->label_depth);
+    this->register_allocator.release(value_reg);
+    this->restore_registers(saved);
+}
+
+/**
+    Writes the code of an expression whose value is not used, e.g. the expression of a statement. A post
+    increment or decrement then skips the copy of the old value.
+
+    @param expr_ptr Expression node
+**/
+void CodeGenerator::gen_effect(ASTNode* expr_ptr) {
+    NodeKind kind = expr_ptr->get_kind();
+    if (kind == NodeKind::PostIncrement || kind == NodeKind::PostDecrement) {
+        this->register_allocator.release(this->gen_post_step(expr_ptr, false));
+    } else {
+        this->register_allocator.release(this->gen_expression(expr_ptr));
+    }
+}
+
+/**
+    Writes the code that evaluates an expression into a register. The register is allocated to the caller,
+    who releases it once the value is consumed.
+
+    @param expr_ptr Expression node
+    @return Register Register holding the value
+**/
+Register CodeGenerator::gen_expression(ASTNode* expr_ptr) {
+    int value;
+    if (this->constant_evaluator.evaluate(expr_ptr, value)) {
+        Register value_reg = this->register_allocator.allocate();
+        this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), Operand::imm(value)), this->label_depth);
+        return value_reg;
+    }
+    auto hoisted_iter = this->hoisted_values.find(expr_ptr);
+    if (hoisted_iter != this->hoisted_values.end()) {
+        Register value_reg = this->register_allocator.allocate();
+        this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), Operand::reg_of(hoisted_iter->second)),
+            this->label_depth);
+        return value_reg;
+    }
+
+    switch (expr_ptr->get_kind()) {
+        case NodeKind::Assignment:
+            return this->gen_assignment(expr_ptr);
+        case NodeKind::LogicExpression:
+            return this->gen_logic_expression(expr_ptr);
+        case NodeKind::RelExpression:
+            return this->gen_rel_expression(expr_ptr);
+        case NodeKind::AddExpression:
+            return this->gen_add_expression(expr_ptr);
+        case NodeKind::MulExpression:
+            return this->gen_mul_expression(expr_ptr);
+        case NodeKind::UnaryExpression: {
+            Register value_reg = this->gen_expression(expr_ptr->get_child(0));
+            if (this->get_name(expr_ptr) == "-") {
+                this->write_code(AsmLine::op(Opcode::NEG, Operand::reg_of(value_reg)), this->label_depth);
+            }
+            return value_reg;
+        }
+        case NodeKind::NotExpression:
+            return this->gen_not_expression(expr_ptr);
+        case NodeKind::Variable:
+            return this->gen_variable(expr_ptr);
+        case NodeKind::Call:
+            return this->gen_call(expr_ptr);
+        case NodeKind::PostIncrement:
+        case NodeKind::PostDecrement:
+            return this->gen_post_step(expr_ptr);
+        default:
+            return this->register_allocator.allocate();
+    }
+}
+
+Register CodeGenerator::gen_assignment(ASTNode* assign_ptr) {
+    ASTNode* var_ptr = assign_ptr->get_child(0);
+    if (!this->_is_index_evaluated(var_ptr)) {
+        Register value_reg = this->gen_expression(assign_ptr->get_child(1));
+        this->write_code(AsmLine::op(Opcode::MOV, this->_get_var_ref(var_ptr), Operand::reg_of(value_reg)),
+            this->label_depth);
+        if (this->_is_reduced_index_variable(var_ptr)) {
+            this->gen_word_offset(value_reg);
+        }
+        this->constant_evaluator.learn(var_ptr, assign_ptr->get_child(1));
+        return value_reg;
+    }
+
+    // index is evaluated first, SI is only set once the value is ready, as the value can index other arrays
+    Register index_reg = this->gen_expression(var_ptr->get_child(0));
+    Register value_reg = this->gen_right_operand(assign_ptr->get_child(1), index_reg, true).reg;
+    this->gen_word_offset(index_reg);
+    this->register_allocator.release(index_reg);
+    this->write_code(AsmLine::op(Opcode::MOV, this->_get_var_ref(var_ptr), Operand::reg_of(value_reg)),
+        this->label_depth);
+    return value_reg;
+}
+
+/**
+    The value of && and || is 0 or 1, the right operand is only evaluated if the left one does not decide it.
+**/
+Register CodeGenerator::gen_logic_expression(ASTNode* logic_ptr) {
+    Operand false_label = this->get_label(SHORT_CIRC);
+    const int CURR_LABEL_ID = this->label_count - 1;
+    this->gen_condition_jump(logic_ptr, false, false_label);
+
+    Register result_reg = this->register_allocator.allocate();
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::MOV, Operand::reg_of(result_reg), Operand::imm(1)),
+        AsmLine::op(Opcode::JMP, this->get_label(SHORT_CIRC_END, CURR_LABEL_ID)),
+        AsmLine::label(false_label),
+        AsmLine::op(Opcode::MOV, Operand::reg_of(result_reg), Operand::imm(0)),
+        AsmLine::label(this->get_label(SHORT_CIRC_END, CURR_LABEL_ID))
+    };
+    this->write_code(code, this->label_depth);
+    return result_reg;
+}
+
+Register CodeGenerator::gen_rel_expression(ASTNode* rel_ptr) {
+    this->write_code(this->comment("COMPARISON START"), this->label_depth);
+    Register left_reg;
+    Opcode jump_opcode = this->gen_comparison(rel_ptr, left_reg, true);
+
+    // MOV leaves the flags of CMP
+    vector<AsmLine> code{AsmLine::op(Opcode::MOV, Operand::reg_of(left_reg), Operand::imm(0))};
+    if (has_low_byte(left_reg)) {
+        code.push_back(AsmLine::op(get_set_of_cond_jump(jump_opcode), Operand::reg_of(get_low_byte(left_reg))));
+    } else {
+        Operand false_label = this->get_label(CMP_FALSE);
+        code.push_back(AsmLine::op(get_inverse_cond_jump(jump_opcode), false_label));
+        code.push_back(AsmLine::op(Opcode::MOV, Operand::reg_of(left_reg), Operand::imm(1)));
+        code.push_back(AsmLine::label(false_label));
+    }
+    code.push_back(this->comment("COMPARISON END"));
+
+    this->write_code(code, this->label_depth);
+    return left_reg;
+}
+
+/**
+    Compares the operands of a relational expression, and leaves the left operand in a register. A left operand
+    that is kept in a register is compared in place, unless a temporary is required, if the right operand is
+    simple.
+
+    @param rel_ptr Relational expression node
+    @param left_reg Set to the register of the left operand, owned by the caller
+    @param is_temp_required Whether the left operand must be in a temporary
+    @return Conditional jump taken if the relation holds
+**/
+Opcode CodeGenerator::gen_comparison(ASTNode* rel_ptr, Register& left_reg, bool is_temp_required) {
+    Operand left, right;
+    if (!is_temp_required && this->_get_simple_operand(rel_ptr->get_child(0), left) &&
+        left.kind == OperandKind::Register && this->_get_simple_operand(rel_ptr->get_child(1), right)) {
+        left_reg = left.reg;
+    } else {
+        left_reg = this->gen_expression(rel_ptr->get_child(0));
+        right = this->gen_right_operand(rel_ptr->get_child(1), left_reg, false);
+    }
+    this->write_code(AsmLine::op(Opcode::CMP, Operand::reg_of(left_reg), right), this->label_depth);
+    this->release_operand(right);
+
+    const string& relop = this->get_name(rel_ptr);
+    if (relop == "<") {
+        return Opcode::JL;
+    } else if (relop == "<=") {
+        return Opcode::JLE;
+    } else if (relop == ">") {
+        return Opcode::JG;
+    } else if (relop == ">=") {
+        return Opcode::JGE;
+    } else if (relop == "==") {
+        return Opcode::JE;
+    }
+    return Opcode::JNE;
+}
+
+Register CodeGenerator::gen_add_expression(ASTNode* add_ptr) {
+    Register left_reg = this->gen_expression(add_ptr->get_child(0));
+    Operand right = this->gen_right_operand(add_ptr->get_child(1), left_reg, false);
+
+    if (this->get_name(add_ptr) == "+") {
+        this->write_code(AsmLine::op(Opcode::ADD, Operand::reg_of(left_reg), right), this->label_depth);
+    } else if (this->get_name(add_ptr) == "-") {
+        this->write_code(AsmLine::op(Opcode::SUB, Operand::reg_of(left_reg), right), this->label_depth);
+    }
+    this->release_operand(right);
+    return left_reg;
+}
+
+/**
+    IMUL and IDIV take the left operand in AX and overwrite DX, the right operand has to be in another
+    register. Temporaries and variables held in AX or DX are saved around them.
+
+    @param mul_ptr MulExpression node
+    @return Register AX, or the register the result was moved to if AX is restored
+**/
+Register CodeGenerator::gen_mul_expression(ASTNode* mul_ptr) {
+    Register result_reg;
+    if (this->gen_reduced_mul_expression(mul_ptr, result_reg)) {
+        return result_reg;
+    }
+
+    Register left_reg = this->gen_expression(mul_ptr->get_child(0));
+    Register right_reg = this->gen_right_operand(mul_ptr->get_child(1), left_reg, true).reg;
+
+    vector<RegisterState> saved;
+    for (Register reg : {Register::AX, Register::DX}) {
+        if (reg != left_reg && reg != right_reg && !this->register_allocator.is_free(reg)) {
+            this->save_register(reg, saved);
+        }
+    }
+
+    if (right_reg == Register::AX || right_reg == Register::DX) {
+        if (left_reg != Register::AX && left_reg != Register::DX) {
+            this->write_code(AsmLine::op(Opcode::XCHG, Operand::reg_of(left_reg), Operand::reg_of(right_reg)),
+                this->label_depth);
+            swap(left_reg, right_reg);
+        } else {
+            Register reg;
+            if (!this->register_allocator.try_allocate(reg, {Register::AX, Register::DX})) {
+                reg = Register::BX;
+                this->save_register(reg, saved);
+                this->register_allocator.claim(reg);
+            }
+            this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(reg), Operand::reg_of(right_reg)),
+                this->label_depth);
+            this->register_allocator.release(right_reg);
+            right_reg = reg;
+        }
+    }
+    if (left_reg != Register::AX) {
+        this->write_code(AsmLine::op(Opcode::MOV, AX, Operand::reg_of(left_reg)), this->label_depth);
+        this->register_allocator.release(left_reg);
+        this->register_allocator.claim(Register::AX);
+    }
+
+    const string& mulop = this->get_name(mul_ptr);
+    vector<AsmLine> code;
+    if (mulop == "*") {
+        code.push_back(AsmLine::op(Opcode::IMUL, Operand::reg_of(right_reg))); // result in DX:AX, we'll take AX
+    } else if (mulop == "/") {
+        code.push_back(AsmLine::op(Opcode::MOV, DX, Operand::imm(0)));
+        code.push_back(AsmLine::op(Opcode::IDIV, Operand::reg_of(right_reg))); // AX quo, DX rem
+    } else if (mulop == "%") {
+        code.push_back(AsmLine::op(Opcode::MOV, DX, Operand::imm(0)));
+        code.push_back(AsmLine::op(Opcode::IDIV, Operand::reg_of(right_reg)));
+        code.push_back(AsmLine::op(Opcode::MOV, AX, DX));
+    }
+    this->write_code(code, this->label_depth);
+    this->register_allocator.release(right_reg);
+
+    result_reg = this->relocate_result(Register::AX, saved);
+    this->restore_registers(saved);
+    return result_reg;
+}
+
+/**
+    Reduces multiplication, division and modulo by a constant power of two to a shift or a mask. The dividend of
+    IDIV is the unsigned word, as DX is zeroed, so division is a logical shift.
+
+    @param mul_ptr MulExpression node
+    @param result_reg Set to the register holding the value
+    @return false if the operator needs IMUL or IDIV
+**/
+bool CodeGenerator::gen_reduced_mul_expression(ASTNode* mul_ptr, Register& result_reg) {
+    const string& mulop = this->get_name(mul_ptr);
+    ASTNode* operand_ptr = mul_ptr->get_child(0);
+    int value, exponent;
+    if (!this->constant_evaluator.evaluate(mul_ptr->get_child(1), value)) {
+        // a constant has no side effects, the operands of a multiplication can be swapped
+        if (mulop != "*" || !this->constant_evaluator.evaluate(operand_ptr, value)) {
+            return false;
+        }
+        operand_ptr = mul_ptr->get_child(1);
+    }
+
+    if (mulop == "*" && value == 0) {
+        result_reg = this->gen_expression(operand_ptr);
+        this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(result_reg), Operand::imm(0)), this->label_depth);
+        return true;
+    }
+    if (!ConstantEvaluator::get_power_of_two(value, exponent)) {
+        return false;
+    }
+
+    result_reg = this->gen_expression(operand_ptr);
+    Operand result = Operand::reg_of(result_reg);
+    if (mulop == "*" && exponent > 0) {
+        this->write_code(AsmLine::op(Opcode::SHL, result, Operand::imm(exponent)), this->label_depth);
+    } else if (mulop == "/" && exponent > 0) {
+        this->write_code(AsmLine::op(Opcode::SHR, result, Operand::imm(exponent)), this->label_depth);
+    } else if (mulop == "%") {
+        this->write_code(AsmLine::op(Opcode::AND, result, Operand::imm(value - 1)), this->label_depth);
+    }
+    return true;
+}
+
+Register CodeGenerator::gen_not_expression(ASTNode* not_ptr) {
+    Register value_reg = this->gen_expression(not_ptr->get_child(0));
+    this->write_code(AsmLine::op(Opcode::CMP, Operand::reg_of(value_reg), Operand::imm(0)), this->label_depth);
+
+    // SETE needs the low byte of the register, every register of the pool but DI has one
+    Register result_reg = value_reg;
+    if (!has_low_byte(value_reg)) {
+        result_reg = this->register_allocator.allocate();
+        this->register_allocator.release(value_reg);
+    }
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::MOV, Operand::reg_of(result_reg), Operand::imm(0)),
+        AsmLine::op(Opcode::SETE, Operand::reg_of(get_low_byte(result_reg)))
+    };
+    this->write_code(code, this->label_depth);
+    return result_reg;
+}
+
+Register CodeGenerator::gen_variable(ASTNode* var_ptr) {
+    Register value_reg = this->_is_index_evaluated(var_ptr) ? this->gen_var_index(var_ptr) :
+        this->register_allocator.allocate();
+    this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), this->_get_var_ref(var_ptr)),
+        this->label_depth);
+    return value_reg;
+}
+
+/**
+    Writes the code of a post increment or decrement, the value of the expression is the old value. SI is
+    stepped along with the index variable of the loop.
+
+    @param step_ptr PostIncrement or PostDecrement node
+    @param is_value_used Whether the old value is needed, if not the register returned holds no value
+**/
+Register CodeGenerator::gen_post_step(ASTNode* step_ptr, bool is_value_used) {
+    ASTNode* var_ptr = step_ptr->get_child(0);
+    Register value_reg = this->_is_index_evaluated(var_ptr) ? this->gen_var_index(var_ptr) :
+        this->register_allocator.allocate();
+    Operand var_ref = this->_get_var_ref(var_ptr);
+    bool is_increment = step_ptr->get_kind() == NodeKind::PostIncrement;
+    Opcode step_opcode = is_increment ? Opcode::INC : Opcode::DEC;
+
+    if (var_ref.kind == OperandKind::Register) {
+        if (is_value_used) {
+            this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), var_ref), this->label_depth);
+        }
+        this->write_code(AsmLine::op(step_opcode, var_ref), this->label_depth);
+    } else if (!is_value_used) {
+        vector<AsmLine> code{
+            AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), var_ref),
+            AsmLine::op(step_opcode, Operand::reg_of(value_reg)),
+            AsmLine::op(Opcode::MOV, var_ref, Operand::reg_of(value_reg))
+        };
+        this->write_code(code, this->label_depth);
+    } else {
+        Register step_reg = this->register_allocator.allocate();
+        vector<AsmLine> code{
+            AsmLine::op(Opcode::MOV, Operand::reg_of(value_reg), var_ref),
+            AsmLine::op(Opcode::MOV, Operand::reg_of(step_reg), Operand::reg_of(value_reg)),
+            AsmLine::op(step_opcode, Operand::reg_of(step_reg)),
+            AsmLine::op(Opcode::MOV, var_ref, Operand::reg_of(step_reg))
+        };
+        this->write_code(code, this->label_depth);
+        this->register_allocator.release(step_reg);
+    }
+    if (this->_is_reduced_index_variable(var_ptr)) {
+        this->write_code(AsmLine::op(is_increment ? Opcode::ADD : Opcode::SUB, SI, Operand::imm(DW_SZ)),
+            this->label_depth);
+    }
+    this->constant_evaluator.forget(var_ptr);
+    return value_reg;
+}
+
+/**
+    Registers in use are saved before the activation record is set up, the callee is free to use any of
+    them. The value is returned in AX.
+
+    @param call_ptr Call node
+    @return Register AX, or the register the result was moved to if AX is restored
+**/
+Register CodeGenerator::gen_call(ASTNode* call_ptr) {
+    // the definition code for the procedure we are calling is independent, written with its own stack offsets
+    const string& func_name = this->get_name(call_ptr);
+    this->write_code(this->comment("ACTIVATION RECORD SETUP FOR FUNCTION " + func_name), this->label_depth);
+
+    vector<RegisterState> saved;
+    for (Register reg : this->register_allocator.get_used_registers()) {
+        this->save_register(reg, saved);
+    }
+    // with the fast calling convention, the callee keeps BP and pops the arguments on the stack
+    int arg_count = call_ptr->get_num_children();
+    int register_arg_count = this->is_fast_call ?
+        this->program_generator_ptr->get_register_param_count(call_ptr->get_name_id()) : 0;
+    if (!this->is_fast_call) {
+        this->write_code(AsmLine::op(Opcode::PUSH, BP), this->label_depth);
+    }
+
+    for (int i = 0; i < arg_count - register_arg_count; i++) {
+        Register arg_reg = this->gen_expression(call_ptr->get_child(i));
+        this->write_code(AsmLine::op(Opcode::PUSH, Operand::reg_of(arg_reg)), this->label_depth);
+        this->register_allocator.release(arg_reg);
+    }
+    if (register_arg_count > 0) {
+        this->gen_register_args(call_ptr, register_arg_count);
+    }
+
+    vector<AsmLine> code{AsmLine::op(Opcode::CALL, Operand::symbol(call_ptr->get_name_id()))};
+    if (!this->is_fast_call) {
+        code.insert(code.end(), arg_count, AsmLine::op(Opcode::POP, BX)); // pop args
+        code.push_back(AsmLine::op(Opcode::POP, BP)); // restore old BP
+    }
+    code.push_back(this->comment("EXECUTION COMPLETE FOR FUNCTION " + func_name));
+    this->write_code(code, this->label_depth);
+
+    this->register_allocator.claim(Register::AX);
+    Register result_reg = this->relocate_result(Register::AX, saved);
+    this->restore_registers(saved);
+    return result_reg;
+}
+
+/**
+    Evaluates the last arguments of a call into the argument registers, in order, with the fast calling
+    convention.
+
+    @param call_ptr Call node
+    @param register_arg_count Number of arguments passed in registers, one or two
+**/
+void CodeGenerator::gen_register_args(ASTNode* call_ptr, int register_arg_count) {
+    const Operand ARG_0 = Operand::reg_of(ARG_REGISTERS[0]), ARG_1 = Operand::reg_of(ARG_REGISTERS[1]);
+    ASTNode* first_arg_ptr = call_ptr->get_child(call_ptr->get_num_children() - register_arg_count);
+    Operand first;
+    if (register_arg_count == 1 && this->_get_simple_operand(first_arg_ptr, first)) {
+        this->write_code(AsmLine::op(Opcode::MOV, ARG_0, first), this->label_depth);
+        return;
+    }
+
+    Register first_reg = this->gen_expression(first_arg_ptr);
+    first = Operand::reg_of(first_reg);
+    vector<AsmLine> code;
+    if (register_arg_count == 1) {
+        if (first != ARG_0) {
+            code.push_back(AsmLine::op(Opcode::MOV, ARG_0, first));
+        }
+        this->write_code(code, this->label_depth);
+        this->register_allocator.release(first_reg);
+        return;
+    }
+
+    Operand second = this->gen_right_operand(call_ptr->get_child(call_ptr->get_num_children() - 1), first_reg,
+        false);
+    first = Operand::reg_of(first_reg);
+    // the registers are moved so that neither value is overwritten before it is moved
+    if (second == ARG_0 && first == ARG_1) {
+        code.push_back(AsmLine::op(Opcode::XCHG, ARG_0, ARG_1));
+    } else if (second == ARG_0) {
+        code.push_back(AsmLine::op(Opcode::MOV, ARG_1, second));
+        code.push_back(AsmLine::op(Opcode::MOV, ARG_0, first));
+    } else {
+        if (first != ARG_0) {
+            code.push_back(AsmLine::op(Opcode::MOV, ARG_0, first));
+        }
+        if (second != ARG_1) {
+            code.push_back(AsmLine::op(Opcode::MOV, ARG_1, second));
+        }
+    }
+    this->write_code(code, this->label_depth);
+    this->release_operand(second);
+    this->register_allocator.release(first_reg);
+}
+
+/**
+    Writes a call of the function to itself whose value it returns as a jump back to its entry, once the
+    arguments replace its params. The recursion then runs in the same frame.
+
+    @param call_ptr Call node
+**/
+void CodeGenerator::gen_tail_call(ASTNode* call_ptr) {
+    this->write_code(this->comment("TAIL CALL OF FUNCTION " + this->get_name(call_ptr)), this->label_depth);
+    for (ASTNode* arg_ptr : call_ptr->get_children()) {
+        Register arg_reg = this->gen_expression(arg_ptr);
+        this->write_code(AsmLine::op(Opcode::PUSH, Operand::reg_of(arg_reg)), this->label_depth);
+        this->register_allocator.release(arg_reg);
+    }
+
+    // the last argument is on top, it is the param right above the return IP
+    vector<AsmLine> code;
+    for (int stack_offset = 1; stack_offset <= call_ptr->get_num_children(); stack_offset++) {
+        Operand param = stack_offset <= this->register_param_count ?
+            Operand::reg_of(ARG_REGISTERS[this->register_param_count - stack_offset]) : this->_get_slot(stack_offset);
+        code.push_back(AsmLine::op(Opcode::POP, param));
+    }
+    if (this->has_frame_pointer && this->frame_slot_count > 0) {
+        code.push_back(AsmLine::op(Opcode::MOV, SP, BP));
+    }
+    code.push_back(AsmLine::op(Opcode::JMP, Operand::label_of(FUNC_ENTRY, this->entry_label_id)));
+    this->write_code(code, this->label_depth);
+}
+
+/**
+    Writes the code that moves the word offset of an array element into SI.
+
+    @param var_ptr Variable node of an array element
+    @return Register Register that held the index, still allocated so it can take the element
+**/
+Register CodeGenerator::gen_var_index(ASTNode* var_ptr) {
+    Register index_reg = this->gen_expression(var_ptr->get_child(0));
+    this->gen_word_offset(index_reg);
+    return index_reg;
+}
+
+void CodeGenerator::gen_word_offset(Register index_reg) {
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::MOV, SI, Operand::reg_of(index_reg)),
+        AsmLine::op(Opcode::ADD, SI, SI)
+    };
+    this->write_code(code, this->label_depth);
+}
+
+/**
+    Evaluates the right operand of a binary operator whose left operand is in a register. A constant or a
+    scalar variable is used in place, unless a register is required. When the right operand would be
+    evaluated without enough free registers, the left operand is pushed and popped back afterwards,
+    possibly into another register.
+
+    @param right_ptr Right operand node
+    @param left_reg Register of the left operand, updated if the left operand is moved
+    @param is_reg_required Whether the right operand must be in a register
+    @return Operand Right operand, a temporary register to be released by the caller, or used in place
+**/
+Operand CodeGenerator::gen_right_operand(ASTNode* right_ptr, Register& left_reg, bool is_reg_required) {
+    Operand right;
+    bool is_simple = this->_get_simple_operand(right_ptr, right);
+    if (is_simple && !is_reg_required) {
+        return right;
+    }
+    // a simple operand is loaded into a single register
+    if (this->register_allocator.get_free_count() >= (is_simple ? 1 : 2)) {
+        return Operand::reg_of(this->gen_expression(right_ptr));
+    }
+
+    this->write_code(AsmLine::op(Opcode::PUSH, Operand::reg_of(left_reg)), this->label_depth);
+    this->register_allocator.release(left_reg);
+    right = Operand::reg_of(this->gen_expression(right_ptr));
+    left_reg = this->register_allocator.allocate();
+    this->write_code(AsmLine::op(Opcode::POP, Operand::reg_of(left_reg)), this->label_depth);
+    return right;
+}
+
+/**
+    Decides how many params of a function are passed in registers with the fast calling convention. Only a
+    function that makes no calls takes them, as it can keep them in the registers they are passed in, while
+    any other has to save them to the stack, which takes as long as pushing them.
+
+    @param func_def_ptr FuncDefinition node
+    @return Number of params passed in registers
+**/
+int CodeGenerator::count_register_params(ASTNode* func_def_ptr) {
+    map<int, int> use_weights;
+    int call_weight = 0;
+    this->current_func_id = func_def_ptr->get_name_id();
+    this->count_variable_uses(func_def_ptr->get_child(func_def_ptr->get_num_children() - 1), 1, use_weights,
+        call_weight);
+    return call_weight == 0 ? min(func_def_ptr->get_num_children() - 1, MAX_REGISTER_ARGS) : 0;
+}
+
+/**
+    @param func_id Name of a function
+    @return Number of params of the function passed in registers, 0 if it is declared but not defined
+**/
+int CodeGenerator::get_register_param_count(int func_id) const {
+    auto count_iter = this->register_param_counts.find(func_id);
+    return count_iter == this->register_param_counts.end() ? 0 : count_iter->second;
+}
+
+/**
+    Picks the scalar variables with the most uses in a function, uses inside loops weighing more, and binds
+    them to registers. A variable is only worth a register if it is used in a loop or often enough, and more
+    than it has to be saved around calls. A variable the arguments of a call assign is never bound, the register
+    is saved before the arguments and restored after the call, which would undo the assignment.
+
+    @param func_def_ptr FuncDefinition node
+**/
+void CodeGenerator::bind_hot_variables(ASTNode* func_def_ptr) {
+    map<int, int> use_weights;
+    int call_weight = 0;
+    this->count_variable_uses(func_def_ptr->get_child(func_def_ptr->get_num_children() - 1), 1, use_weights,
+        call_weight);
+    set<int> call_assigned_offsets;
+    this->find_call_assigned_variables(func_def_ptr->get_child(func_def_ptr->get_num_children() - 1), false,
+        call_assigned_offsets);
+
+    // a param passed in a register is bound without being loaded
+    vector<pair<int, int>> hot_variables;
+    for (const auto& [stack_offset, use_weight] : use_weights) {
+        bool is_register_param = stack_offset > 0 && stack_offset <= this->register_param_count;
+        if (call_assigned_offsets.count(stack_offset) > 0) {
+            continue;
+        }
+        if ((use_weight >= MIN_BIND_WEIGHT || is_register_param) && use_weight > 2 * call_weight) {
+            hot_variables.push_back({-use_weight, stack_offset});
+        }
+    }
+    sort(hot_variables.begin(), hot_variables.end());
+    for (const auto& [neg_use_weight, stack_offset] : hot_variables) {
+        if (!this->register_allocator.bind_variable(stack_offset)) {
+            break;
+        }
+    }
+}
+
+/**
+    @param node_ptr Node of the function body
+    @param weight Weight of a use at the loop depth of the node
+    @param use_weights Weights of the uses of the scalar local variables, keyed on the stack offset
+    @param call_weight Weight of the calls, that save the registers
+**/
+void CodeGenerator::count_variable_uses(ASTNode* node_ptr, int weight, map<int, int>& use_weights,
+    int& call_weight) {
+    switch (node_ptr->get_kind()) {
+        case NodeKind::ForStatement:
+            this->count_variable_uses(node_ptr->get_child(0), weight, use_weights, call_weight);
+            for (int i = 1; i < node_ptr->get_num_children(); i++) {
+                this->count_variable_uses(node_ptr->get_child(i), weight * LOOP_WEIGHT, use_weights, call_weight);
+            }
+            return;
+        case NodeKind::WhileStatement:
+            weight *= LOOP_WEIGHT;
+            break;
+        case NodeKind::Variable:
+            if (node_ptr->get_num_children() == 0 && node_ptr->get_codegen_info_ptr()->is_local()) {
+                use_weights[node_ptr->get_codegen_info_ptr()->get_stack_offset()] += weight;
+            }
+            break;
+        case NodeKind::ReturnStatement: {
+            // a call of the function to itself whose value it returns is a jump, that saves no registers
+            ASTNode* value_ptr = node_ptr->get_child(0);
+            if (this->is_fast_call && value_ptr->get_kind() == NodeKind::Call &&
+                value_ptr->get_name_id() == this->current_func_id) {
+                this->count_variable_uses(value_ptr, weight, use_weights, call_weight);
+                call_weight -= weight;
+                return;
+            }
+            break;
+        }
+        case NodeKind::Call:
+        case NodeKind::PrintlnStatement:
+            call_weight += weight;
+            break;
+        default:
+            break;
+    }
+
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->count_variable_uses(child_ptr, weight, use_weights, call_weight);
+    }
+}
+
+/**
+    @param node_ptr Node of the function body
+    @param is_call_arg Whether the node is inside the arguments of a call
+    @param stack_offsets Stack offsets of the scalar local variables assigned inside the arguments of a call
+**/
+void CodeGenerator::find_call_assigned_variables(ASTNode* node_ptr, bool is_call_arg, set<int>& stack_offsets) {
+    NodeKind kind = node_ptr->get_kind();
+    bool is_assignment = kind == NodeKind::Assignment || kind == NodeKind::PostIncrement ||
+        kind == NodeKind::PostDecrement;
+    if (is_call_arg && is_assignment) {
+        ASTNode* var_ptr = node_ptr->get_child(0);
+        if (var_ptr->get_num_children() == 0 && var_ptr->get_codegen_info_ptr()->is_local()) {
+            stack_offsets.insert(var_ptr->get_codegen_info_ptr()->get_stack_offset());
+        }
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->find_call_assigned_variables(child_ptr, is_call_arg || kind == NodeKind::Call, stack_offsets);
+    }
+}
+
+/**
+    Pushes a register in use and frees it if it holds a temporary, its state is kept to restore it. A register
+    bound to a variable still holds the variable until the code that needs it, e.g. the arguments of a call.
+**/
+void CodeGenerator::save_register(Register reg, vector<RegisterState>& saved) {
+    this->write_code(AsmLine::op(Opcode::PUSH, Operand::reg_of(reg)), this->label_depth);
+    saved.push_back(this->register_allocator.get_state(reg));
+    this->register_allocator.release(reg);
+}
+
+/**
+    Moves a result out of a register that is about to be restored, into one that is not.
+
+    @param result_reg Register holding the result
+    @param saved Registers saved with save_register
+    @return Register Register holding the result
+**/
+Register CodeGenerator::relocate_result(Register result_reg, const vector<RegisterState>& saved) {
+    vector<Register> saved_regs;
+    for (const RegisterState& state : saved) {
+        saved_regs.push_back(state.reg);
+    }
+    if (find(saved_regs.begin(), saved_regs.end(), result_reg) == saved_regs.end()) {
+        return result_reg;
+    }
+
+    Register reg = result_reg;
+    this->register_allocator.try_allocate(reg, saved_regs);
+    this->write_code(AsmLine::op(Opcode::MOV, Operand::reg_of(reg), Operand::reg_of(result_reg)), this->label_depth);
+    this->register_allocator.release(result_reg);
+    return reg;
+}
+
+void CodeGenerator::restore_registers(const vector<RegisterState>& saved) {
+    for (auto rev_iter = saved.rbegin(); rev_iter != saved.rend(); rev_iter++) {
+        this->write_code(AsmLine::op(Opcode::POP, Operand::reg_of(rev_iter->reg)), this->label_depth);
+        this->register_allocator.set_state(*rev_iter);
+    }
+}
+
+/**
+    Releases the right operand of an instruction if it is a temporary.
+**/
+void CodeGenerator::release_operand(const Operand& operand) {
+    if (operand.kind == OperandKind::Register && this->register_allocator.is_temp(operand.reg)) {
+        this->register_allocator.release(operand.reg);
+    }
+}
+
+/**
+    Generates label, with new id if label id is not provided or with provided id otherwise.
+    If new label is generated, label_count is incremented.
+
+    @param Label Label type to generate
+    @param label_id Label id to append after label name
+    @return The label operand with the id
+**/
+Operand CodeGenerator::get_label(Label label, int label_id) {
+    if (label_id < 0) {
+        label_id = this->label_count++; // no label_id provided, generate new label_id
+    }
+    return Operand::label_of(label, label_id);
+}
+
+/**
+    Resolves an operand that can be used in place, without evaluating it into a register.
+
+    @param expr_ptr Expression node
+    @param operand Set to the immediate of a constant, or the register or memory of a scalar variable or of an
+        array element at a constant index
+    @return false if the expression has to be evaluated
+**/
+bool CodeGenerator::_get_simple_operand(ASTNode* expr_ptr, Operand& operand) {
+    int value;
+    if (this->constant_evaluator.evaluate(expr_ptr, value)) {
+        operand = Operand::imm(value);
+        return true;
+    }
+    auto hoisted_iter = this->hoisted_values.find(expr_ptr);
+    if (hoisted_iter != this->hoisted_values.end()) {
+        operand = Operand::reg_of(hoisted_iter->second);
+        return true;
+    }
+    if (expr_ptr->get_kind() == NodeKind::Variable && !this->_is_index_evaluated(expr_ptr)) {
+        operand = this->_get_var_ref(expr_ptr);
+        return true;
+    }
+    return false;
+}
+
+/**
+    Resolves the operand of a variable, based on if it's local or global and if it's an array element or not.
+    A variable bound to a register is that register. An array element at a constant index is addressed
+    directly.
+
+    @param var_ptr Variable node, with storage resolved during Analysis.
+    @return Operand Register or memory operand of the variable
+**/
+Operand CodeGenerator::_get_var_ref(ASTNode* var_ptr) {
+    // array index in SI from expression, or from the index variable of the loop plus the constant index
+    bool is_indexed = this->_is_index_evaluated(var_ptr);
+    int index = 0;
+    if (this->_get_reduced_index(var_ptr, index)) {
+        is_indexed = true;
+    } else if (var_ptr->get_num_children() > 0 && !is_indexed) {
+        this->constant_evaluator.evaluate(var_ptr->get_child(0), index);
+    }
+
+    CodeGenInfo* var_cgi_ptr = var_ptr->get_codegen_info_ptr();
+    if (var_cgi_ptr->is_local()) {
+        Register reg;
+        if (var_ptr->get_num_children() == 0 &&
+            this->register_allocator.find_variable(var_cgi_ptr->get_stack_offset(), reg)) {
+            return Operand::reg_of(reg);
+        }
+        // elements are below the first one
+        return this->_get_slot(var_cgi_ptr->get_stack_offset() - index, is_indexed);
+    } else {
+        return Operand::symbol(var_ptr->get_name_id(), is_indexed, DW_SZ * index);
+    }
+}
+
+/**
+    @param var_ptr Variable node
+    @return Whether the variable is an array element whose index is evaluated at run time, into SI
+**/
+bool CodeGenerator::_is_index_evaluated(ASTNode* var_ptr) {
+    int index;
+    return var_ptr->get_num_children() > 0 && !this->constant_evaluator.evaluate(var_ptr->get_child(0), index) &&
+        !this->_get_reduced_index(var_ptr, index);
+}
+
+/**
+    @param var_ptr Variable node
+    @param index Set to the constant added to the index variable of the loop
+    @return Whether the variable is an array element indexed by the index variable of the loop, whose doubled
+        value is in SI
+**/
+bool CodeGenerator::_get_reduced_index(ASTNode* var_ptr, int& index) {
+    int value, stack_offset;
+    return this->reduced_index_offset != 0 && var_ptr->get_num_children() > 0 &&
+        !this->constant_evaluator.evaluate(var_ptr->get_child(0), value) &&
+        LoopAnalyzer::match_index(var_ptr->get_child(0), this->constant_evaluator, stack_offset, index) &&
+        stack_offset == this->reduced_index_offset;
+}
+
+/**
+    @param var_ptr Variable node
+    @return Whether the variable is the index variable of the loop, SI has to follow its changes
+**/
+bool CodeGenerator::_is_reduced_index_variable(ASTNode* var_ptr) {
+    CodeGenInfo* var_cgi_ptr = var_ptr->get_codegen_info_ptr();
+    return this->reduced_index_offset != 0 && var_ptr->get_num_children() == 0 && var_cgi_ptr->is_local() &&
+        var_cgi_ptr->get_stack_offset() == this->reduced_index_offset;
+}
+
+/**
+    @param block_ptr CompoundStatement node
+    @param first_idx Index of the first statement after the declaration of the scalar
+    @param stack_offset Stack offset of the scalar local
+    @return Whether the first statement that uses the scalar does not start by assigning it a value that does
+        not depend on it
+**/
+bool CodeGenerator::_is_read_before_assigned(ASTNode* block_ptr, int first_idx, int stack_offset) {
+    for (int i = first_idx; i < block_ptr->get_num_children(); i++) {
+        ASTNode* statement_ptr = block_ptr->get_child(i);
+        if (!this->_is_local_used(statement_ptr, stack_offset)) {
+            continue;
+        }
+
+        // the initialization of a for loop runs first
+        if (statement_ptr->get_kind() == NodeKind::ForStatement) {
+            statement_ptr = statement_ptr->get_child(0);
+        }
+        if (statement_ptr->get_kind() != NodeKind::ExpressionStatement || statement_ptr->get_num_children() == 0 ||
+            statement_ptr->get_child(0)->get_kind() != NodeKind::Assignment) {
+            return true;
+        }
+        ASTNode* var_ptr = statement_ptr->get_child(0)->get_child(0);
+        return var_ptr->get_num_children() > 0 || !var_ptr->get_codegen_info_ptr()->is_local() ||
+            var_ptr->get_codegen_info_ptr()->get_stack_offset() != stack_offset ||
+            this->_is_local_used(statement_ptr->get_child(0)->get_child(1), stack_offset);
+    }
+    return false;
+}
+
+bool CodeGenerator::_is_local_used(ASTNode* node_ptr, int stack_offset) {
+    CodeGenInfo* cgi_ptr = node_ptr->get_codegen_info_ptr();
+    if (node_ptr->get_kind() == NodeKind::Variable && cgi_ptr->is_local() &&
+        cgi_ptr->get_stack_offset() == stack_offset) {
+        return true;
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (this->_is_local_used(child_ptr, stack_offset)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+    @return Whether a statement returns the value of a call of the current function
+**/
+bool CodeGenerator::_has_self_tail_call(ASTNode* node_ptr) {
+    if (node_ptr->get_kind() == NodeKind::ReturnStatement) {
+        ASTNode* value_ptr = node_ptr->get_child(0);
+        return value_ptr->get_kind() == NodeKind::Call && value_ptr->get_name_id() == this->current_func_id;
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (this->_has_self_tail_call(child_ptr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+    @return Whether the subtree prints, so the program needs the print procedure
+**/
+bool CodeGenerator::_has_println(ASTNode* node_ptr) {
+    if (node_ptr->get_kind() == NodeKind::PrintlnStatement) {
+        return true;
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (this->_has_println(child_ptr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+    @param stack_offset Stack offset of a param or local
+    @param is_indexed Whether the word offset in SI is subtracted, for array elements
+    @return Operand Stack slot of the variable, relative to BP
+**/
+Operand CodeGenerator::_get_slot(int stack_offset, bool is_indexed) {
+    int displacement = stack_offset > 0 ? this->param_displacements.at(stack_offset) : DW_SZ * stack_offset;
+    return Operand::local(displacement, is_indexed);
+}
+
+/**
+    @brief Returns code for dropping the frame, with return using IP on stack top.
+**/
+vector<AsmLine> CodeGenerator::_get_activation_record_teardown_code() {
+    // return expression already in AX, don't touch AX, SP is set back below the return IP.
+    // params will be popped off by caller action code, or by RET with the fast calling convention
+    vector<AsmLine> code;
+    if (this->has_frame_pointer && this->frame_slot_count > 0) {
+        code.push_back(AsmLine::op(Opcode::MOV, SP, BP));
+    }
+    if (this->is_frame_pointer_saved) {
+        code.push_back(AsmLine::op(Opcode::POP, BP));
+    }
+    if (this->is_fast_call && this->stack_param_count > 0) {
+        code.push_back(AsmLine::op(Opcode::RET, Operand::imm(DW_SZ * this->stack_param_count)));
+    } else {
+        code.push_back(AsmLine::op(Opcode::RET)); // will find IP on top
+    }
+    return code;
+}
+
+/**
+    Writes allocation asm code of int variable based on if the variable is a local or global.
+    Global allocations are written into the data section.
+
+    @param declarator_ptr Declarator of the variable to be allocated
+**/
+void CodeGenerator::_alloc_int_var(ASTNode* declarator_ptr) {
+    CodeGenInfo* var_cgi_ptr = declarator_ptr->get_codegen_info_ptr();
+
+    if (!var_cgi_ptr->is_local()) {
+        this->asm_buffer.write_data(declarator_ptr->get_name_id());
+    } else {
+        // the stack slot is reserved at the entry, and zeroed there if the variable is not in a register
+        Register reg;
+        int stack_offset = var_cgi_ptr->get_stack_offset();
+        if (this->zeroed_offsets.count(stack_offset) > 0 && this->register_allocator.find_variable(stack_offset, reg)) {
+            vector<AsmLine> code{
+                this->comment("INITIALIZING BASIC VARIABLE " + this->get_name(declarator_ptr) + " at stack offset " +
+                    to_string(stack_offset)),
+                AsmLine::op(Opcode::MOV, Operand::reg_of(reg), Operand::imm(0))
+            };
+            this->write_code(code, this->label_depth);
+        }
+    }
+}
+
+/**
+    Writes allocation asm code of int array based on if the array is a local or global.
+    Global allocations are written into the data section.
+
+    @param declarator_ptr Declarator of the array to be allocated
+**/
+void CodeGenerator::_alloc_int_array(ASTNode* declarator_ptr) {
+    int arr_size = declarator_ptr->get_count();
+    CodeGenInfo* arr_cgi_ptr = declarator_ptr->get_codegen_info_ptr();
+
+    // the slots of a local array are reserved and zeroed at the entry
+    if (!arr_cgi_ptr->is_local()) {
+        this->asm_buffer.write_data(declarator_ptr->get_name_id(), arr_size);
+    }
+}
+
+/**
+    Writes the print procedure, that prints the int in AX on a line. The digits are written from the last one
+    into a line buffer, ending with LF and CR, divided by 10 with a multiplication by its reciprocal, instead
+    of DIV. The line is written with a single DOS call, or copied into the output buffer when it is buffered,
+    which is written first if the line may not fit. AX, BX, CX and DX are overwritten.
+**/
+void CodeGenerator::append_print_proc_def() {
+    int print_proc_id = this->string_interner.intern("PRINT_INT_IN_AX");
+    Operand line_buffer = Operand::symbol(this->string_interner.intern("PRINT_BUFFER"), true);
+    this->asm_buffer.write_byte_data(line_buffer.value, PRINT_DIGIT_COUNT);
+    this->asm_buffer.write_byte_data(this->string_interner.intern("PRINT_LINE_END"), 0,
+        this->string_interner.intern("10, 13, '$'"));
+
+    this->write_code(AsmLine::proc_begin(print_proc_id));
+    // SI indexes the line buffer, it may hold the offset of the array elements of a loop
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::PUSH, SI),
+        AsmLine::op(Opcode::MOV, CX, AX),
+        AsmLine::op(Opcode::MOV, SI, Operand::imm(PRINT_DIGIT_COUNT)),
+        AsmLine::op(Opcode::TEST, AX, AX),
+        AsmLine::op(Opcode::JNS, Operand::label_of(PRINT_DIGIT_LOOP)),
+        AsmLine::op(Opcode::NEG, AX),
+
+        // AX / 10 is the high word of AX * RECIPROCAL_OF_10 shifted right by 3, the digit is AX - 10 * (AX / 10)
+        AsmLine::label(Operand::label_of(PRINT_DIGIT_LOOP)),
+        AsmLine::op(Opcode::MOV, BX, AX),
+        AsmLine::op(Opcode::MOV, DX, Operand::imm(RECIPROCAL_OF_10, ImmediateFormat::Hex)),
+        AsmLine::op(Opcode::MUL, DX),
+        AsmLine::op(Opcode::SHR, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::SHR, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::SHR, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::MOV, AX, DX),
+        AsmLine::op(Opcode::SHL, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::SUB, BX, DX),
+        AsmLine::op(Opcode::SHL, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::SHL, DX, Operand::imm(1)),
+        AsmLine::op(Opcode::SUB, BX, DX),
+        AsmLine::op(Opcode::ADD, BL, Operand::imm('0', ImmediateFormat::Char)),
+        AsmLine::op(Opcode::DEC, SI),
+        AsmLine::op(Opcode::MOV, line_buffer, BL),
+        AsmLine::op(Opcode::TEST, AX, AX),
+        AsmLine::op(Opcode::JNE, Operand::label_of(PRINT_DIGIT_LOOP)),
+
+        AsmLine::op(Opcode::TEST, CX, CX),
+        AsmLine::op(Opcode::JNS, Operand::label_of(PRINT_LINE)),
+        AsmLine::op(Opcode::DEC, SI),
+        AsmLine::op(Opcode::MOV, line_buffer, Operand::imm('-', ImmediateFormat::Char)),
+        AsmLine::label(Operand::label_of(PRINT_LINE))
+    };
+
+    if (!this->is_output_buffered) {
+        code.insert(code.end(), {
+            AsmLine::op(Opcode::LEA, DX, line_buffer),
+            AsmLine::op(Opcode::MOV, AH, Operand::imm(9)),
+            AsmLine::op(Opcode::INT, Operand::imm(0x21, ImmediateFormat::Hex))
+        });
+    } else {
+        Operand output_buffer = Operand::symbol(this->string_interner.intern("OUTPUT_BUFFER"));
+        Operand output_length = Operand::symbol(this->string_interner.intern("OUTPUT_LENGTH"));
+        // the line is copied from SI to DI, that holds a variable
+        code.insert(code.end(), {
+            AsmLine::op(Opcode::PUSH, DI),
+            AsmLine::op(Opcode::MOV, DI, output_length),
+            AsmLine::op(Opcode::CMP, DI, Operand::imm(OUTPUT_BUFFER_SIZE - PRINT_LINE_SIZE)),
+            AsmLine::op(Opcode::JLE, Operand::label_of(OUTPUT_HAS_ROOM)),
+            AsmLine::op(Opcode::CALL, Operand::symbol(this->string_interner.intern("FLUSH_OUTPUT"))),
+            AsmLine::op(Opcode::MOV, DI, Operand::imm(0)),
+
+            AsmLine::label(Operand::label_of(OUTPUT_HAS_ROOM)),
+            AsmLine::op(Opcode::MOV, CX, Operand::imm(PRINT_LINE_SIZE)),
+            AsmLine::op(Opcode::SUB, CX, SI),
+            AsmLine::op(Opcode::ADD, output_length, CX),
+            AsmLine::op(Opcode::LEA, SI, line_buffer),
+            AsmLine::op(Opcode::LEA, AX, output_buffer),
+            AsmLine::op(Opcode::ADD, DI, AX),
+            AsmLine::op(Opcode::PUSH, DS),
+            AsmLine::op(Opcode::POP, ES),
+            AsmLine::op(Opcode::CLD),
+            AsmLine::op(Opcode::REP_MOVSB),
+            AsmLine::op(Opcode::POP, DI)
+        });
+    }
+    code.insert(code.end(), {
+        AsmLine::op(Opcode::POP, SI),
+        AsmLine::op(Opcode::RET)
+    });
+    this->write_code(code, 1);
+    this->write_code(AsmLine::proc_end());
+}
+
+/**
+    Writes the procedure that writes the lines collected in the output buffer to the standard output, with
+    a single DOS call, and empties the buffer. AX, BX, CX and DX are overwritten.
+**/
+void CodeGenerator::append_flush_proc_def() {
+    Operand output_buffer = Operand::symbol(this->string_interner.intern("OUTPUT_BUFFER"));
+    Operand output_length = Operand::symbol(this->string_interner.intern("OUTPUT_LENGTH"));
+    this->asm_buffer.write_data(output_length.value);
+    this->asm_buffer.write_byte_data(output_buffer.value, OUTPUT_BUFFER_SIZE);
+
+    this->write_code(AsmLine::proc_begin(this->string_interner.intern("FLUSH_OUTPUT")));
+    vector<AsmLine> code{
+        AsmLine::op(Opcode::MOV, AH, Operand::imm(0x40, ImmediateFormat::Hex)),
+        AsmLine::op(Opcode::MOV, BX, Operand::imm(1)), // standard output handle
+        AsmLine::op(Opcode::MOV, CX, output_length),
+        AsmLine::op(Opcode::LEA, DX, output_buffer),
+        AsmLine::op(Opcode::INT, Operand::imm(0x21, ImmediateFormat::Hex)),
+        AsmLine::op(Opcode::MOV, output_length, Operand::imm(0)),
+        AsmLine::op(Opcode::RET)
+    };
+    this->write_code(code, 1);
+    this->write_code(AsmLine::proc_end());
+}
+
+/**
+    @return Name of the node, from the string interner
+**/
+const string& CodeGenerator::get_name(ASTNode* node_ptr) {
+    return this->string_interner.get_string(node_ptr->get_name_id());
+}
+
+/**
+    @return Comment line, with its text interned
+**/
+AsmLine CodeGenerator::comment(const string& text) {
+    return AsmLine::comment(this->string_interner.intern(text));
+}
+
+void CodeGenerator::write_code(const AsmLine& line, int indentation) {
+    this->asm_buffer.write_code(line, indentation);
+}
+
+void CodeGenerator::write_code(const vector<AsmLine>& code, int indentation) {
+    this->asm_buffer.write_code(code, indentation);
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "../../ast/include.hpp"
+#include "../../symbol-table/SymbolInfo/SemanticType.hpp"
+#include "../../worker-pool/include.hpp"
+#include "../AsmBuffer/AsmBuffer.hpp"
+#include "../CodeCache/CodeCache.hpp"
+#include "../ConstantEvaluator/ConstantEvaluator.hpp"
+#include "../LoopAnalyzer/LoopAnalyzer.hpp"
+#include "../RegisterAllocator/RegisterAllocator.hpp"
+
+using namespace std;
+
+const string SOURCE_MAIN_FUNC_NAME = "__main__";
+const int DW_SZ = 2;
+// weight of a variable use or a call inside a loop, relative to one outside
+const int LOOP_WEIGHT = 8;
+// least weight of the uses of a variable bound to a register
+const int MIN_BIND_WEIGHT = LOOP_WEIGHT;
+// least number of zeroed slots of a frame filled with REP STOSW instead of one MOV each
+const int MIN_BLOCK_FILL_WORDS = 8;
+// with the fast calling convention, the last arguments of a call are passed in registers, in order
+const int MAX_REGISTER_ARGS = 2;
+const Register ARG_REGISTERS[MAX_REGISTER_ARGS] = {Register::BX, Register::DX};
+// most characters of a printed int, "-32768", and of the line with its LF and CR
+const int PRINT_DIGIT_COUNT = 6;
+const int PRINT_LINE_SIZE = PRINT_DIGIT_COUNT + 2;
+// bytes of printed lines collected before they are written, when the output is buffered
+const int OUTPUT_BUFFER_SIZE = 512;
+// 2^19 / 10 rounded up, the high word of the product of a word with it, shifted right by 3, is the word / 10
+const int RECIPROCAL_OF_10 = 0xCCCD;
+
+/**
+ * @brief Optimizations of a loop set up at its entry, undone at its exit.
+ */
+struct LoopContext {
+    bool is_index_reduced;
+    Register hoisted_reg;
+    vector<ASTNode*> hoisted_exprs;
+};
+
+/**
+ * @brief Synthesis phase of the compiler. Walks the AST built by the Analysis phase in source order and
+ * writes x86 instructions for every function into the code section of the assembly buffer. Globals are
+ * written into its data section.
+ *
+ * Expressions are evaluated into registers given out by the register allocator. An operand that is a
+ * constant or a scalar variable is used in place. At least two registers are free whenever an expression is
+ * evaluated, if not, the left operand of a binary operator waits on the stack while the right one is
+ * evaluated. Registers in use are saved on the stack around calls, and around IMUL and IDIV when they hold
+ * AX or DX. The hottest scalar variables of each function live in registers instead of their stack slots.
+ *
+ * The frame of a function, the slots of all its locals, is reserved at the entry with a single adjustment of
+ * SP and dropped by restoring SP from BP. Only the locals that can be read before they are assigned are
+ * zeroed.
+ *
+ * With the fast calling convention, the last two arguments of a function that makes no calls are passed in BX
+ * and DX, the callee keeps BP and pops the arguments on the stack with RET n. A function without params or
+ * locals on the stack sets up no BP, and a call of a function to itself whose value it returns jumps back to
+ * its entry.
+ *
+ * Prints convert the int into a line buffer and write it with a single DOS call. When the output is
+ * buffered, the lines are collected in a larger buffer instead, written when it is full and at the exit.
+ *
+ * Constant subexpressions are folded, with the values of locals known from earlier assignments, and array
+ * elements at a constant index are addressed directly. Multiplication, division and modulo by a power of
+ * two are reduced to shifts and masks.
+ *
+ * Conditions of branches and loops compile to conditional jumps on the flags of their comparisons, && and
+ * || jumping as soon as an operand decides them. Loops are entered at their condition, which is checked at
+ * the bottom.
+ *
+ * Inside a loop, twice the variable that indexes its arrays is kept in SI, bumped along with the variable,
+ * and the loop invariant expression with the most operators is evaluated once at the entry into a register.
+ *
+ * Functions share nothing but the numbering of their labels. Each one is generated by a generator of its own
+ * into a buffer of its own, with labels numbered from 0, on a pool of worker threads. The code of the
+ * functions is then appended in source order, with the labels of each renumbered after those of the
+ * functions before it, so the program is the same on any number of threads.
+ *
+ * With a code cache, the code of a function is read from the cache when everything it is generated from is
+ * the same as when it was written: the subtree of the function after inlining, the params the functions it
+ * calls take in registers, and the options.
+ */
+class CodeGenerator {
+    AsmBuffer& asm_buffer;
+    // interner of the names of the AST and of the code
+    StringInterner& string_interner;
+    bool is_fast_call;
+    bool is_output_buffered;
+    // number of threads the functions are generated on
+    int job_count;
+    // cache of the code of functions, nullptr if none
+    CodeCache* code_cache_ptr;
+    // generator of the whole program, that the generators of its functions read what the program shares from,
+    // itself for the program generator
+    const CodeGenerator* program_generator_ptr;
+    RegisterAllocator register_allocator;
+    ConstantEvaluator constant_evaluator;
+
+    // number of label-requiring-statements encountered
+    int label_count;
+    // depth of nested label-requiring-statements
+    int label_depth;
+    // print procedure is only appended if it is called
+    bool is_print_proc_called;
+    // stack offset of the variable whose doubled value is in SI, 0 if none
+    int reduced_index_offset;
+    // registers holding the values of the hoisted loop invariant expressions
+    map<ASTNode*, Register> hoisted_values;
+    // stack slots of the locals of the current function
+    int frame_slot_count;
+    // stack offsets of the locals of the current function that start as 0
+    set<int> zeroed_offsets;
+    // params passed in registers with the fast calling convention, keyed on the name handle of the function, set
+    // in the program generator
+    map<int, int> register_param_counts;
+    // name handle of the current function
+    int current_func_id;
+    // params of the current function passed in registers, and on the stack
+    int register_param_count;
+    int stack_param_count;
+    // displacements from BP of the params of the current function that are on the stack
+    map<int, int> param_displacements;
+    // whether the current function sets up BP, and keeps the BP of its caller
+    bool has_frame_pointer;
+    bool is_frame_pointer_saved;
+    // label of the entry of the current function for its tail calls, -1 if it has none
+    int entry_label_id;
+
+public:
+    CodeGenerator(AsmBuffer&, StringInterner&, bool = false, bool = false, int = 1, CodeCache* = nullptr);
+
+    void generate(ASTNode*);
+
+private:
+    CodeGenerator(AsmBuffer&, const CodeGenerator&);
+
+    void gen_entry_proc();
+    int gen_func_code(ASTNode*, AsmBuffer&);
+    string get_cache_key(ASTNode*);
+    void write_cache_key(ASTNode*, string&);
+    void gen_var_declaration(ASTNode*);
+    void gen_func_definition(ASTNode*);
+    void place_params(ASTNode*);
+    void gen_frame_setup(ASTNode*);
+    void find_zeroed_locals(ASTNode*);
+    void gen_statement(ASTNode*);
+    void gen_for_statement(ASTNode*);
+    void gen_if_statement(ASTNode*);
+    void gen_while_statement(ASTNode*);
+    void gen_println_statement(ASTNode*);
+    void gen_condition_jump(ASTNode*, bool, const Operand&);
+    LoopContext gen_loop_entry(ASTNode*);
+    void end_loop(const LoopContext&);
+    void gen_effect(ASTNode*);
+    Register gen_expression(ASTNode*);
+    Register gen_assignment(ASTNode*);
+    Register gen_logic_expression(ASTNode*);
+    Register gen_rel_expression(ASTNode*);
+    Opcode gen_comparison(ASTNode*, Register&, bool);
+    Register gen_add_expression(ASTNode*);
+    Register gen_mul_expression(ASTNode*);
+    bool gen_reduced_mul_expression(ASTNode*, Register&);
+    Register gen_not_expression(ASTNode*);
+    Register gen_variable(ASTNode*);
+    Register gen_post_step(ASTNode*, bool = true);
+    Register gen_call(ASTNode*);
+    void gen_register_args(ASTNode*, int);
+    void gen_tail_call(ASTNode*);
+    Register gen_var_index(ASTNode*);
+    void gen_word_offset(Register);
+    Operand gen_right_operand(ASTNode*, Register&, bool);
+
+    int count_register_params(ASTNode*);
+    int get_register_param_count(int) const;
+    void bind_hot_variables(ASTNode*);
+    void count_variable_uses(ASTNode*, int, map<int, int>&, int&);
+    void find_call_assigned_variables(ASTNode*, bool, set<int>&);
+    void save_register(Register, vector<RegisterState>&);
+    Register relocate_result(Register, const vector<RegisterState>&);
+    void restore_registers(const vector<RegisterState>&);
+    void release_operand(const Operand&);
+
+    Operand get_label(Label, int=-1);
+    bool _get_simple_operand(ASTNode*, Operand&);
+    bool _is_index_evaluated(ASTNode*);
+    bool _get_reduced_index(ASTNode*, int&);
+    bool _is_reduced_index_variable(ASTNode*);
+    Operand _get_var_ref(ASTNode*);
+    bool _is_read_before_assigned(ASTNode*, int, int);
+    bool _is_local_used(ASTNode*, int);
+    bool _has_self_tail_call(ASTNode*);
+    bool _has_println(ASTNode*);
+    Operand _get_slot(int, bool = false);
+    vector<AsmLine> _get_activation_record_teardown_code();
+    void _alloc_int_var(ASTNode*);
+    void _alloc_int_array(ASTNode*);
+    void append_print_proc_def();
+    void append_flush_proc_def();
+    const string& get_name(ASTNode*);
+    AsmLine comment(const string&);
+    void write_code(const AsmLine&, int=0);
+    void write_code(const vector<AsmLine>&, int=0);
+};
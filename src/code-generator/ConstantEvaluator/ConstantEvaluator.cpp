@@ -0,0 +1,210 @@
+#include <cstdlib>
+#include "ConstantEvaluator.hpp"
+
+using namespace std;
+
+ConstantEvaluator::ConstantEvaluator(StringInterner& string_interner)
+    : string_interner(string_interner) {
+}
+
+/**
+ * @brief Evaluates an expression at compile time.
+ *
+ * @param expr_ptr Expression node
+ * @param value Set to the value of the expression, as a 16-bit signed word
+ * @return false if the expression is not constant
+ */
+bool ConstantEvaluator::evaluate(ASTNode* expr_ptr, int& value) const {
+    int left_value, right_value, stack_offset;
+    const string& name = this->string_interner.get_string(expr_ptr->get_name_id());
+    switch (expr_ptr->get_kind()) {
+        case NodeKind::ConstInt:
+            value = ConstantEvaluator::wrap(strtol(name.c_str(), nullptr, 10));
+            return true;
+        case NodeKind::Variable: {
+            if (!ConstantEvaluator::get_scalar_local_offset(expr_ptr, stack_offset)) {
+                return false;
+            }
+            auto known_iter = this->known_values.find(stack_offset);
+            if (known_iter == this->known_values.end()) {
+                return false;
+            }
+            value = known_iter->second;
+            return true;
+        }
+        case NodeKind::UnaryExpression:
+            if (!this->evaluate(expr_ptr->get_child(0), value)) {
+                return false;
+            }
+            value = name == "-" ? ConstantEvaluator::wrap(-value) : value;
+            return true;
+        case NodeKind::NotExpression:
+            if (!this->evaluate(expr_ptr->get_child(0), value)) {
+                return false;
+            }
+            value = value == 0;
+            return true;
+        case NodeKind::LogicExpression:
+            // the right operand is not evaluated if the left one decides, it may then have side effects
+            if (!this->evaluate(expr_ptr->get_child(0), left_value)) {
+                return false;
+            }
+            if ((left_value != 0) == (name == "||")) {
+                value = left_value != 0;
+                return true;
+            }
+            if (!this->evaluate(expr_ptr->get_child(1), right_value)) {
+                return false;
+            }
+            value = right_value != 0;
+            return true;
+        case NodeKind::RelExpression:
+        case NodeKind::AddExpression:
+        case NodeKind::MulExpression:
+            return this->evaluate(expr_ptr->get_child(0), left_value) &&
+                this->evaluate(expr_ptr->get_child(1), right_value) &&
+                ConstantEvaluator::fold(name, left_value, right_value, value);
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Updates the value of a scalar local after an assignment, it is known if the value is constant.
+ *
+ * @param var_ptr Variable node that is assigned
+ * @param value_ptr Expression node of the assigned value
+ */
+void ConstantEvaluator::learn(ASTNode* var_ptr, ASTNode* value_ptr) {
+    int stack_offset, value;
+    if (!ConstantEvaluator::get_scalar_local_offset(var_ptr, stack_offset)) {
+        return;
+    }
+    if (this->evaluate(value_ptr, value)) {
+        this->known_values[stack_offset] = value;
+    } else {
+        this->known_values.erase(stack_offset);
+    }
+}
+
+/**
+ * @brief Forgets the value of a scalar local that is changed, e.g. by a post increment.
+ */
+void ConstantEvaluator::forget(ASTNode* var_ptr) {
+    int stack_offset;
+    if (ConstantEvaluator::get_scalar_local_offset(var_ptr, stack_offset)) {
+        this->known_values.erase(stack_offset);
+    }
+}
+
+/**
+ * @brief Forgets the values of the scalar locals that are changed anywhere in a subtree, e.g. a loop whose
+ * head can be reached from its end.
+ */
+void ConstantEvaluator::forget_assigned(ASTNode* node_ptr) {
+    NodeKind kind = node_ptr->get_kind();
+    if (kind == NodeKind::Assignment || kind == NodeKind::PostIncrement || kind == NodeKind::PostDecrement) {
+        this->forget(node_ptr->get_child(0));
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->forget_assigned(child_ptr);
+    }
+}
+
+void ConstantEvaluator::forget_all() {
+    this->known_values.clear();
+}
+
+const map<int, int>& ConstantEvaluator::get_known_values() const {
+    return this->known_values;
+}
+
+void ConstantEvaluator::set_known_values(const map<int, int>& known_values) {
+    this->known_values = known_values;
+}
+
+/**
+ * @brief Keeps the values that are also known, and the same, on another path joining the current one.
+ */
+void ConstantEvaluator::meet(const map<int, int>& other_known_values) {
+    for (auto known_iter = this->known_values.begin(); known_iter != this->known_values.end();) {
+        auto other_iter = other_known_values.find(known_iter->first);
+        if (other_iter == other_known_values.end() || other_iter->second != known_iter->second) {
+            known_iter = this->known_values.erase(known_iter);
+        } else {
+            known_iter++;
+        }
+    }
+}
+
+StringInterner& ConstantEvaluator::get_string_interner() const {
+    return this->string_interner;
+}
+
+/**
+ * @brief Folds a binary arithmetic or relational operator. Division is IDIV with DX zeroed, the dividend
+ * is the unsigned word, as in the generated code.
+ *
+ * @param op Operator
+ * @param left_value Left operand
+ * @param right_value Right operand
+ * @param value Set to the result
+ * @return false if the division faults, it is left to run time
+ */
+bool ConstantEvaluator::fold(const string& op, int left_value, int right_value, int& value) {
+    if (op == "+") {
+        value = ConstantEvaluator::wrap(left_value + right_value);
+    } else if (op == "-") {
+        value = ConstantEvaluator::wrap(left_value - right_value);
+    } else if (op == "*") {
+        value = ConstantEvaluator::wrap(left_value * right_value);
+    } else if (op == "/" || op == "%") {
+        int dividend = (unsigned short)left_value;
+        if (right_value == 0 || dividend / right_value < -32768 || dividend / right_value > 32767) {
+            return false;
+        }
+        value = ConstantEvaluator::wrap(op == "/" ? dividend / right_value : dividend % right_value);
+    } else if (op == "<") {
+        value = left_value < right_value;
+    } else if (op == "<=") {
+        value = left_value <= right_value;
+    } else if (op == ">") {
+        value = left_value > right_value;
+    } else if (op == ">=") {
+        value = left_value >= right_value;
+    } else if (op == "==") {
+        value = left_value == right_value;
+    } else {
+        value = left_value != right_value;
+    }
+    return true;
+}
+
+/**
+ * @param value Constant operand
+ * @param exponent Set to the exponent if the value is a power of two
+ * @return false if the value is not a positive power of two
+ */
+bool ConstantEvaluator::get_power_of_two(int value, int& exponent) {
+    if (value <= 0 || (value & (value - 1)) != 0) {
+        return false;
+    }
+    for (exponent = 0; (1 << exponent) != value; exponent++);
+    return true;
+}
+
+/**
+ * @brief Truncates a value to a 16-bit signed word.
+ */
+int ConstantEvaluator::wrap(int value) {
+    return (short)value;
+}
+
+bool ConstantEvaluator::get_scalar_local_offset(ASTNode* var_ptr, int& stack_offset) {
+    CodeGenInfo* var_cgi_ptr = var_ptr->get_codegen_info_ptr();
+    if (var_ptr->get_num_children() > 0 || !var_cgi_ptr->is_local()) {
+        return false;
+    }
+    stack_offset = var_cgi_ptr->get_stack_offset();
+    return true;
+}
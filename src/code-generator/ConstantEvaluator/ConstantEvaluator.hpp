@@ -0,0 +1,52 @@
+#pragma once
+#include <map>
+#include <string>
+#include "../../ast/include.hpp"
+
+using namespace std;
+
+/**
+ * @brief Compile time evaluation of expressions, with the 16-bit wraparound of the generated code. An
+ * expression is constant if it has no side effects and its operands are literals or scalar locals whose
+ * value is known at the current point of the code.
+ *
+ * Values of locals are learnt from assignments of constants, as the code generator walks the function in
+ * source order. Locals assigned inside a loop are forgotten at the loop head, and after an if-else only the
+ * values both branches agree on are kept. Globals are never known, calls can change them.
+ */
+class ConstantEvaluator {
+    // interner of the literals and operators of the nodes
+    StringInterner& string_interner;
+    // known values of the scalar locals, keyed on the stack offset
+    map<int, int> known_values;
+
+public:
+    ConstantEvaluator(StringInterner&);
+
+    bool evaluate(ASTNode*, int&) const;
+
+    void learn(ASTNode*, ASTNode*);
+
+    void forget(ASTNode*);
+
+    void forget_assigned(ASTNode*);
+
+    void forget_all();
+
+    const map<int, int>& get_known_values() const;
+
+    void set_known_values(const map<int, int>&);
+
+    void meet(const map<int, int>&);
+
+    StringInterner& get_string_interner() const;
+
+    static bool fold(const string&, int, int, int&);
+
+    static bool get_power_of_two(int, int&);
+
+    static int wrap(int);
+
+private:
+    static bool get_scalar_local_offset(ASTNode*, int&);
+};
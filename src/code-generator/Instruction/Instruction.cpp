@@ -0,0 +1,240 @@
+#include "Instruction.hpp"
+
+using namespace std;
+
+// indexed by the opcode
+const char* const OPCODE_NAMES[] = {
+    "MOV", "XCHG", "PUSH", "POP", "LEA", "ADD", "SUB", "MUL", "IMUL", "DIV", "IDIV", "NEG", "INC", "DEC", "AND",
+    "OR", "SHL", "SHR", "CMP", "TEST", "SETE", "SETNE", "SETL", "SETLE", "SETG", "SETGE", "CLD", "REP STOSW",
+    "REP MOVSB", "JMP", "JE", "JNE", "JL", "JLE", "JG", "JGE", "JNS", "LOOP", "CALL", "RET", "INT"
+};
+
+// indexed by the register
+const char* const REGISTER_NAMES[] = {
+    "AX", "BX", "CX", "DX", "SI", "DI", "BP", "SP", "DS", "ES", "SS", "AL", "BL", "CL", "DL", "AH"
+};
+
+// indexed by the label
+const char* const LABEL_NAMES[] = {
+    "FOR_LOOP_CND_", "FOR_LOOP_BODY_", "WHILE_LOOP_CND_", "WHILE_LOOP_BODY_", "ELSE_BODY_", "IF_ELSE_END_",
+    "FUNC_ENTRY_", "CMP_FALSE_", "SHORT_CIRC_", "SHORT_CIRC_END_", "PRINT_DIGIT_LOOP", "PRINT_LINE", "OUTPUT_HAS_ROOM"
+};
+
+/**
+ * @brief Signed conditional jumps, with the jump on the opposite condition and the instruction that sets a
+ * byte on the same condition.
+ */
+struct CondJumpInfo {
+    Opcode jump;
+    Opcode inverse;
+    Opcode set;
+};
+
+const CondJumpInfo COND_JUMPS[] = {
+    {Opcode::JE, Opcode::JNE, Opcode::SETE}, {Opcode::JNE, Opcode::JE, Opcode::SETNE},
+    {Opcode::JL, Opcode::JGE, Opcode::SETL}, {Opcode::JLE, Opcode::JG, Opcode::SETLE},
+    {Opcode::JG, Opcode::JLE, Opcode::SETG}, {Opcode::JGE, Opcode::JL, Opcode::SETGE}
+};
+
+static const CondJumpInfo* find_cond_jump(Opcode opcode) {
+    for (const CondJumpInfo& info : COND_JUMPS) {
+        if (info.jump == opcode) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Whether the low byte of the register can be addressed on its own, as for SETcc.
+ */
+bool has_low_byte(Register reg) {
+    return reg == Register::AX || reg == Register::BX || reg == Register::CX || reg == Register::DX;
+}
+
+Register get_low_byte(Register reg) {
+    switch (reg) {
+        case Register::BX:
+            return Register::BL;
+        case Register::CX:
+            return Register::CL;
+        case Register::DX:
+            return Register::DL;
+        default:
+            return Register::AL;
+    }
+}
+
+bool is_cond_jump(Opcode opcode) {
+    return find_cond_jump(opcode) != nullptr;
+}
+
+/**
+ * @brief Jump taken when the conditional jump is not, e.g. JGE for JL.
+ */
+Opcode get_inverse_cond_jump(Opcode opcode) {
+    return find_cond_jump(opcode)->inverse;
+}
+
+/**
+ * @brief SETcc on the condition of the conditional jump, e.g. SETL for JL.
+ */
+Opcode get_set_of_cond_jump(Opcode opcode) {
+    return find_cond_jump(opcode)->set;
+}
+
+Operand Operand::none() {
+    return Operand{OperandKind::None, Register::AX, ImmediateFormat::Decimal, FOR_LOOP_CONDITION, false, 0, 0};
+}
+
+Operand Operand::reg_of(Register reg) {
+    Operand operand = Operand::none();
+    operand.kind = OperandKind::Register;
+    operand.reg = reg;
+    return operand;
+}
+
+Operand Operand::imm(int value, ImmediateFormat format) {
+    Operand operand = Operand::none();
+    operand.kind = OperandKind::Immediate;
+    operand.format = format;
+    operand.value = value;
+    return operand;
+}
+
+/**
+ * @brief Stack slot relative to BP.
+ *
+ * @param displacement Byte displacement from BP
+ * @param is_indexed Whether the word offset in SI is subtracted, for array elements
+ */
+Operand Operand::local(int displacement, bool is_indexed) {
+    Operand operand = Operand::none();
+    operand.kind = OperandKind::Local;
+    operand.is_indexed = is_indexed;
+    operand.value = displacement;
+    return operand;
+}
+
+/**
+ * @brief Named operand, a global variable, a procedure or a segment.
+ *
+ * @param symbol_id Handle of the name in the string interner
+ * @param is_indexed Whether the word offset in SI is added, for array elements
+ * @param displacement Byte offset of an array element at a constant index
+ */
+Operand Operand::symbol(int symbol_id, bool is_indexed, int displacement) {
+    Operand operand = Operand::none();
+    operand.kind = OperandKind::Symbol;
+    operand.is_indexed = is_indexed;
+    operand.value = symbol_id;
+    operand.displacement = displacement;
+    return operand;
+}
+
+Operand Operand::label_of(Label label, int label_id) {
+    Operand operand = Operand::none();
+    operand.kind = OperandKind::Label;
+    operand.label = label;
+    operand.value = label_id;
+    return operand;
+}
+
+/**
+ * @brief Operands are equal when they print the same.
+ */
+bool Operand::operator==(const Operand& other) const {
+    if (this->kind != other.kind) {
+        return false;
+    }
+    switch (this->kind) {
+        case OperandKind::None:
+            return true;
+        case OperandKind::Register:
+            return this->reg == other.reg;
+        case OperandKind::Immediate:
+            return this->format == other.format && this->value == other.value;
+        case OperandKind::Local:
+            return this->is_indexed == other.is_indexed && this->value == other.value;
+        case OperandKind::Symbol:
+            return this->is_indexed == other.is_indexed && this->value == other.value &&
+                this->displacement == other.displacement;
+        case OperandKind::Label:
+            return this->label == other.label && this->value == other.value;
+    }
+    return false;
+}
+
+bool Operand::operator!=(const Operand& other) const {
+    return !(*this == other);
+}
+
+/**
+ * @brief Appends the operand in MASM syntax, symbols spelt from their handles in the string interner.
+ */
+void Operand::print(string& out, StringInterner& string_interner) const {
+    switch (this->kind) {
+        case OperandKind::None:
+            break;
+        case OperandKind::Register:
+            out += REGISTER_NAMES[(int)this->reg];
+            break;
+        case OperandKind::Immediate:
+            if (this->format == ImmediateFormat::Hex) {
+                static const char HEX_DIGITS[] = "0123456789ABCDEF";
+                string digits;
+                for (unsigned int value = this->value; value != 0 || digits.empty(); value /= 16) {
+                    digits.insert(digits.begin(), HEX_DIGITS[value % 16]);
+                }
+                // a leading letter would be read as a name
+                out += (digits[0] > '9' ? "0" : "") + digits + "H";
+            } else if (this->format == ImmediateFormat::Char) {
+                out += '\'';
+                out += (char)this->value;
+                out += '\'';
+            } else {
+                out += to_string(this->value);
+            }
+            break;
+        case OperandKind::Local:
+            out += "[BP+" + to_string(this->value);
+            if (this->is_indexed) {
+                out += "-SI";
+            }
+            out += "]";
+            break;
+        case OperandKind::Symbol:
+            out += string_interner.get_string(this->value);
+            if (this->is_indexed) {
+                out += "[SI";
+                if (this->displacement != 0) {
+                    out += (this->displacement > 0 ? "+" : "") + to_string(this->displacement);
+                }
+                out += "]";
+            } else if (this->displacement != 0) {
+                out += "[" + to_string(this->displacement) + "]";
+            }
+            break;
+        case OperandKind::Label:
+            out += LABEL_NAMES[this->label];
+            if (this->value >= 0) {
+                out += to_string(this->value);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Appends the instruction in MASM syntax, without indentation or newline.
+ */
+void Instruction::print(string& out, StringInterner& string_interner) const {
+    out += OPCODE_NAMES[(int)this->opcode];
+    if (this->dst.kind != OperandKind::None) {
+        out += ' ';
+        this->dst.print(out, string_interner);
+    }
+    if (this->src.kind != OperandKind::None) {
+        out += ", ";
+        this->src.print(out, string_interner);
+    }
+}
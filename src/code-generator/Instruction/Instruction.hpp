@@ -0,0 +1,79 @@
+#pragma once
+#include <string>
+#include "../../symbol-table/StringInterner/StringInterner.hpp"
+
+using namespace std;
+
+enum class Opcode : unsigned char {
+    MOV, XCHG, PUSH, POP, LEA, ADD, SUB, MUL, IMUL, DIV, IDIV, NEG, INC, DEC, AND, OR, SHL, SHR, CMP, TEST,
+    SETE, SETNE, SETL, SETLE, SETG, SETGE, CLD, REP_STOSW, REP_MOVSB,
+    JMP, JE, JNE, JL, JLE, JG, JGE, JNS, LOOP, CALL, RET, INT
+};
+
+enum class Register : unsigned char {
+    AX, BX, CX, DX, SI, DI, BP, SP, DS, ES, SS, AL, BL, CL, DL, AH
+};
+
+bool has_low_byte(Register);
+Register get_low_byte(Register);
+
+bool is_cond_jump(Opcode);
+Opcode get_inverse_cond_jump(Opcode);
+Opcode get_set_of_cond_jump(Opcode);
+
+/**
+ * @brief Kinds of jump targets. Labels of statements are numbered, labels of the print procedure are not.
+ */
+enum Label {
+    FOR_LOOP_CONDITION, FOR_LOOP_BODY, WHILE_LOOP_CONDITION, WHILE_LOOP_BODY, ELSE_BODY, IF_ELSE_END, FUNC_ENTRY,
+    CMP_FALSE, SHORT_CIRC, SHORT_CIRC_END, PRINT_DIGIT_LOOP, PRINT_LINE, OUTPUT_HAS_ROOM
+};
+
+enum class OperandKind : unsigned char {
+    None, Register, Immediate, Local, Symbol, Label
+};
+
+enum class ImmediateFormat : unsigned char {
+    Decimal, Hex, Char
+};
+
+/**
+ * @brief Operand of an instruction. Depending on the kind, value is:
+ *  Immediate: the constant, printed in its format
+ *  Local: displacement from BP of a stack slot, [BP+value], or [BP+value-SI] when indexed
+ *  Symbol: interned name of a global variable, procedure or segment, name[SI] when indexed, or
+ *      name[displacement] for an array element at a constant offset
+ *  Label: number of the label, -1 if it is not numbered
+ */
+struct Operand {
+    OperandKind kind;
+    Register reg;
+    ImmediateFormat format;
+    Label label;
+    bool is_indexed;
+    int value;
+    int displacement;
+
+    static Operand none();
+    static Operand reg_of(Register);
+    static Operand imm(int, ImmediateFormat = ImmediateFormat::Decimal);
+    static Operand local(int, bool = false);
+    static Operand symbol(int, bool = false, int = 0);
+    static Operand label_of(Label, int = -1);
+
+    bool operator==(const Operand&) const;
+    bool operator!=(const Operand&) const;
+
+    void print(string&, StringInterner&) const;
+};
+
+/**
+ * @brief An x86 instruction with up to two operands, destination first as in MASM.
+ */
+struct Instruction {
+    Opcode opcode;
+    Operand dst;
+    Operand src;
+
+    void print(string&, StringInterner&) const;
+};
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include "LoopAnalyzer.hpp"
+#include "../RegisterAllocator/RegisterAllocator.hpp"
+
+using namespace std;
+
+/**
+ * @param loop_ptr ForStatement or WhileStatement node
+ * @param constant_evaluator Values of the locals known at the loop entry
+ */
+LoopAnalyzer::LoopAnalyzer(ASTNode* loop_ptr, const ConstantEvaluator& constant_evaluator)
+    : constant_evaluator(constant_evaluator), has_call{ false }, index_offset{ 0 }, register_need{ 0 } {
+    vector<ASTNode*> loop_parts;
+    if (loop_ptr->get_kind() == NodeKind::ForStatement) {
+        this->collect_assignments(loop_ptr->get_child(1), false);
+        // the step is a statement of its own
+        this->collect_assignments(loop_ptr->get_child(2), true);
+        this->collect_assignments(loop_ptr->get_child(3), false);
+        loop_parts = {loop_ptr->get_child(1), loop_ptr->get_child(2), loop_ptr->get_child(3)};
+    } else {
+        this->collect_assignments(loop_ptr, false);
+        loop_parts = {loop_ptr};
+    }
+
+    this->find_index_variable();
+
+    if (!this->has_call) {
+        vector<ASTNode*> invariant_exprs;
+        for (ASTNode* part_ptr : loop_parts) {
+            this->collect_invariants(part_ptr, invariant_exprs);
+        }
+        this->find_hoisted_expressions(invariant_exprs);
+        for (ASTNode* part_ptr : loop_parts) {
+            this->count_register_need(part_ptr);
+        }
+    }
+}
+
+/**
+ * @param stack_offset Set to the stack offset of the index variable
+ * @return false if the loop has no index variable
+ */
+bool LoopAnalyzer::get_index_variable(int& stack_offset) const {
+    stack_offset = this->index_offset;
+    return this->index_offset != 0;
+}
+
+/**
+ * @brief Occurrences of the invariant expression to be hoisted, none if there is no such expression.
+ */
+const vector<ASTNode*>& LoopAnalyzer::get_hoisted_expressions() const {
+    return this->hoisted_exprs;
+}
+
+/**
+ * @brief Registers needed by the expressions of the loop to be evaluated without spilling, with the hoisted
+ * expression in a register.
+ */
+int LoopAnalyzer::get_register_need() const {
+    return this->register_need;
+}
+
+/**
+ * @brief Matches an array index of the form var, var + c, c + var or var - c, where var is a scalar local and
+ * c is constant.
+ *
+ * @param index_ptr Index expression node
+ * @param constant_evaluator Values of the known locals
+ * @param stack_offset Set to the stack offset of the variable
+ * @param displacement Set to the constant added to the variable
+ * @return false if the index is not of this form
+ */
+bool LoopAnalyzer::match_index(ASTNode* index_ptr, const ConstantEvaluator& constant_evaluator, int& stack_offset,
+    int& displacement) {
+    ASTNode* var_ptr = index_ptr;
+    displacement = 0;
+    if (index_ptr->get_kind() == NodeKind::AddExpression) {
+        bool is_plus = constant_evaluator.get_string_interner().get_string(index_ptr->get_name_id()) == "+";
+        if (constant_evaluator.evaluate(index_ptr->get_child(1), displacement)) {
+            var_ptr = index_ptr->get_child(0);
+            displacement = is_plus ? displacement : -displacement;
+        } else if (is_plus && constant_evaluator.evaluate(index_ptr->get_child(0), displacement)) {
+            var_ptr = index_ptr->get_child(1);
+        } else {
+            return false;
+        }
+    }
+
+    if (var_ptr->get_kind() != NodeKind::Variable || var_ptr->get_num_children() > 0 ||
+        !var_ptr->get_codegen_info_ptr()->is_local()) {
+        return false;
+    }
+    stack_offset = var_ptr->get_codegen_info_ptr()->get_stack_offset();
+    return true;
+}
+
+/**
+ * @brief Collects the variables assigned in a part of the loop, the calls, and the array elements whose index
+ * is not constant.
+ *
+ * @param node_ptr Node of the loop
+ * @param is_statement Whether the node is the expression of a statement
+ */
+void LoopAnalyzer::collect_assignments(ASTNode* node_ptr, bool is_statement) {
+    switch (node_ptr->get_kind()) {
+        case NodeKind::ExpressionStatement:
+            for (ASTNode* child_ptr : node_ptr->get_children()) {
+                this->collect_assignments(child_ptr, true);
+            }
+            return;
+        case NodeKind::Assignment:
+        case NodeKind::PostIncrement:
+        case NodeKind::PostDecrement: {
+            ASTNode* var_ptr = node_ptr->get_child(0);
+            CodeGenInfo* var_cgi_ptr = var_ptr->get_codegen_info_ptr();
+            if (var_ptr->get_num_children() > 0) {
+                break;
+            }
+            if (!var_cgi_ptr->is_local()) {
+                this->assigned_global_ids.insert(var_ptr->get_name_id());
+            } else {
+                this->assigned_offsets.insert(var_cgi_ptr->get_stack_offset());
+                if (!is_statement) {
+                    this->nested_assigned_offsets.insert(var_cgi_ptr->get_stack_offset());
+                }
+            }
+            break;
+        }
+        case NodeKind::Call:
+            this->has_call = true;
+            break;
+        case NodeKind::Variable: {
+            int index;
+            if (node_ptr->get_num_children() > 0 &&
+                !this->constant_evaluator.evaluate(node_ptr->get_child(0), index)) {
+                this->evaluated_indices.push_back(node_ptr->get_child(0));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->collect_assignments(child_ptr, false);
+    }
+}
+
+/**
+ * @brief The index variable is the variable of every index that is not constant. It is changed by statements
+ * of their own only, and the loop makes no calls.
+ */
+void LoopAnalyzer::find_index_variable() {
+    if (this->has_call || this->evaluated_indices.empty()) {
+        return;
+    }
+
+    int var_offset = 0;
+    for (ASTNode* index_ptr : this->evaluated_indices) {
+        int stack_offset, displacement;
+        if (!LoopAnalyzer::match_index(index_ptr, this->constant_evaluator, stack_offset, displacement) ||
+            (var_offset != 0 && stack_offset != var_offset)) {
+            return;
+        }
+        var_offset = stack_offset;
+    }
+    if (this->nested_assigned_offsets.count(var_offset) == 0) {
+        this->index_offset = var_offset;
+    }
+}
+
+/**
+ * @brief Collects the largest invariant expressions of a part of the loop that are not constant. Indices
+ * addressed through the index variable are not evaluated, they are skipped.
+ */
+void LoopAnalyzer::collect_invariants(ASTNode* node_ptr, vector<ASTNode*>& invariant_exprs) const {
+    int stack_offset, value;
+    NodeKind kind = node_ptr->get_kind();
+    if (kind == NodeKind::Variable && node_ptr->get_num_children() > 0 && this->index_offset != 0 &&
+        LoopAnalyzer::match_index(node_ptr->get_child(0), this->constant_evaluator, stack_offset, value) &&
+        stack_offset == this->index_offset) {
+        return;
+    }
+    if ((kind == NodeKind::AddExpression || kind == NodeKind::MulExpression || kind == NodeKind::UnaryExpression) &&
+        this->is_invariant(node_ptr) && !this->constant_evaluator.evaluate(node_ptr, value)) {
+        invariant_exprs.push_back(node_ptr);
+        return;
+    }
+
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->collect_invariants(child_ptr, invariant_exprs);
+    }
+}
+
+/**
+ * @brief Picks the invariant expression whose occurrences have the most operators in total.
+ */
+void LoopAnalyzer::find_hoisted_expressions(const vector<ASTNode*>& invariant_exprs) {
+    ASTNode* best_expr_ptr = nullptr;
+    int best_operator_count = 0;
+    for (ASTNode* expr_ptr : invariant_exprs) {
+        int occurrence_count = count_if(invariant_exprs.begin(), invariant_exprs.end(),
+            [expr_ptr](ASTNode* other_ptr) { return LoopAnalyzer::is_same_expression(expr_ptr, other_ptr); });
+        int operator_count = occurrence_count * LoopAnalyzer::count_operators(expr_ptr);
+        if (operator_count > best_operator_count) {
+            best_expr_ptr = expr_ptr;
+            best_operator_count = operator_count;
+        }
+    }
+
+    for (ASTNode* expr_ptr : invariant_exprs) {
+        if (best_expr_ptr != nullptr && LoopAnalyzer::is_same_expression(best_expr_ptr, expr_ptr)) {
+            this->hoisted_exprs.push_back(expr_ptr);
+        }
+    }
+}
+
+bool LoopAnalyzer::is_invariant(ASTNode* expr_ptr) const {
+    switch (expr_ptr->get_kind()) {
+        case NodeKind::ConstInt:
+            return true;
+        case NodeKind::Variable: {
+            CodeGenInfo* var_cgi_ptr = expr_ptr->get_codegen_info_ptr();
+            if (expr_ptr->get_num_children() > 0) {
+                return false;
+            }
+            return var_cgi_ptr->is_local() ? this->assigned_offsets.count(var_cgi_ptr->get_stack_offset()) == 0 :
+                !this->has_call && this->assigned_global_ids.count(expr_ptr->get_name_id()) == 0;
+        }
+        case NodeKind::MulExpression:
+            if (this->constant_evaluator.get_string_interner().get_string(expr_ptr->get_name_id()) != "*") {
+                return false;
+            }
+            return this->is_invariant(expr_ptr->get_child(0)) && this->is_invariant(expr_ptr->get_child(1));
+        case NodeKind::AddExpression:
+            return this->is_invariant(expr_ptr->get_child(0)) && this->is_invariant(expr_ptr->get_child(1));
+        case NodeKind::UnaryExpression:
+            return this->is_invariant(expr_ptr->get_child(0));
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Keeps the most registers needed by an expression of a part of the loop.
+ */
+void LoopAnalyzer::count_register_need(ASTNode* node_ptr) {
+    switch (node_ptr->get_kind()) {
+        case NodeKind::VarDeclaration:
+            return;
+        case NodeKind::CompoundStatement:
+        case NodeKind::ExpressionStatement:
+        case NodeKind::ForStatement:
+        case NodeKind::IfStatement:
+        case NodeKind::WhileStatement:
+        case NodeKind::PrintlnStatement:
+        case NodeKind::ReturnStatement:
+            for (ASTNode* child_ptr : node_ptr->get_children()) {
+                this->count_register_need(child_ptr);
+            }
+            return;
+        default:
+            this->register_need = max(this->register_need, this->count_registers(node_ptr));
+            return;
+    }
+}
+
+/**
+ * @brief Registers needed to evaluate an expression without spilling. The right operand of a binary operator is
+ * evaluated while the left one holds a register, unless it is a constant or a variable, and multiplication
+ * also takes AX and DX.
+ */
+int LoopAnalyzer::count_registers(ASTNode* expr_ptr) const {
+    int value;
+    if (this->constant_evaluator.evaluate(expr_ptr, value) ||
+        find(this->hoisted_exprs.begin(), this->hoisted_exprs.end(), expr_ptr) != this->hoisted_exprs.end()) {
+        return 1;
+    }
+
+    switch (expr_ptr->get_kind()) {
+        case NodeKind::Variable:
+            return expr_ptr->get_num_children() > 0 ? max(1, this->count_registers(expr_ptr->get_child(0))) : 1;
+        case NodeKind::Assignment:
+        case NodeKind::LogicExpression:
+        case NodeKind::RelExpression:
+        case NodeKind::AddExpression:
+        case NodeKind::MulExpression: {
+            ASTNode* right_ptr = expr_ptr->get_child(1);
+            bool is_right_simple = this->constant_evaluator.evaluate(right_ptr, value) ||
+                (right_ptr->get_kind() == NodeKind::Variable && right_ptr->get_num_children() == 0);
+            int need = max(this->count_registers(expr_ptr->get_child(0)),
+                is_right_simple ? 1 : this->count_registers(right_ptr) + 1);
+            return expr_ptr->get_kind() == NodeKind::MulExpression && !is_right_simple ? max(need, 3) : need;
+        }
+        case NodeKind::UnaryExpression:
+        case NodeKind::NotExpression:
+            return this->count_registers(expr_ptr->get_child(0));
+        case NodeKind::Call:
+            return POOL_SIZE;
+        default:
+            return 2;
+    }
+}
+
+/**
+ * @return Whether two expressions are the same operators on the same constants and variables
+ */
+bool LoopAnalyzer::is_same_expression(ASTNode* expr_ptr, ASTNode* other_ptr) {
+    if (expr_ptr->get_kind() != other_ptr->get_kind() || expr_ptr->get_name_id() != other_ptr->get_name_id() ||
+        expr_ptr->get_num_children() != other_ptr->get_num_children()) {
+        return false;
+    }
+    if (expr_ptr->get_kind() == NodeKind::Variable) {
+        // a local can shadow a global or another local of the same name
+        CodeGenInfo* var_cgi_ptr = expr_ptr->get_codegen_info_ptr();
+        CodeGenInfo* other_cgi_ptr = other_ptr->get_codegen_info_ptr();
+        if (var_cgi_ptr->is_local() != other_cgi_ptr->is_local() ||
+            (var_cgi_ptr->is_local() && var_cgi_ptr->get_stack_offset() != other_cgi_ptr->get_stack_offset())) {
+            return false;
+        }
+    }
+    for (int i = 0; i < expr_ptr->get_num_children(); i++) {
+        if (!LoopAnalyzer::is_same_expression(expr_ptr->get_child(i), other_ptr->get_child(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int LoopAnalyzer::count_operators(ASTNode* expr_ptr) {
+    int operator_count = expr_ptr->get_kind() == NodeKind::Variable || expr_ptr->get_kind() == NodeKind::ConstInt ?
+        0 : 1;
+    for (ASTNode* child_ptr : expr_ptr->get_children()) {
+        operator_count += LoopAnalyzer::count_operators(child_ptr);
+    }
+    return operator_count;
+}
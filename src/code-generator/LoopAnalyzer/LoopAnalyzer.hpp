@@ -0,0 +1,70 @@
+#pragma once
+#include <set>
+#include <vector>
+#include "../../ast/include.hpp"
+#include "../ConstantEvaluator/ConstantEvaluator.hpp"
+
+using namespace std;
+
+/**
+ * @brief Analysis of a for or while loop at its entry, before its code is generated. The loop is its
+ * condition, body and step, without the initialization of a for.
+ *
+ * Finds the index variable, a scalar local that indexes every array element of the loop whose index is not
+ * constant, plus a constant at most. Its doubled value can be kept in SI for the whole loop, so the elements
+ * are addressed without computing their offset. The variable may only be changed by statements of their own,
+ * so SI is updated before any element is addressed again, and the loop may not call functions, that use SI.
+ *
+ * Also finds the loop invariant arithmetic expression that saves the most operators if it is evaluated once
+ * at the entry, with all of its occurrences, and counts the registers the expressions of the loop need once
+ * it is hoisted. Its scalar locals are not assigned in the loop, nor are its globals, which also requires the
+ * loop to make no calls. Division is left in place, it can fault in a loop that never runs it.
+ *
+ * Constants are folded with the values of the locals known at the loop entry.
+ */
+class LoopAnalyzer {
+    const ConstantEvaluator& constant_evaluator;
+
+    // scalar locals assigned in the loop, also those assigned inside a larger expression, keyed on stack offset
+    set<int> assigned_offsets;
+    set<int> nested_assigned_offsets;
+    set<int> assigned_global_ids;
+    bool has_call;
+    // index expressions of the elements whose index is not constant
+    vector<ASTNode*> evaluated_indices;
+
+    // stack offset of the index variable, 0 if there is none
+    int index_offset;
+    vector<ASTNode*> hoisted_exprs;
+    int register_need;
+
+public:
+    LoopAnalyzer(ASTNode*, const ConstantEvaluator&);
+
+    bool get_index_variable(int&) const;
+
+    const vector<ASTNode*>& get_hoisted_expressions() const;
+
+    int get_register_need() const;
+
+    static bool match_index(ASTNode*, const ConstantEvaluator&, int&, int&);
+
+private:
+    void collect_assignments(ASTNode*, bool);
+
+    void find_index_variable();
+
+    void collect_invariants(ASTNode*, vector<ASTNode*>&) const;
+
+    void find_hoisted_expressions(const vector<ASTNode*>&);
+
+    bool is_invariant(ASTNode*) const;
+
+    void count_register_need(ASTNode*);
+
+    int count_registers(ASTNode*) const;
+
+    static bool is_same_expression(ASTNode*, ASTNode*);
+
+    static int count_operators(ASTNode*);
+};
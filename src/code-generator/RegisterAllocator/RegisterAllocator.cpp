@@ -0,0 +1,169 @@
+#include <algorithm>
+#include "RegisterAllocator.hpp"
+
+using namespace std;
+
+RegisterAllocator::RegisterAllocator()
+    : states{}, bound_variable_count{ 0 } {
+    this->reset();
+}
+
+/**
+ * @brief Frees every register of the pool and unbinds the variables, for a new function.
+ */
+void RegisterAllocator::reset() {
+    for (int i = 0; i < POOL_SIZE; i++) {
+        this->states[i] = RegisterState{POOL_REGISTERS[i], RegisterUse::Free, 0};
+    }
+    this->bound_variable_count = 0;
+}
+
+/**
+ * @brief Binds a variable to the next free variable register.
+ *
+ * @param stack_offset Stack offset of the variable
+ * @return false if all variable registers are bound
+ */
+bool RegisterAllocator::bind_variable(int stack_offset) {
+    if (this->bound_variable_count == sizeof(VARIABLE_REGISTERS) / sizeof(VARIABLE_REGISTERS[0])) {
+        return false;
+    }
+
+    RegisterState& state = this->get_state_ref(VARIABLE_REGISTERS[this->bound_variable_count++]);
+    state.use = RegisterUse::Variable;
+    state.stack_offset = stack_offset;
+    return true;
+}
+
+/**
+ * @param stack_offset Stack offset of the variable
+ * @param reg Set to the register the variable is bound to
+ * @return false if the variable is not bound to a register
+ */
+bool RegisterAllocator::find_variable(int stack_offset, Register& reg) const {
+    for (const RegisterState& state : this->states) {
+        if (state.use == RegisterUse::Variable && state.stack_offset == stack_offset) {
+            reg = state.reg;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @return Whether an invariant register is free
+ */
+bool RegisterAllocator::can_bind_invariant() const {
+    for (Register reg : INVARIANT_REGISTERS) {
+        if (this->is_free(reg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Binds a loop invariant to a register that holds its value, until it is unbound at the loop exit.
+ */
+void RegisterAllocator::bind_invariant(Register reg) {
+    this->get_state_ref(reg).use = RegisterUse::Invariant;
+}
+
+void RegisterAllocator::unbind_invariant(Register reg) {
+    this->get_state_ref(reg).use = RegisterUse::Free;
+}
+
+/**
+ * @brief Allocates the first free register of the pool. The code generator keeps a register free whenever
+ * it evaluates an expression, so there always is one.
+ */
+Register RegisterAllocator::allocate() {
+    Register reg = Register::AX;
+    this->try_allocate(reg);
+    return reg;
+}
+
+/**
+ * @param reg Set to the allocated register
+ * @param excluded Registers that must not be allocated
+ * @return false if no register is free
+ */
+bool RegisterAllocator::try_allocate(Register& reg, const vector<Register>& excluded) {
+    for (RegisterState& state : this->states) {
+        if (state.use == RegisterUse::Free && find(excluded.begin(), excluded.end(), state.reg) == excluded.end()) {
+            state.use = RegisterUse::Temp;
+            reg = state.reg;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Allocates a specific free register, e.g. AX for the result of a call.
+ */
+void RegisterAllocator::claim(Register reg) {
+    this->get_state_ref(reg).use = RegisterUse::Temp;
+}
+
+/**
+ * @brief Frees a temporary. Registers bound to variables or invariants are kept.
+ */
+void RegisterAllocator::release(Register reg) {
+    RegisterState& state = this->get_state_ref(reg);
+    if (state.use == RegisterUse::Temp) {
+        state.use = RegisterUse::Free;
+    }
+}
+
+bool RegisterAllocator::is_free(Register reg) const {
+    return this->get_state(reg).use == RegisterUse::Free;
+}
+
+bool RegisterAllocator::is_temp(Register reg) const {
+    return this->get_state(reg).use == RegisterUse::Temp;
+}
+
+int RegisterAllocator::get_free_count() const {
+    return count_if(begin(this->states), end(this->states), [](const RegisterState& state) {
+        return state.use == RegisterUse::Free;
+    });
+}
+
+RegisterState RegisterAllocator::get_state(Register reg) const {
+    for (const RegisterState& state : this->states) {
+        if (state.reg == reg) {
+            return state;
+        }
+    }
+    return RegisterState{reg, RegisterUse::Free, 0};
+}
+
+/**
+ * @brief Puts a register back in the state it was saved in.
+ */
+void RegisterAllocator::set_state(const RegisterState& state) {
+    this->get_state_ref(state.reg) = state;
+}
+
+/**
+ * @brief Registers holding a temporary, a variable or an invariant, in pool order.
+ */
+vector<Register> RegisterAllocator::get_used_registers() const {
+    vector<Register> used_registers;
+    for (const RegisterState& state : this->states) {
+        if (state.use != RegisterUse::Free) {
+            used_registers.push_back(state.reg);
+        }
+    }
+    return used_registers;
+}
+
+RegisterState& RegisterAllocator::get_state_ref(Register reg) {
+    for (RegisterState& state : this->states) {
+        if (state.reg == reg) {
+            return state;
+        }
+    }
+    return this->states[0];
+}
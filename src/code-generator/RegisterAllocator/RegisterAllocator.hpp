@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include "../Instruction/Instruction.hpp"
+
+using namespace std;
+
+enum class RegisterUse : unsigned char {
+    Free, Temp, Variable, Invariant
+};
+
+/**
+ * @brief Use of a register of the pool. A register bound to a variable holds the variable of that stack
+ * offset for the whole function. A register bound to an invariant holds the value of a loop invariant
+ * expression for the whole loop.
+ */
+struct RegisterState {
+    Register reg;
+    RegisterUse use;
+    int stack_offset;
+};
+
+const int POOL_SIZE = 5;
+// general purpose registers, in the order temporaries are allocated. SI is kept for array indexing, BP and SP
+// for the stack frame.
+const Register POOL_REGISTERS[POOL_SIZE] = {Register::AX, Register::BX, Register::CX, Register::DX, Register::DI};
+// registers hot variables are bound to, in order. AX and DX are left to multiplication and division.
+const Register VARIABLE_REGISTERS[] = {Register::DI, Register::CX};
+// registers loop invariants can be bound to, the ones multiplication and division leave alone
+const Register INVARIANT_REGISTERS[] = {Register::BX, Register::CX, Register::DI};
+
+/**
+ * @brief Register pool of the code generator. Values of expressions are kept in temporaries allocated from
+ * the pool, and released as soon as they are consumed. The most used scalar variables of a function can be
+ * bound to registers of the pool, so they are never loaded from or stored to the stack. Whoever needs a
+ * register that is in use saves it on the stack and restores it afterwards, with its state.
+ */
+class RegisterAllocator {
+    RegisterState states[POOL_SIZE];
+    int bound_variable_count;
+
+public:
+    RegisterAllocator();
+
+    void reset();
+
+    bool bind_variable(int);
+
+    bool find_variable(int, Register&) const;
+
+    bool can_bind_invariant() const;
+
+    void bind_invariant(Register);
+
+    void unbind_invariant(Register);
+
+    Register allocate();
+
+    bool try_allocate(Register&, const vector<Register>& = {});
+
+    void claim(Register);
+
+    void release(Register);
+
+    bool is_free(Register) const;
+
+    bool is_temp(Register) const;
+
+    int get_free_count() const;
+
+    RegisterState get_state(Register) const;
+
+    void set_state(const RegisterState&);
+
+    vector<Register> get_used_registers() const;
+
+private:
+    RegisterState& get_state_ref(Register);
+};
@@ -0,0 +1,9 @@
+#pragma once
+// headers
+#include "CodeGenerator/CodeGenerator.hpp"
+#include "AsmBuffer/AsmBuffer.hpp"
+#include "CodeCache/CodeCache.hpp"
+#include "Instruction/Instruction.hpp"
+#include "ConstantEvaluator/ConstantEvaluator.hpp"
+#include "LoopAnalyzer/LoopAnalyzer.hpp"
+#include "RegisterAllocator/RegisterAllocator.hpp"
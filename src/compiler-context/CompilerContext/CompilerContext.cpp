@@ -0,0 +1,10 @@
+#include "CompilerContext.hpp"
+
+using namespace std;
+
+CompilerContext::CompilerContext(const CompilerOptions& options)
+    : options(options), error_count{ 0 }, message_stream{ &cout }, failure_stream{ &cerr },
+    symbol_table(SYM_TABLE_BUCKETS, this->string_interner), current_func_sym_ptr{ nullptr }, current_stack_offset{ 0 },
+    ast_root{ nullptr }, line_count{ 1 }, pending_line_inc{ 0 }, scan_offset{ 0 }, lexing_time{}, matched_char{ 0 },
+    stats(options.is_time_passes_shown || options.is_stats_json_written) {
+}
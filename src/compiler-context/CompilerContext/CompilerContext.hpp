@@ -0,0 +1,100 @@
+#pragma once
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../symbol-table/include.hpp"
+#include "../../symbol-table/SignatureInterner/SignatureInterner.hpp"
+#include "../../ast/include.hpp"
+#include "../../source-buffer/include.hpp"
+#include "../../arena/include.hpp"
+#include "../CompilerStats/CompilerStats.hpp"
+
+using namespace std;
+
+const int SYM_TABLE_BUCKETS = 10;
+
+/**
+ * @brief Options of a compilation, set from the command line.
+ */
+struct CompilerOptions {
+    // output files
+    string code_file_name = "code.asm";
+    string optim_code_file_name = "optimized_code.asm";
+    // debug files written during Analysis, deleted once it is done
+    string log_file_name = "log.txt";
+    string error_file_name = "error.txt";
+    // whether the hits of the peephole rules are printed
+    bool is_peephole_stats_shown = false;
+    // whether the calls that are inlined are printed
+    bool is_inline_report_shown = false;
+    // whether functions are called with the fast calling convention
+    bool is_fast_call = false;
+    // whether printed lines are collected in a buffer and written together
+    bool is_output_buffered = false;
+    // batch mode: number of worker threads, and the directory of the outputs of each source, empty for the
+    // directory of the source
+    int job_count = 1;
+    string output_dir_name;
+    // directory of the code cache, empty for none, whether its hits are checked against a fresh compile, and
+    // whether its hits and misses are printed
+    string cache_dir_name;
+    bool is_cache_verified = false;
+    bool is_cache_stats_shown = false;
+    // whether the times of the phases and the counts of the work are printed, and written as JSON
+    bool is_time_passes_shown = false;
+    bool is_stats_shown = false;
+    bool is_stats_json_written = false;
+    string stats_file_name = "stats.json";
+};
+
+/**
+ * @brief All the state of the compilation of one source program: the options, the interners, the source,
+ * the debug files, the symbol table, the arena with the AST, the state the scanner and the parser keep
+ * between tokens, and the times and counts of the compilation. The scanner is reentrant and the parser is
+ * pure, both reach the compilation through its context, so separate contexts compile separate programs
+ * concurrently, each on its own thread.
+ *
+ * The symbol table, the AST and the code generator keep names as handles, and are given the string interner
+ * of the context to intern and print them.
+ */
+struct CompilerContext {
+    CompilerOptions options;
+    StringInterner string_interner;
+    SignatureInterner signature_interner;
+
+    // whole source program, scanned in place, tokens, AST nodes and log lines refer to it by spans
+    SourceBuffer source_buffer;
+    ofstream log_file, error_file;
+    int error_count;
+    // messages printed for the user, and failures of the compiler itself
+    ostream* message_stream;
+    ostream* failure_stream;
+
+    SymbolTable symbol_table;
+    SymbolInfo* current_func_sym_ptr;
+    vector<SymbolInfo*> params_for_func_scope;
+    // stack offset of the next local variable of the current function
+    int current_stack_offset;
+
+    // semantic values of the parser and the AST, released in bulk once code is generated
+    Arena arena;
+    // AST of the program, built during Analysis
+    ASTNode* ast_root;
+
+    // scanner counts, and the text of the literal or comment being matched
+    int line_count;
+    int pending_line_inc;
+    // byte offset of the next character to be scanned, gives each token its span in the source buffer
+    size_t scan_offset;
+    // time spent in the scanner, summed over the tokens when the phases are timed
+    chrono::steady_clock::duration lexing_time;
+    string matched_literal;
+    char matched_char;
+    string matched_str;
+    string matched_comment;
+
+    CompilerStats stats;
+
+    CompilerContext(const CompilerOptions&);
+};
@@ -0,0 +1,195 @@
+#include <iomanip>
+#include <sstream>
+#include "CompilerStats.hpp"
+
+using namespace std;
+
+/**
+ * @param is_timed Whether the phases are timed
+ */
+CompilerStats::CompilerStats(bool is_timed)
+    : is_timed(is_timed), token_count{ 0 }, symbol_table_stats{0, 0, 0, 0}, arena_allocation_count{ 0 },
+    arena_block_count{ 0 }, instruction_count{ 0 }, optimized_instruction_count{ 0 } {
+}
+
+/**
+ * @brief Starts timing a phase, inside the phases running. A phase that ran before adds to its earlier time.
+ *
+ * @param name Name of the phase
+ */
+void CompilerStats::start_phase(const string& name) {
+    if (!this->is_timed) {
+        return;
+    }
+
+    int phase_idx = 0;
+    while (phase_idx < this->phase_times.size() && this->phase_times[phase_idx].name != name) {
+        phase_idx++;
+    }
+    if (phase_idx == this->phase_times.size()) {
+        this->phase_times.push_back(PhaseTime{name, (int)this->running_phase_idxs.size(), 0, 0});
+    }
+    this->running_phase_idxs.push_back(phase_idx);
+    this->wall_starts.push_back(chrono::steady_clock::now());
+    this->cpu_starts.push_back(get_thread_cpu_ms());
+}
+
+/**
+ * @brief Stops timing the innermost phase running.
+ */
+void CompilerStats::stop_phase() {
+    if (!this->is_timed || this->running_phase_idxs.empty()) {
+        return;
+    }
+
+    PhaseTime& phase_time = this->phase_times[this->running_phase_idxs.back()];
+    chrono::steady_clock::duration wall_time = chrono::steady_clock::now() - this->wall_starts.back();
+    phase_time.wall_ms += chrono::duration<double, milli>(wall_time).count();
+    phase_time.cpu_ms += get_thread_cpu_ms() - this->cpu_starts.back();
+    this->running_phase_idxs.pop_back();
+    this->wall_starts.pop_back();
+    this->cpu_starts.pop_back();
+}
+
+/**
+ * @brief Adds the time of a phase that runs too often to be started and stopped each time, summed by the
+ * caller, inside the phases running. Only its wall time is taken, it is also counted as its CPU time.
+ *
+ * @param name Name of the phase
+ * @param wall_time Time the phase took
+ */
+void CompilerStats::add_phase_time(const string& name, chrono::steady_clock::duration wall_time) {
+    if (!this->is_timed) {
+        return;
+    }
+
+    int phase_idx = 0;
+    while (phase_idx < this->phase_times.size() && this->phase_times[phase_idx].name != name) {
+        phase_idx++;
+    }
+    if (phase_idx == this->phase_times.size()) {
+        this->phase_times.push_back(PhaseTime{name, (int)this->running_phase_idxs.size(), 0, 0});
+    }
+    double wall_ms = chrono::duration<double, milli>(wall_time).count();
+    this->phase_times[phase_idx].wall_ms += wall_ms;
+    this->phase_times[phase_idx].cpu_ms += wall_ms;
+}
+
+/**
+ * @brief Writes the wall and CPU time of each phase, nested phases indented under the ones they ran in.
+ */
+void CompilerStats::write_times(ostream& ostrm) const {
+    ostringstream report;
+    report << fixed << setprecision(2);
+    report << "Pass times: wall ms, CPU ms\n";
+    double total_wall_ms = 0, total_cpu_ms = 0;
+    for (const PhaseTime& phase_time : this->phase_times) {
+        report << string(phase_time.depth + 1, '\t') << phase_time.name << ": " << phase_time.wall_ms << ", " <<
+            phase_time.cpu_ms << "\n";
+        if (phase_time.depth == 0) {
+            total_wall_ms += phase_time.wall_ms;
+            total_cpu_ms += phase_time.cpu_ms;
+        }
+    }
+    report << "\tTotal: " << total_wall_ms << ", " << total_cpu_ms << "\n";
+    ostrm << report.str();
+}
+
+/**
+ * @brief Writes the counts of the work of the scanner, the symbol table, the arena, the code generator and the
+ * peephole optimizer.
+ */
+void CompilerStats::write_counts(ostream& ostrm) const {
+    ostringstream report;
+    report << fixed << setprecision(2);
+    report << "Statistics:\n";
+    report << "\tTokens: " << this->token_count << "\n";
+    report << "\tSymbols allocated: " << this->symbol_table_stats.allocation_count << "\n";
+    report << "\tScopes entered: " << this->symbol_table_stats.scope_count << "\n";
+    report << "\tSymbol table probes: " << this->symbol_table_stats.probe_count << ", " <<
+        this->get_average_probe_length() << " slots on average\n";
+    report << "\tArena allocations: " << this->arena_allocation_count << " in " << this->arena_block_count <<
+        " blocks\n";
+    report << "\tInstructions emitted: " << this->instruction_count << ", " << this->optimized_instruction_count <<
+        " after peephole optimization\n";
+    for (const RuleStats& rule_stats : this->rule_stats) {
+        report << "\t\t" << rule_stats.name << ": " << rule_stats.hit_count << " hits, " <<
+            rule_stats.removed_count << " instructions removed\n";
+    }
+    ostrm << report.str();
+}
+
+/**
+ * @brief Writes the times and the counts as a JSON object.
+ *
+ * @param source_file_name Source file of the compilation
+ */
+void CompilerStats::write_json(ostream& ostrm, const string& source_file_name) const {
+    ostringstream json;
+    json << fixed << setprecision(3);
+    json << "{\n";
+    json << "  \"source\": " << CompilerStats::to_json_string(source_file_name) << ",\n";
+    json << "  \"phases\": [";
+    for (int i = 0; i < this->phase_times.size(); i++) {
+        const PhaseTime& phase_time = this->phase_times[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << CompilerStats::to_json_string(phase_time.name) <<
+            ", \"depth\": " << phase_time.depth << ", \"wall_ms\": " << phase_time.wall_ms << ", \"cpu_ms\": " <<
+            phase_time.cpu_ms << "}";
+    }
+    json << (this->phase_times.empty() ? "],\n" : "\n  ],\n");
+    json << "  \"tokens\": " << this->token_count << ",\n";
+    json << "  \"symbol_allocations\": " << this->symbol_table_stats.allocation_count << ",\n";
+    json << "  \"scopes_entered\": " << this->symbol_table_stats.scope_count << ",\n";
+    json << "  \"symbol_table_probes\": " << this->symbol_table_stats.probe_count << ",\n";
+    json << "  \"average_probe_length\": " << this->get_average_probe_length() << ",\n";
+    json << "  \"arena_allocations\": " << this->arena_allocation_count << ",\n";
+    json << "  \"arena_blocks\": " << this->arena_block_count << ",\n";
+    json << "  \"instructions_emitted\": " << this->instruction_count << ",\n";
+    json << "  \"instructions_after_peephole\": " << this->optimized_instruction_count << ",\n";
+    json << "  \"peephole_rules\": [";
+    for (int i = 0; i < this->rule_stats.size(); i++) {
+        const RuleStats& rule_stats = this->rule_stats[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << CompilerStats::to_json_string(rule_stats.name) <<
+            ", \"hits\": " << rule_stats.hit_count << ", \"instructions_removed\": " << rule_stats.removed_count <<
+            "}";
+    }
+    json << (this->rule_stats.empty() ? "]\n" : "\n  ]\n");
+    json << "}\n";
+    ostrm << json.str();
+}
+
+/**
+ * @brief Average number of slots a probe of the symbol table looked at, 0 if there were no probes.
+ */
+double CompilerStats::get_average_probe_length() const {
+    const SymbolTableStats& stats = this->symbol_table_stats;
+    return stats.probe_count == 0 ? 0 : (double)stats.probed_slot_count / stats.probe_count;
+}
+
+/**
+ * @brief CPU time used by the calling thread so far, in milliseconds.
+ */
+double CompilerStats::get_thread_cpu_ms() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return 1000.0 * time.tv_sec + time.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief Quotes a string for JSON, escaping quotes, backslashes and control characters.
+ */
+string CompilerStats::to_json_string(const string& str) {
+    ostringstream json;
+    json << '"';
+    for (unsigned char ch : str) {
+        if (ch == '"' || ch == '\\') {
+            json << '\\' << ch;
+        } else if (ch < 0x20) {
+            json << "\\u" << hex << setw(4) << setfill('0') << (int)ch << dec;
+        } else {
+            json << ch;
+        }
+    }
+    json << '"';
+    return json.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include "../../symbol-table/include.hpp"
+
+using namespace std;
+
+/**
+ * @brief Time taken by a phase of the compilation, over all the times it ran. A phase that runs inside
+ * another one is nested one level deeper.
+ */
+struct PhaseTime {
+    string name;
+    int depth;
+    double wall_ms;
+    double cpu_ms;
+};
+
+/**
+ * @brief Hits of a peephole rule, and the instructions they removed.
+ */
+struct RuleStats {
+    string name;
+    int hit_count;
+    int removed_count;
+};
+
+/**
+ * @brief Times of the phases of a compilation, and counts of the work done in its hot paths. Phases are only
+ * timed when enabled, the counts are always kept.
+ *
+ * CPU time is the one of the thread that runs the phase, so it leaves out the work the phase waits for on
+ * worker threads, and in a batch compiled on several threads the time of the other programs.
+ */
+struct CompilerStats {
+    bool is_timed;
+    // phases in the order they first started
+    vector<PhaseTime> phase_times;
+    // phases running, innermost last, with the times they started
+    vector<int> running_phase_idxs;
+    vector<chrono::steady_clock::time_point> wall_starts;
+    vector<double> cpu_starts;
+
+    // tokens read by the parser, the end of input not included
+    unsigned long token_count;
+    SymbolTableStats symbol_table_stats;
+    // objects created in the arena of the compilation, and the blocks they took
+    unsigned long arena_allocation_count;
+    unsigned long arena_block_count;
+    // instructions written by the code generator, and left by the peephole optimizer
+    int instruction_count;
+    int optimized_instruction_count;
+    vector<RuleStats> rule_stats;
+
+    CompilerStats(bool);
+
+    void start_phase(const string&);
+
+    void stop_phase();
+
+    void add_phase_time(const string&, chrono::steady_clock::duration);
+
+    void write_times(ostream&) const;
+
+    void write_counts(ostream&) const;
+
+    void write_json(ostream&, const string&) const;
+
+private:
+    double get_average_probe_length() const;
+
+    static double get_thread_cpu_ms();
+
+    static string to_json_string(const string&);
+};
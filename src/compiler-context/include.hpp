@@ -0,0 +1,4 @@
+#pragma once
+// headers
+#include "CompilerContext/CompilerContext.hpp"
+#include "CompilerStats/CompilerStats.hpp"
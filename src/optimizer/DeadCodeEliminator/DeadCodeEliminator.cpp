@@ -0,0 +1,174 @@
+#include <algorithm>
+#include "DeadCodeEliminator.hpp"
+
+using namespace std;
+
+DeadCodeEliminator::DeadCodeEliminator(Arena& arena, StringInterner& string_interner)
+    : arena(arena), constant_evaluator(string_interner) {
+}
+
+/**
+ * @brief Removes the dead statements of every function, then the functions that are not reachable from
+ * main and the globals that no reachable function uses. Function declarations are kept, they have no code.
+ *
+ * @param program_ptr Root of the AST, its units are removed in place
+ */
+void DeadCodeEliminator::eliminate(ASTNode* program_ptr) {
+    unordered_map<int, ASTNode*> func_defs;
+    ASTNode* main_def_ptr = nullptr;
+    int main_id = this->constant_evaluator.get_string_interner().intern("main");
+    for (ASTNode* unit_ptr : program_ptr->get_children()) {
+        if (unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            this->prune_block(unit_ptr->get_child(unit_ptr->get_num_children() - 1));
+            func_defs[unit_ptr->get_name_id()] = unit_ptr;
+            main_def_ptr = unit_ptr->get_name_id() == main_id ? unit_ptr : main_def_ptr;
+        }
+    }
+
+    this->reachable_func_ids.clear();
+    this->used_global_ids.clear();
+    if (main_def_ptr != nullptr) {
+        this->reachable_func_ids.insert(main_def_ptr->get_name_id());
+        this->mark_reachable(main_def_ptr, func_defs);
+    }
+
+    vector<ASTNode*>& units = program_ptr->get_children();
+    vector<ASTNode*> live_units;
+    for (ASTNode* unit_ptr : units) {
+        if (unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            if (this->reachable_func_ids.count(unit_ptr->get_name_id()) > 0) {
+                live_units.push_back(unit_ptr);
+            }
+        } else if (unit_ptr->get_kind() == NodeKind::VarDeclaration) {
+            vector<ASTNode*>& declarators = unit_ptr->get_children();
+            auto unused_iter = remove_if(declarators.begin(), declarators.end(), [this](ASTNode* declarator_ptr) {
+                return this->used_global_ids.count(declarator_ptr->get_name_id()) == 0;
+            });
+            declarators.erase(unused_iter, declarators.end());
+            if (!declarators.empty()) {
+                live_units.push_back(unit_ptr);
+            }
+        } else {
+            live_units.push_back(unit_ptr);
+        }
+    }
+    units = live_units;
+}
+
+/**
+ * @brief Removes the dead code inside a statement. The statement itself is replaced if a constant
+ * condition decides it, e.g. an if by the branch that is taken.
+ *
+ * @param statement_ptr Statement, in the children of its parent
+ * @return false if control never reaches the end of the statement
+ */
+bool DeadCodeEliminator::prune_statement(ASTNode*& statement_ptr) {
+    bool condition;
+    switch (statement_ptr->get_kind()) {
+        case NodeKind::CompoundStatement:
+            return this->prune_block(statement_ptr);
+        case NodeKind::ReturnStatement:
+            return false;
+        case NodeKind::IfStatement: {
+            bool has_else = statement_ptr->get_num_children() == 3;
+            if (this->is_constant_condition(statement_ptr->get_child(0), condition)) {
+                if (!condition && !has_else) {
+                    statement_ptr = this->create_empty_statement(statement_ptr);
+                    return true;
+                }
+                statement_ptr = statement_ptr->get_child(condition ? 1 : 2);
+                return this->prune_statement(statement_ptr);
+            }
+            bool is_body_completed = this->prune_statement(statement_ptr->get_children()[1]);
+            return !has_else || this->prune_statement(statement_ptr->get_children()[2]) || is_body_completed;
+        }
+        case NodeKind::WhileStatement: {
+            bool is_constant = this->is_constant_condition(statement_ptr->get_child(0), condition);
+            if (is_constant && !condition) {
+                statement_ptr = this->create_empty_statement(statement_ptr);
+                return true;
+            }
+            this->prune_statement(statement_ptr->get_children()[1]);
+            // without break, a loop on a true condition never exits
+            return !(is_constant && condition);
+        }
+        case NodeKind::ForStatement: {
+            // a missing condition is always true
+            ASTNode* condition_stmt_ptr = statement_ptr->get_child(1);
+            bool is_constant = true;
+            condition = true;
+            if (condition_stmt_ptr->get_num_children() > 0) {
+                is_constant = this->is_constant_condition(condition_stmt_ptr->get_child(0), condition);
+            }
+            if (is_constant && !condition) {
+                // only the initialization runs
+                statement_ptr = statement_ptr->get_child(0);
+                return true;
+            }
+            this->prune_statement(statement_ptr->get_children()[3]);
+            return !(is_constant && condition);
+        }
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Removes the dead code inside the statements of a block, and the statements after one that does not
+ * complete.
+ *
+ * @return false if control never reaches the end of the block
+ */
+bool DeadCodeEliminator::prune_block(ASTNode* block_ptr) {
+    vector<ASTNode*>& statements = block_ptr->get_children();
+    for (size_t i = 0; i < statements.size(); i++) {
+        if (!this->prune_statement(statements[i])) {
+            statements.erase(statements.begin() + i + 1, statements.end());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @param cond_ptr Expression node of the condition
+ * @param condition Set to the truth value of the condition, if it is constant
+ * @return false if the condition is not constant
+ */
+bool DeadCodeEliminator::is_constant_condition(ASTNode* cond_ptr, bool& condition) const {
+    int value;
+    if (!this->constant_evaluator.evaluate(cond_ptr, value)) {
+        return false;
+    }
+    condition = value != 0;
+    return true;
+}
+
+/**
+ * @brief Marks the functions called inside a node as reachable, with the functions they call in turn, and
+ * the globals used inside the node and the reachable functions.
+ *
+ * @param node_ptr Node of a reachable function
+ * @param func_defs Function definitions, keyed on the name handle
+ */
+void DeadCodeEliminator::mark_reachable(ASTNode* node_ptr, const unordered_map<int, ASTNode*>& func_defs) {
+    if (node_ptr->get_kind() == NodeKind::Call) {
+        auto func_def_iter = func_defs.find(node_ptr->get_name_id());
+        if (func_def_iter != func_defs.end() && this->reachable_func_ids.insert(node_ptr->get_name_id()).second) {
+            this->mark_reachable(func_def_iter->second, func_defs);
+        }
+    } else if (node_ptr->get_kind() == NodeKind::Variable && !node_ptr->get_codegen_info_ptr()->is_local()) {
+        this->used_global_ids.insert(node_ptr->get_name_id());
+    }
+
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        this->mark_reachable(child_ptr, func_defs);
+    }
+}
+
+/**
+ * @brief Empty statement, in place of a statement that never runs.
+ */
+ASTNode* DeadCodeEliminator::create_empty_statement(ASTNode* statement_ptr) {
+    return this->arena.create<ASTNode>(NodeKind::CompoundStatement, statement_ptr->get_span(), SemanticType::Void);
+}
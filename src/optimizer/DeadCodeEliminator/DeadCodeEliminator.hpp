@@ -0,0 +1,44 @@
+#pragma once
+#include <unordered_map>
+#include <unordered_set>
+#include "../../arena/Arena/Arena.hpp"
+#include "../../ast/include.hpp"
+#include "../../code-generator/ConstantEvaluator/ConstantEvaluator.hpp"
+
+using namespace std;
+
+/**
+ * @brief Whole-program dead code elimination on the AST, before code generation. Statements that can never
+ * run are removed from every function: the rest of a block after a statement that does not complete, the
+ * branch of an if that a constant condition never takes, and loops whose condition is constant false. Then
+ * only the functions reachable from main through calls are kept, and only the globals that the kept
+ * functions use.
+ *
+ * A statement does not complete if it returns on every path, or is a loop whose condition is constant true,
+ * as the language has no break. Conditions are constant if they fold without the values of any variable.
+ */
+class DeadCodeEliminator {
+    Arena& arena;
+    // folds conditions, without known values of variables
+    ConstantEvaluator constant_evaluator;
+
+    // name handles of the functions reachable from main, and of the globals they use
+    unordered_set<int> reachable_func_ids;
+    unordered_set<int> used_global_ids;
+
+public:
+    DeadCodeEliminator(Arena&, StringInterner&);
+
+    void eliminate(ASTNode*);
+
+private:
+    bool prune_statement(ASTNode*&);
+
+    bool prune_block(ASTNode*);
+
+    bool is_constant_condition(ASTNode*, bool&) const;
+
+    void mark_reachable(ASTNode*, const unordered_map<int, ASTNode*>&);
+
+    ASTNode* create_empty_statement(ASTNode*);
+};
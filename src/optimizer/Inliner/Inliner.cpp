@@ -0,0 +1,614 @@
+#include "Inliner.hpp"
+
+using namespace std;
+
+Inliner::Inliner(Arena& arena, StringInterner& string_interner)
+    : arena(arena), string_interner(string_interner), caller_ptr(nullptr), target_ptr(nullptr), call_count{ 0 },
+    inlined_count{ 0 } {
+}
+
+/**
+ * @brief Inlines the calls inside every function definition.
+ *
+ * @param program_ptr Root of the AST, the statements of the calls are replaced in place
+ */
+void Inliner::inline_calls(ASTNode* program_ptr) {
+    this->func_defs.clear();
+    this->is_func_done.clear();
+    for (ASTNode* unit_ptr : program_ptr->get_children()) {
+        if (unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            this->func_defs[unit_ptr->get_name_id()] = unit_ptr;
+        }
+    }
+
+    for (ASTNode* unit_ptr : program_ptr->get_children()) {
+        if (unit_ptr->get_kind() == NodeKind::FuncDefinition) {
+            this->visit_func(unit_ptr);
+        }
+    }
+}
+
+/**
+ * @brief Writes the number of calls inlined, and the outcome of the calls of each callee in each caller.
+ */
+void Inliner::write_report(ostream& ostrm) const {
+    ostrm << "Inlining: " << this->inlined_count << " of " << this->call_count << " calls inlined\n";
+    for (const pair<string, string>& key : this->outcome_keys) {
+        ostrm << "\t" << key.first << ": " << key.second << " (" << this->outcome_counts.at(key) << ")\n";
+    }
+}
+
+/**
+ * @brief Inlines the calls inside a function, once the functions it calls are done. A callee that is being
+ * visited calls the function back, it is left as it is.
+ *
+ * @param func_def_ptr FuncDefinition node
+ */
+void Inliner::visit_func(ASTNode* func_def_ptr) {
+    int func_name_id = func_def_ptr->get_name_id();
+    if (this->is_func_done.count(func_name_id) > 0) {
+        return;
+    }
+    this->is_func_done[func_name_id] = false;
+
+    vector<int> callee_ids;
+    Inliner::collect_callees(Inliner::get_body(func_def_ptr), callee_ids);
+    for (int callee_id : callee_ids) {
+        auto func_def_iter = this->func_defs.find(callee_id);
+        if (func_def_iter != this->func_defs.end()) {
+            this->visit_func(func_def_iter->second);
+        }
+    }
+
+    this->caller_ptr = func_def_ptr;
+    this->inline_statement(func_def_ptr->get_children().back());
+    this->is_func_done[func_name_id] = true;
+}
+
+/**
+ * @brief Inlines the calls inside a statement. The statement is replaced by a block if it is a call whose
+ * value is dropped, assigned or returned, and the body of the callee is inlined.
+ *
+ * @param statement_ptr Statement, in the children of its parent
+ */
+void Inliner::inline_statement(ASTNode*& statement_ptr) {
+    vector<ASTNode*>& children = statement_ptr->get_children();
+    switch (statement_ptr->get_kind()) {
+        case NodeKind::CompoundStatement:
+            for (ASTNode*& child_ptr : children) {
+                this->inline_statement(child_ptr);
+            }
+            break;
+        case NodeKind::ExpressionStatement: {
+            if (children.empty()) {
+                break;
+            }
+            ASTNode* expr_ptr = children[0];
+            bool is_assigned = expr_ptr->get_kind() == NodeKind::Assignment &&
+                expr_ptr->get_child(1)->get_kind() == NodeKind::Call;
+            ASTNode* call_ptr = is_assigned ? expr_ptr->get_child(1) : expr_ptr;
+            ASTNode* target_ptr = is_assigned ? expr_ptr->get_child(0) : nullptr;
+            this->inline_expression(children[0], call_ptr);
+
+            // the call may have been inlined as an expression
+            bool is_call_left = is_assigned ? expr_ptr->get_child(1) == call_ptr : children[0] == call_ptr;
+            if (call_ptr->get_kind() == NodeKind::Call && is_call_left) {
+                this->inline_call_statement(statement_ptr, call_ptr, target_ptr, false);
+            }
+            break;
+        }
+        case NodeKind::ReturnStatement: {
+            ASTNode* call_ptr = children[0];
+            this->inline_expression(children[0], call_ptr);
+            if (call_ptr->get_kind() == NodeKind::Call && children[0] == call_ptr) {
+                this->inline_call_statement(statement_ptr, call_ptr, nullptr, true);
+            }
+            break;
+        }
+        case NodeKind::IfStatement:
+        case NodeKind::WhileStatement:
+            this->inline_expression(children[0], nullptr);
+            for (size_t i = 1; i < children.size(); i++) {
+                this->inline_statement(children[i]);
+            }
+            break;
+        case NodeKind::ForStatement:
+            // the initialization and the condition stay expression statements
+            for (int i = 0; i < 2; i++) {
+                if (children[i]->get_num_children() > 0) {
+                    this->inline_expression(children[i]->get_children()[0], nullptr);
+                }
+            }
+            this->inline_expression(children[2], nullptr);
+            this->inline_statement(children[3]);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Inlines the calls inside an expression whose callee is a single return of an expression.
+ *
+ * @param expr_ptr Expression, in the children of its parent
+ * @param top_call_ptr Call that can still be inlined in place of its statement, it is not reported here
+ */
+void Inliner::inline_expression(ASTNode*& expr_ptr, ASTNode* top_call_ptr) {
+    for (ASTNode*& child_ptr : expr_ptr->get_children()) {
+        this->inline_expression(child_ptr, top_call_ptr);
+    }
+
+    if (expr_ptr->get_kind() != NodeKind::Call) {
+        return;
+    }
+    auto func_def_iter = this->func_defs.find(expr_ptr->get_name_id());
+    if (func_def_iter == this->func_defs.end()) {
+        return;
+    }
+
+    ASTNode* callee_ptr = func_def_iter->second;
+    const char* rejection = this->get_rejection(callee_ptr);
+    if (rejection == nullptr && this->is_expression_body(callee_ptr, expr_ptr)) {
+        this->param_args.clear();
+        this->moved_offsets.clear();
+        int param_count = callee_ptr->get_num_children() - 1;
+        for (int i = 0; i < param_count; i++) {
+            this->param_args[param_count - i] = expr_ptr->get_child(i);
+        }
+        this->record(callee_ptr, "inlined");
+        expr_ptr = this->copy_body(Inliner::get_body(callee_ptr)->get_child(0)->get_child(0));
+    } else if (expr_ptr != top_call_ptr) {
+        this->record(callee_ptr, rejection != nullptr ? rejection : "not inlined, inside an expression");
+    }
+}
+
+/**
+ * @brief Replaces the statement of a call by the assignments of the arguments to the parameters, followed
+ * by the body of the callee whose returns assign or drop their value. The returns are kept for a call that
+ * is returned.
+ *
+ * @param statement_ptr Statement of the call, in the children of its parent
+ * @param call_ptr Call node
+ * @param target_ptr Variable the value of the call is assigned to, nullptr if it is dropped
+ * @param is_returned Whether the statement returns the value of the call
+ */
+void Inliner::inline_call_statement(ASTNode*& statement_ptr, ASTNode* call_ptr, ASTNode* target_ptr,
+    bool is_returned) {
+    auto func_def_iter = this->func_defs.find(call_ptr->get_name_id());
+    if (func_def_iter == this->func_defs.end()) {
+        return;
+    }
+
+    ASTNode* callee_ptr = func_def_iter->second;
+    const char* rejection = this->get_rejection(callee_ptr);
+    if (rejection == nullptr && target_ptr != nullptr && target_ptr->get_num_children() > 0 &&
+        (Inliner::has_side_effect(target_ptr->get_child(0)) || Inliner::has_global(target_ptr->get_child(0)))) {
+        // the index would be evaluated after the callee, instead of before it
+        rejection = "not inlined, assigned to an array element";
+    } else if (rejection == nullptr && is_returned && Inliner::is_completing(Inliner::get_body(callee_ptr))) {
+        rejection = "not inlined, may not return";
+    }
+    if (rejection != nullptr) {
+        this->record(callee_ptr, rejection);
+        return;
+    }
+
+    vector<ASTNode*> statements;
+    int slot_count = this->bind_params(callee_ptr, call_ptr, statements);
+    int body_idx = statements.size();
+    ASTNode* body_ptr = this->copy_body(Inliner::get_body(callee_ptr));
+    statements.insert(statements.end(), body_ptr->get_children().begin(), body_ptr->get_children().end());
+
+    this->target_ptr = target_ptr;
+    if (!is_returned && !this->lower_returns(statements, body_idx)) {
+        this->record(callee_ptr, "not inlined, returns inside a loop");
+        return;
+    }
+
+    this->caller_ptr->set_count(this->caller_ptr->get_count() + slot_count);
+    this->record(callee_ptr, "inlined");
+    statement_ptr = this->create_block(statement_ptr, statements);
+}
+
+/**
+ * @param callee_ptr FuncDefinition node of the callee
+ * @return Why the calls of the function are not inlined, nullptr if they can be
+ */
+const char* Inliner::get_rejection(ASTNode* callee_ptr) {
+    ASTNode* body_ptr = Inliner::get_body(callee_ptr);
+    if (Inliner::has_call_of(body_ptr, callee_ptr->get_name_id())) {
+        return "not inlined, recursive";
+    }
+
+    vector<ASTNode*> stack{ body_ptr };
+    while (!stack.empty()) {
+        ASTNode* node_ptr = stack.back();
+        stack.pop_back();
+        SemanticType type = node_ptr->get_semantic_type();
+        if (node_ptr->get_kind() == NodeKind::Declarator &&
+            (type == SemanticType::IntArray || type == SemanticType::FloatArray)) {
+            return "not inlined, local array";
+        }
+        stack.insert(stack.end(), node_ptr->get_children().begin(), node_ptr->get_children().end());
+    }
+
+    bool is_leaf = !Inliner::has_kind(body_ptr, NodeKind::Call);
+    if (Inliner::count_nodes(body_ptr) > (is_leaf ? MAX_LEAF_INLINE_SIZE : MAX_INLINE_SIZE)) {
+        return "not inlined, too large";
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Whether the body of the callee can replace the call as an expression: it is a single return of an
+ * expression that assigns nothing, and the arguments can be used in place of the parameters. They must have
+ * no side effects, be a constant or a variable if they are used more than once, and not read globals that
+ * the calls of the returned expression may change.
+ *
+ * @param callee_ptr FuncDefinition node of the callee
+ * @param call_ptr Call node
+ */
+bool Inliner::is_expression_body(ASTNode* callee_ptr, ASTNode* call_ptr) {
+    ASTNode* body_ptr = Inliner::get_body(callee_ptr);
+    if (body_ptr->get_num_children() != 1 || body_ptr->get_child(0)->get_kind() != NodeKind::ReturnStatement) {
+        return false;
+    }
+    ASTNode* value_ptr = body_ptr->get_child(0)->get_child(0);
+    if (Inliner::has_kind(value_ptr, NodeKind::Assignment) || Inliner::has_kind(value_ptr, NodeKind::PostIncrement) ||
+        Inliner::has_kind(value_ptr, NodeKind::PostDecrement)) {
+        return false;
+    }
+
+    bool has_call = Inliner::has_kind(value_ptr, NodeKind::Call);
+    int param_count = callee_ptr->get_num_children() - 1;
+    for (int i = 0; i < param_count; i++) {
+        ASTNode* arg_ptr = call_ptr->get_child(i);
+        NodeKind arg_kind = arg_ptr->get_kind();
+        bool is_simple = arg_kind == NodeKind::ConstInt || arg_kind == NodeKind::ConstFloat ||
+            (arg_kind == NodeKind::Variable && arg_ptr->get_num_children() == 0);
+        if (Inliner::has_side_effect(arg_ptr) || (has_call && Inliner::has_global(arg_ptr)) ||
+            (!is_simple && Inliner::count_local_uses(value_ptr, param_count - i) > 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Binds the parameters of the callee for a copy of its body. A constant or scalar local argument of
+ * a parameter that is not assigned is used in place, the others are assigned to new locals of the caller,
+ * below its frame. A scalar local is only used in place if no later argument has a side effect, which could
+ * change it after a call would have pushed its value. The locals of the callee are moved below them.
+ *
+ * @param callee_ptr FuncDefinition node of the callee
+ * @param call_ptr Call node
+ * @param statements Assignments of the arguments are appended, in the order they are evaluated by a call
+ * @return Number of stack slots added to the frame of the caller
+ */
+int Inliner::bind_params(ASTNode* callee_ptr, ASTNode* call_ptr, vector<ASTNode*>& statements) {
+    this->param_args.clear();
+    this->moved_offsets.clear();
+    ASTNode* body_ptr = Inliner::get_body(callee_ptr);
+    int first_offset = -(this->caller_ptr->get_count() + 1);
+    int next_offset = first_offset;
+
+    int param_count = callee_ptr->get_num_children() - 1;
+    int last_effect_idx = -1;
+    for (int i = 0; i < param_count; i++) {
+        if (Inliner::has_side_effect(call_ptr->get_child(i))) {
+            last_effect_idx = i;
+        }
+    }
+    for (int i = 0; i < param_count; i++) {
+        ASTNode* arg_ptr = call_ptr->get_child(i);
+        NodeKind arg_kind = arg_ptr->get_kind();
+        int param_offset = param_count - i;
+        bool is_in_place = arg_kind == NodeKind::ConstInt || arg_kind == NodeKind::ConstFloat ||
+            (arg_kind == NodeKind::Variable && arg_ptr->get_num_children() == 0 &&
+            arg_ptr->get_codegen_info_ptr()->is_local() && i > last_effect_idx);
+        if (is_in_place && !Inliner::is_param_assigned(body_ptr, param_offset)) {
+            this->param_args[param_offset] = arg_ptr;
+            continue;
+        }
+
+        ASTNode* param_ptr = callee_ptr->get_child(i);
+        ASTNode* var_ptr = this->arena.create<ASTNode>(NodeKind::Variable, arg_ptr->get_span(),
+            param_ptr->get_semantic_type(), param_ptr->get_name_id());
+        var_ptr->get_codegen_info_ptr()->set_is_local(true);
+        var_ptr->get_codegen_info_ptr()->set_stack_offset(next_offset);
+        this->moved_offsets[param_offset] = next_offset--;
+        statements.push_back(this->create_statement(arg_ptr, this->create_assignment(var_ptr, arg_ptr)));
+    }
+
+    for (int stack_offset = -1; stack_offset >= -callee_ptr->get_count(); stack_offset--) {
+        this->moved_offsets[stack_offset] = next_offset--;
+    }
+    return first_offset - next_offset;
+}
+
+/**
+ * @brief Rewrites the statements of an inlined body from the given one, so that control leaves them only at
+ * their end. A return becomes the assignment of its value to the target, or the evaluation of its value,
+ * and ends them. The statements after an if with a branch that returns on every path are moved into the
+ * other branch, the statements of a block are taken out of it.
+ *
+ * @param statements Statements of the body, rewritten in place
+ * @param first_idx Index of the first statement to rewrite
+ * @return false if a return is inside a loop, or in a branch that does not return on every path
+ */
+bool Inliner::lower_returns(vector<ASTNode*>& statements, int first_idx) {
+    for (int i = first_idx; i < statements.size(); i++) {
+        ASTNode* statement_ptr = statements[i];
+        if (!Inliner::has_kind(statement_ptr, NodeKind::ReturnStatement)) {
+            continue;
+        }
+
+        switch (statement_ptr->get_kind()) {
+            case NodeKind::ReturnStatement: {
+                ASTNode* value_ptr = statement_ptr->get_child(0);
+                if (this->target_ptr != nullptr) {
+                    value_ptr = this->create_assignment(this->copy_tree(this->target_ptr), value_ptr);
+                }
+                statements[i] = this->create_statement(statement_ptr, value_ptr);
+                statements.erase(statements.begin() + i + 1, statements.end());
+                return true;
+            }
+            case NodeKind::CompoundStatement: {
+                // locals keep their stack offsets outside the block
+                vector<ASTNode*> block_statements = statement_ptr->get_children();
+                statements.erase(statements.begin() + i);
+                statements.insert(statements.begin() + i, block_statements.begin(), block_statements.end());
+                i--;
+                break;
+            }
+            case NodeKind::IfStatement: {
+                vector<ASTNode*>& branches = statement_ptr->get_children();
+                bool has_else = branches.size() == 3;
+                bool is_body_returning = !Inliner::is_completing(branches[1]);
+                bool is_else_returning = has_else && !Inliner::is_completing(branches[2]);
+                if ((!is_body_returning && Inliner::has_kind(branches[1], NodeKind::ReturnStatement)) ||
+                    (has_else && !is_else_returning && Inliner::has_kind(branches[2], NodeKind::ReturnStatement))) {
+                    return false;
+                }
+
+                vector<ASTNode*> rest(statements.begin() + i + 1, statements.end());
+                statements.erase(statements.begin() + i + 1, statements.end());
+                vector<ASTNode*> body_statements{ branches[1] }, else_statements;
+                if (has_else) {
+                    else_statements.push_back(branches[2]);
+                }
+                if (!is_body_returning) {
+                    body_statements.insert(body_statements.end(), rest.begin(), rest.end());
+                } else if (!is_else_returning) {
+                    else_statements.insert(else_statements.end(), rest.begin(), rest.end());
+                }
+                if (!this->lower_returns(body_statements, 0) || !this->lower_returns(else_statements, 0)) {
+                    return false;
+                }
+
+                branches[1] = this->create_block(statement_ptr, body_statements);
+                if (has_else) {
+                    branches[2] = this->create_block(statement_ptr, else_statements);
+                } else if (!else_statements.empty()) {
+                    statement_ptr->add_child(this->create_block(statement_ptr, else_statements));
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+ASTNode* Inliner::copy_tree(ASTNode* node_ptr) {
+    ASTNode* copy_ptr = this->arena.create<ASTNode>(*node_ptr);
+    for (ASTNode*& child_ptr : copy_ptr->get_children()) {
+        child_ptr = this->copy_tree(child_ptr);
+    }
+    return copy_ptr;
+}
+
+/**
+ * @brief Copies a node of the body of the callee into the caller. Parameters bound to arguments are
+ * replaced by copies of the arguments, the other parameters and locals are moved to their caller stack
+ * offsets. A local is assigned 0 after its declaration, as it would be at every call.
+ */
+ASTNode* Inliner::copy_body(ASTNode* node_ptr) {
+    NodeKind kind = node_ptr->get_kind();
+    CodeGenInfo* cgi_ptr = node_ptr->get_codegen_info_ptr();
+    bool is_local = (kind == NodeKind::Variable || kind == NodeKind::Declarator) && cgi_ptr->is_local();
+    if (is_local && kind == NodeKind::Variable) {
+        auto arg_iter = this->param_args.find(cgi_ptr->get_stack_offset());
+        if (arg_iter != this->param_args.end()) {
+            return this->copy_tree(arg_iter->second);
+        }
+    }
+
+    ASTNode* copy_ptr = this->arena.create<ASTNode>(*node_ptr);
+    if (is_local) {
+        auto moved_iter = this->moved_offsets.find(cgi_ptr->get_stack_offset());
+        if (moved_iter != this->moved_offsets.end()) {
+            copy_ptr->get_codegen_info_ptr()->set_stack_offset(moved_iter->second);
+        }
+    }
+
+    vector<ASTNode*>& children = copy_ptr->get_children();
+    if (kind != NodeKind::CompoundStatement) {
+        for (ASTNode*& child_ptr : children) {
+            child_ptr = this->copy_body(child_ptr);
+        }
+        return copy_ptr;
+    }
+
+    vector<ASTNode*> statements;
+    for (ASTNode* statement_ptr : children) {
+        statements.push_back(this->copy_body(statement_ptr));
+        if (statement_ptr->get_kind() != NodeKind::VarDeclaration) {
+            continue;
+        }
+        for (ASTNode* declarator_ptr : statements.back()->get_children()) {
+            ASTNode* var_ptr = this->arena.create<ASTNode>(NodeKind::Variable, declarator_ptr->get_span(),
+                declarator_ptr->get_semantic_type(), declarator_ptr->get_name_id());
+            CodeGenInfo* declarator_cgi_ptr = declarator_ptr->get_codegen_info_ptr();
+            var_ptr->get_codegen_info_ptr()->set_is_local(declarator_cgi_ptr->is_local());
+            var_ptr->get_codegen_info_ptr()->set_stack_offset(declarator_cgi_ptr->get_stack_offset());
+            ASTNode* zero_ptr = this->arena.create<ASTNode>(NodeKind::ConstInt, declarator_ptr->get_span(),
+                SemanticType::Int, this->string_interner.intern("0"));
+            statements.push_back(this->create_statement(declarator_ptr, this->create_assignment(var_ptr, zero_ptr)));
+        }
+    }
+    children = statements;
+    return copy_ptr;
+}
+
+ASTNode* Inliner::create_statement(ASTNode* span_node_ptr, ASTNode* expr_ptr) {
+    ASTNode* statement_ptr = this->arena.create<ASTNode>(NodeKind::ExpressionStatement,
+        span_node_ptr->get_span(), expr_ptr->get_semantic_type());
+    statement_ptr->add_child(expr_ptr);
+    return statement_ptr;
+}
+
+ASTNode* Inliner::create_assignment(ASTNode* var_ptr, ASTNode* value_ptr) {
+    ASTNode* assign_ptr = this->arena.create<ASTNode>(NodeKind::Assignment, value_ptr->get_span(),
+        var_ptr->get_semantic_type());
+    assign_ptr->add_child(var_ptr);
+    assign_ptr->add_child(value_ptr);
+    return assign_ptr;
+}
+
+ASTNode* Inliner::create_block(ASTNode* span_node_ptr, const vector<ASTNode*>& statements) {
+    ASTNode* block_ptr = this->arena.create<ASTNode>(NodeKind::CompoundStatement, span_node_ptr->get_span(),
+        SemanticType::Void);
+    for (ASTNode* statement_ptr : statements) {
+        block_ptr->add_child(statement_ptr);
+    }
+    return block_ptr;
+}
+
+/**
+ * @brief Counts the outcome of a call of the callee in the current caller.
+ */
+void Inliner::record(ASTNode* callee_ptr, const string& outcome) {
+    pair<string, string> key{ this->string_interner.get_string(callee_ptr->get_name_id()) + " into " +
+        this->string_interner.get_string(this->caller_ptr->get_name_id()), outcome };
+    if (this->outcome_counts[key]++ == 0) {
+        this->outcome_keys.push_back(key);
+    }
+    this->call_count++;
+    this->inlined_count += outcome == "inlined";
+}
+
+ASTNode* Inliner::get_body(ASTNode* func_def_ptr) {
+    return func_def_ptr->get_child(func_def_ptr->get_num_children() - 1);
+}
+
+void Inliner::collect_callees(ASTNode* node_ptr, vector<int>& callee_ids) {
+    if (node_ptr->get_kind() == NodeKind::Call) {
+        callee_ids.push_back(node_ptr->get_name_id());
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        Inliner::collect_callees(child_ptr, callee_ids);
+    }
+}
+
+int Inliner::count_nodes(ASTNode* node_ptr) {
+    int node_count = 1;
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        node_count += Inliner::count_nodes(child_ptr);
+    }
+    return node_count;
+}
+
+bool Inliner::has_kind(ASTNode* node_ptr, NodeKind kind) {
+    if (node_ptr->get_kind() == kind) {
+        return true;
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (Inliner::has_kind(child_ptr, kind)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Inliner::has_call_of(ASTNode* node_ptr, int func_name_id) {
+    if (node_ptr->get_kind() == NodeKind::Call && node_ptr->get_name_id() == func_name_id) {
+        return true;
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (Inliner::has_call_of(child_ptr, func_name_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Inliner::has_side_effect(ASTNode* expr_ptr) {
+    return Inliner::has_kind(expr_ptr, NodeKind::Call) || Inliner::has_kind(expr_ptr, NodeKind::Assignment) ||
+        Inliner::has_kind(expr_ptr, NodeKind::PostIncrement) || Inliner::has_kind(expr_ptr, NodeKind::PostDecrement);
+}
+
+bool Inliner::has_global(ASTNode* expr_ptr) {
+    if (expr_ptr->get_kind() == NodeKind::Variable && !expr_ptr->get_codegen_info_ptr()->is_local()) {
+        return true;
+    }
+    for (ASTNode* child_ptr : expr_ptr->get_children()) {
+        if (Inliner::has_global(child_ptr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @return Whether the parameter is assigned, or stepped, anywhere in the node
+ */
+bool Inliner::is_param_assigned(ASTNode* node_ptr, int stack_offset) {
+    NodeKind kind = node_ptr->get_kind();
+    if (kind == NodeKind::Assignment || kind == NodeKind::PostIncrement || kind == NodeKind::PostDecrement) {
+        ASTNode* var_ptr = node_ptr->get_child(0);
+        if (var_ptr->get_codegen_info_ptr()->is_local() && var_ptr->get_codegen_info_ptr()->get_stack_offset() ==
+            stack_offset) {
+            return true;
+        }
+    }
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        if (Inliner::is_param_assigned(child_ptr, stack_offset)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int Inliner::count_local_uses(ASTNode* node_ptr, int stack_offset) {
+    CodeGenInfo* cgi_ptr = node_ptr->get_codegen_info_ptr();
+    int use_count = node_ptr->get_kind() == NodeKind::Variable && cgi_ptr->is_local() &&
+        cgi_ptr->get_stack_offset() == stack_offset;
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        use_count += Inliner::count_local_uses(child_ptr, stack_offset);
+    }
+    return use_count;
+}
+
+/**
+ * @return false if the statement returns on every path, loops are assumed to complete
+ */
+bool Inliner::is_completing(ASTNode* statement_ptr) {
+    switch (statement_ptr->get_kind()) {
+        case NodeKind::ReturnStatement:
+            return false;
+        case NodeKind::CompoundStatement:
+            for (ASTNode* child_ptr : statement_ptr->get_children()) {
+                if (!Inliner::is_completing(child_ptr)) {
+                    return false;
+                }
+            }
+            return true;
+        case NodeKind::IfStatement:
+            return statement_ptr->get_num_children() < 3 || Inliner::is_completing(statement_ptr->get_child(1)) ||
+                Inliner::is_completing(statement_ptr->get_child(2));
+        default:
+            return true;
+    }
+}
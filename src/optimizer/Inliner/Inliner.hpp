@@ -0,0 +1,111 @@
+#pragma once
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../../arena/Arena/Arena.hpp"
+#include "../../ast/include.hpp"
+
+using namespace std;
+
+// most nodes in the body of a function inlined at its calls
+const int MAX_INLINE_SIZE = 24;
+// most nodes in the body of a leaf function, that makes no calls, inlined at its calls
+const int MAX_LEAF_INLINE_SIZE = 48;
+
+/**
+ * @brief Whole-program inlining on the AST, before dead code elimination. Calls of small functions are
+ * replaced by a copy of the body of the callee, saving the pushes of the arguments, the call, the frame
+ * setup and teardown, and letting the values of the arguments be folded into the body.
+ *
+ * A function whose body is a single return of an expression without side effects is inlined as that
+ * expression, anywhere in an expression. Other bodies are inlined in place of the statement of the call:
+ * a call whose value is dropped, assigned to a variable, or returned. Parameters become locals of the caller
+ * that the arguments are assigned to, unless the argument is a constant or a scalar local, and the parameter
+ * is not assigned, which is then used in place. The returns of the copy become the assignment of their value,
+ * so the copy must leave them at its end, possibly after moving the statements after an if into its else.
+ *
+ * Functions are visited callees first, so the bodies that are copied already have their calls inlined. A
+ * function that calls itself, also after inlining, is never inlined, which bounds mutual recursion. Neither
+ * are functions with local arrays, which would grow the frame of the caller.
+ */
+class Inliner {
+    Arena& arena;
+    StringInterner& string_interner;
+    // function definitions, keyed on the name handle
+    unordered_map<int, ASTNode*> func_defs;
+    // functions whose calls are inlined, or being inlined, keyed on the name handle
+    unordered_map<int, bool> is_func_done;
+    // function whose calls are being inlined
+    ASTNode* caller_ptr;
+
+    // a copied body reads the arguments used in place of the parameters, keyed on the stack offset of the
+    // parameter, and the other parameters and locals from the caller stack offsets they are moved to
+    map<int, ASTNode*> param_args;
+    map<int, int> moved_offsets;
+    // variable a call is assigned to, nullptr if its value is dropped
+    ASTNode* target_ptr;
+
+    // outcome of the calls of each callee in each caller, in the order they are met
+    vector<pair<string, string>> outcome_keys;
+    map<pair<string, string>, int> outcome_counts;
+    int call_count;
+    int inlined_count;
+
+public:
+    Inliner(Arena&, StringInterner&);
+
+    void inline_calls(ASTNode*);
+
+    void write_report(ostream&) const;
+
+private:
+    void visit_func(ASTNode*);
+
+    void inline_statement(ASTNode*&);
+
+    void inline_expression(ASTNode*&, ASTNode*);
+
+    void inline_call_statement(ASTNode*&, ASTNode*, ASTNode*, bool);
+
+    const char* get_rejection(ASTNode*);
+
+    bool is_expression_body(ASTNode*, ASTNode*);
+
+    int bind_params(ASTNode*, ASTNode*, vector<ASTNode*>&);
+
+    bool lower_returns(vector<ASTNode*>&, int);
+
+    ASTNode* copy_tree(ASTNode*);
+
+    ASTNode* copy_body(ASTNode*);
+
+    ASTNode* create_statement(ASTNode*, ASTNode*);
+
+    ASTNode* create_assignment(ASTNode*, ASTNode*);
+
+    ASTNode* create_block(ASTNode*, const vector<ASTNode*>&);
+
+    void record(ASTNode*, const string&);
+
+    static ASTNode* get_body(ASTNode*);
+
+    static void collect_callees(ASTNode*, vector<int>&);
+
+    static int count_nodes(ASTNode*);
+
+    static bool has_kind(ASTNode*, NodeKind);
+
+    static bool has_call_of(ASTNode*, int);
+
+    static bool has_side_effect(ASTNode*);
+
+    static bool has_global(ASTNode*);
+
+    static bool is_param_assigned(ASTNode*, int);
+
+    static int count_local_uses(ASTNode*, int);
+
+    static bool is_completing(ASTNode*);
+};
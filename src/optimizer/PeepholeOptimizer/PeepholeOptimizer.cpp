@@ -0,0 +1,427 @@
+#include <algorithm>
+#include "PeepholeOptimizer.hpp"
+
+using namespace std;
+
+OperandPattern OperandPattern::exact(const Operand& operand) {
+    return OperandPattern{false, -1, operand};
+}
+
+/**
+ * @param var Variable number, -1 for a wildcard that matches any operand without binding it
+ */
+OperandPattern OperandPattern::var_of(int var) {
+    return OperandPattern{true, var, Operand::none()};
+}
+
+const OperandPattern V0 = OperandPattern::var_of(0), V1 = OperandPattern::var_of(1),
+    V2 = OperandPattern::var_of(2), ANY = OperandPattern::var_of(-1),
+    NO_OPERAND = OperandPattern::exact(Operand::none()), AX = OperandPattern::exact(Operand::reg_of(Register::AX)),
+    ZERO = OperandPattern::exact(Operand::imm(0));
+
+static LinePattern op(Opcode opcode, OperandPattern dst = NO_OPERAND, OperandPattern src = NO_OPERAND) {
+    return LinePattern{LineKind::Instruction, OpcodeMatch::Exact, opcode, dst, src};
+}
+
+static LinePattern any_op() {
+    return LinePattern{LineKind::Instruction, OpcodeMatch::AnyOp, Opcode::MOV, ANY, ANY};
+}
+
+static LinePattern cond_jump(OperandPattern target) {
+    return LinePattern{LineKind::Instruction, OpcodeMatch::CondJump, Opcode::JMP, target, NO_OPERAND};
+}
+
+static LinePattern inverse_of_cond_jump(OperandPattern target) {
+    return LinePattern{LineKind::Instruction, OpcodeMatch::InverseOfCondJump, Opcode::JMP, target, NO_OPERAND};
+}
+
+static LinePattern label(OperandPattern label) {
+    return LinePattern{LineKind::Label, OpcodeMatch::Exact, Opcode::MOV, label, NO_OPERAND};
+}
+
+/**
+ * @brief Whether the register is part of the address of a memory operand.
+ */
+static bool is_address_register(const Operand& operand, Register reg) {
+    if (operand.kind == OperandKind::Local) {
+        return reg == Register::BP || (operand.is_indexed && reg == Register::SI);
+    }
+    if (operand.kind == OperandKind::Symbol) {
+        return operand.is_indexed && reg == Register::SI;
+    }
+    return false;
+}
+
+/**
+    Guards of the rules
+**/
+
+static bool is_move_back_redundant(const PeepholeOptimizer&, const RuleMatch& match) {
+    // MOV SI, a[SI] changes the element that MOV a[SI], SI writes
+    return match.vars[0].kind != OperandKind::Register || !is_address_register(match.vars[1], match.vars[0].reg);
+}
+
+static bool is_move_repeated(const PeepholeOptimizer&, const RuleMatch& match) {
+    // the register still holds the value unless the store changes the register or the address of the source
+    const Operand& reg = match.vars[0];
+    const Operand& stored = match.vars[2];
+    return reg.kind == OperandKind::Register && stored != reg &&
+        (stored.kind != OperandKind::Register || !is_address_register(match.vars[1], stored.reg));
+}
+
+static bool is_move_via_stack_foldable(const PeepholeOptimizer&, const RuleMatch& match) {
+    const Operand& src = match.vars[0];
+    const Operand& dst = match.vars[1];
+    return dst.kind == OperandKind::Register && dst.reg != Register::AX && dst.reg != Register::SP &&
+        src != Operand::reg_of(Register::SP);
+}
+
+static bool is_label_unreferenced(const PeepholeOptimizer& optimizer, const RuleMatch& match) {
+    return optimizer.get_label_ref_count(match.vars[0]) == 0;
+}
+
+static bool are_flags_dead_after(const PeepholeOptimizer& optimizer, const RuleMatch& match) {
+    return optimizer.are_flags_dead_at(match.end);
+}
+
+// tried in order at every line, the first rule that matches is applied
+const vector<PeepholeRule> PEEPHOLE_RULES{
+    {"unreachable-after-jmp", {op(Opcode::JMP, V0), any_op()}, {op(Opcode::JMP, V0)}, nullptr},
+    {"unreachable-after-ret", {op(Opcode::RET, V0), any_op()}, {op(Opcode::RET, V0)}, nullptr},
+    {"jmp-to-next", {op(Opcode::JMP, V0), label(V0)}, {label(V0)}, nullptr},
+    {
+        "jcc-over-jmp",
+        {cond_jump(V0), op(Opcode::JMP, V1), label(V0)},
+        {inverse_of_cond_jump(V1), label(V0)},
+        nullptr
+    },
+    {"unreferenced-label", {label(V0)}, {}, is_label_unreferenced},
+    {"mov-back", {op(Opcode::MOV, V0, V1), op(Opcode::MOV, V1, V0)}, {op(Opcode::MOV, V0, V1)}, is_move_back_redundant},
+    {
+        "mov-repeat",
+        {op(Opcode::MOV, V0, V1), op(Opcode::MOV, V2, V0), op(Opcode::MOV, V0, V1)},
+        {op(Opcode::MOV, V0, V1), op(Opcode::MOV, V2, V0)},
+        is_move_repeated
+    },
+    {
+        "mov-via-stack",
+        {op(Opcode::PUSH, AX), op(Opcode::MOV, AX, V0), op(Opcode::MOV, V1, AX), op(Opcode::POP, AX)},
+        {op(Opcode::MOV, V1, V0)},
+        is_move_via_stack_foldable
+    },
+    {"push-pop", {op(Opcode::PUSH, V0), op(Opcode::POP, V0)}, {}, nullptr},
+    {"add-zero", {op(Opcode::ADD, V0, ZERO)}, {}, are_flags_dead_after},
+    {"sub-zero", {op(Opcode::SUB, V0, ZERO)}, {}, are_flags_dead_after}
+};
+
+static bool match_operand(const OperandPattern& pattern, const Operand& operand, RuleMatch& match) {
+    if (!pattern.is_var) {
+        return pattern.operand == operand;
+    }
+    if (pattern.var < 0) {
+        return true;
+    }
+    if (match.is_bound[pattern.var]) {
+        return match.vars[pattern.var] == operand;
+    }
+    match.vars[pattern.var] = operand;
+    match.is_bound[pattern.var] = true;
+    return true;
+}
+
+static bool match_line(const LinePattern& pattern, const AsmLine& line, RuleMatch& match) {
+    if (line.kind != pattern.kind) {
+        return false;
+    }
+    if (line.kind == LineKind::Label) {
+        return match_operand(pattern.dst, line.instruction.dst, match);
+    }
+
+    Opcode opcode = line.instruction.opcode;
+    if (pattern.opcode_match == OpcodeMatch::CondJump) {
+        if (!is_cond_jump(opcode)) {
+            return false;
+        }
+        match.cond_jump = opcode;
+    } else if (pattern.opcode_match == OpcodeMatch::Exact && pattern.opcode != opcode) {
+        return false;
+    }
+    return match_operand(pattern.dst, line.instruction.dst, match) &&
+        match_operand(pattern.src, line.instruction.src, match);
+}
+
+static Operand instantiate_operand(const OperandPattern& pattern, const RuleMatch& match) {
+    return pattern.is_var ? match.vars[pattern.var] : pattern.operand;
+}
+
+static AsmLine instantiate_line(const LinePattern& pattern, const RuleMatch& match) {
+    Operand dst = instantiate_operand(pattern.dst, match);
+    if (pattern.kind == LineKind::Label) {
+        return AsmLine::label(dst);
+    }
+
+    Opcode opcode = pattern.opcode;
+    if (pattern.opcode_match == OpcodeMatch::InverseOfCondJump) {
+        opcode = get_inverse_cond_jump(match.cond_jump);
+    }
+    return AsmLine::op(opcode, dst, instantiate_operand(pattern.src, match));
+}
+
+static long long get_label_key(const Operand& label) {
+    return ((long long)label.label << 32) | (unsigned int)label.value;
+}
+
+/**
+ * @param job_count Number of threads the procedures are rewritten on
+ * @param code_cache_ptr Cache of the rewritten procedures, nullptr if none
+ */
+PeepholeOptimizer::PeepholeOptimizer(int job_count, CodeCache* code_cache_ptr)
+    : job_count(job_count), code_cache_ptr(code_cache_ptr), code_ptr(nullptr), label_ref_counts{},
+    hit_counts(PEEPHOLE_RULES.size(), 0),
+    pass_count{ 0 }, instructions_before{ 0 }, instructions_after{ 0 } {
+}
+
+/**
+ * @brief Rewrites the code with the rules until none of them match.
+ *
+ * @param code Code section lines
+ */
+void PeepholeOptimizer::optimize(vector<AsmLine>& code) {
+    this->instructions_before = PeepholeOptimizer::count_instructions(code);
+
+    vector<vector<AsmLine>> procs;
+    for (const AsmLine& line : code) {
+        if (procs.empty() || line.kind == LineKind::ProcBegin) {
+            procs.emplace_back();
+        }
+        procs.back().push_back(line);
+    }
+    vector<PeepholeOptimizer> proc_optimizers(procs.size(), PeepholeOptimizer(1, this->code_cache_ptr));
+    WorkerPool(this->job_count).run(procs.size(), [&](int i) {
+        proc_optimizers[i].optimize_cached_proc(procs[i]);
+    });
+
+    code.clear();
+    for (int i = 0; i < procs.size(); i++) {
+        code.insert(code.end(), procs[i].begin(), procs[i].end());
+        for (int rule_idx = 0; rule_idx < PEEPHOLE_RULES.size(); rule_idx++) {
+            this->hit_counts[rule_idx] += proc_optimizers[i].hit_counts[rule_idx];
+        }
+        this->pass_count = max(this->pass_count, proc_optimizers[i].pass_count);
+    }
+    this->instructions_after = PeepholeOptimizer::count_instructions(code);
+}
+
+/**
+ * @brief Sets the instructions before and after the rewrites in the counts of the compilation, with the hits
+ * of each rule and the instructions they removed.
+ */
+void PeepholeOptimizer::fill_stats(CompilerStats& stats) const {
+    stats.instruction_count = this->instructions_before;
+    stats.optimized_instruction_count = this->instructions_after;
+    stats.rule_stats.clear();
+    for (int i = 0; i < PEEPHOLE_RULES.size(); i++) {
+        const PeepholeRule& rule = PEEPHOLE_RULES[i];
+        auto is_instruction = [](const LinePattern& line) {
+            return line.kind == LineKind::Instruction;
+        };
+        int removed_per_hit = count_if(rule.pattern.begin(), rule.pattern.end(), is_instruction) -
+            count_if(rule.replacement.begin(), rule.replacement.end(), is_instruction);
+        stats.rule_stats.push_back(RuleStats{rule.name, this->hit_counts[i], this->hit_counts[i] * removed_per_hit});
+    }
+}
+
+/**
+ * @brief Rewrites the lines of a procedure with the rules until none of them match.
+ */
+void PeepholeOptimizer::optimize_proc(vector<AsmLine>& code) {
+    do {
+        this->pass_count++;
+    } while (this->do_pass(code));
+    this->code_ptr = nullptr;
+}
+
+/**
+ * @brief Rewrites the lines of a procedure, or reads the rewritten lines and the counts from the code cache.
+ * The entry is keyed on the lines, with the labels relative to the lowest one.
+ */
+void PeepholeOptimizer::optimize_cached_proc(vector<AsmLine>& code) {
+    if (this->code_cache_ptr == nullptr) {
+        this->optimize_proc(code);
+        return;
+    }
+
+    int label_base = CodeCache::get_label_base(code);
+    string cache_key;
+    this->code_cache_ptr->encode_lines(code, label_base, cache_key);
+    vector<AsmLine> cached_code;
+    vector<int> cached_counts;
+    bool is_cached = this->code_cache_ptr->load(CacheSection::OptimizedCode, cache_key, label_base, cached_code,
+        cached_counts) && cached_counts.size() == PEEPHOLE_RULES.size() + 1;
+    if (is_cached && !this->code_cache_ptr->is_verified()) {
+        code = cached_code;
+        this->pass_count = cached_counts[0];
+        copy(cached_counts.begin() + 1, cached_counts.end(), this->hit_counts.begin());
+        return;
+    }
+
+    this->optimize_proc(code);
+    vector<int> counts(1, this->pass_count);
+    counts.insert(counts.end(), this->hit_counts.begin(), this->hit_counts.end());
+    if (is_cached) {
+        this->code_cache_ptr->verify(CacheSection::OptimizedCode, cache_key, label_base, code, counts);
+    } else {
+        this->code_cache_ptr->store(CacheSection::OptimizedCode, cache_key, label_base, code, counts);
+    }
+}
+
+/**
+ * @brief Number of jumps to the label in the code of the current pass. Rewrites only remove jumps, so the
+ * count is never lower than the number of jumps left.
+ */
+int PeepholeOptimizer::get_label_ref_count(const Operand& label) const {
+    auto iter = this->label_ref_counts.find(get_label_key(label));
+    return iter == this->label_ref_counts.end() ? 0 : iter->second;
+}
+
+/**
+ * @brief Whether the flags are overwritten before they are read on every path from the line. The scan stops
+ * at labels and jumps, where the flags are assumed live. Calls and returns clobber the flags.
+ *
+ * @param idx Index of the line in the code of the current pass
+ */
+bool PeepholeOptimizer::are_flags_dead_at(int idx) const {
+    const vector<AsmLine>& code = *this->code_ptr;
+    for (; idx < code.size(); idx++) {
+        if (code[idx].kind == LineKind::Comment || code[idx].kind == LineKind::Blank) {
+            continue;
+        }
+        if (code[idx].kind != LineKind::Instruction) {
+            return false;
+        }
+
+        switch (code[idx].instruction.opcode) {
+            case Opcode::ADD: case Opcode::SUB: case Opcode::MUL: case Opcode::IMUL: case Opcode::DIV:
+            case Opcode::IDIV: case Opcode::NEG: case Opcode::INC: case Opcode::DEC: case Opcode::AND:
+            case Opcode::OR: case Opcode::CMP: case Opcode::TEST: case Opcode::CALL: case Opcode::RET:
+                return true;
+            case Opcode::MOV: case Opcode::XCHG: case Opcode::PUSH: case Opcode::POP:
+                break;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Writes the number of instructions before and after the optimization, and the hits of each rule.
+ */
+void PeepholeOptimizer::write_stats(ostream& ostrm) const {
+    ostrm << "Peephole optimization: " << this->instructions_before << " -> " << this->instructions_after <<
+        " instructions in " << this->pass_count << " passes\n";
+    for (int i = 0; i < PEEPHOLE_RULES.size(); i++) {
+        ostrm << "\t" << PEEPHOLE_RULES[i].name << ": " << this->hit_counts[i] << "\n";
+    }
+}
+
+/**
+ * @brief Applies the first matching rule at each line, windows that are replaced do not overlap.
+ *
+ * @param code Code section lines
+ * @return true if any rule was applied
+ */
+bool PeepholeOptimizer::do_pass(vector<AsmLine>& code) {
+    this->code_ptr = &code;
+    this->count_label_refs(code);
+
+    vector<AsmLine> optimized_code;
+    optimized_code.reserve(code.size());
+    bool is_changed = false;
+    RuleMatch match;
+
+    int i = 0;
+    while (i < code.size()) {
+        int rule_idx = PEEPHOLE_RULES.size();
+        if (code[i].kind == LineKind::Instruction || code[i].kind == LineKind::Label) {
+            rule_idx = 0;
+            while (rule_idx < PEEPHOLE_RULES.size() && !this->match_rule(PEEPHOLE_RULES[rule_idx], i, match)) {
+                rule_idx++;
+            }
+        }
+        if (rule_idx == PEEPHOLE_RULES.size()) {
+            optimized_code.push_back(code[i]);
+            i++;
+            continue;
+        }
+
+        const PeepholeRule& rule = PEEPHOLE_RULES[rule_idx];
+        for (int j = i; j < match.end; j++) {
+            if (code[j].kind == LineKind::Comment) {
+                optimized_code.push_back(code[j]);
+            }
+        }
+        for (int k = 0; k < rule.replacement.size(); k++) {
+            AsmLine line = instantiate_line(rule.replacement[k], match);
+            line.indentation = code[match.line_idxs[min(k, (int)match.line_idxs.size() - 1)]].indentation;
+            optimized_code.push_back(line);
+        }
+
+        this->hit_counts[rule_idx]++;
+        is_changed = true;
+        i = match.end;
+    }
+
+    code.swap(optimized_code);
+    this->code_ptr = &code;
+    return is_changed;
+}
+
+/**
+ * @brief Matches the pattern of the rule against the window of instructions and labels starting at a line.
+ *
+ * @param rule Rule to match
+ * @param start Index of the first line of the window
+ * @param match Set to the matched lines and bound operands
+ * @return true if the pattern matches and the guard accepts it
+ */
+bool PeepholeOptimizer::match_rule(const PeepholeRule& rule, int start, RuleMatch& match) const {
+    const vector<AsmLine>& code = *this->code_ptr;
+    fill(begin(match.is_bound), end(match.is_bound), false);
+    match.line_idxs.clear();
+
+    int idx = start;
+    for (const LinePattern& line_pattern : rule.pattern) {
+        while (idx < code.size() && code[idx].kind == LineKind::Comment) {
+            idx++;
+        }
+        if (idx == code.size() || !match_line(line_pattern, code[idx], match)) {
+            return false;
+        }
+        match.line_idxs.push_back(idx++);
+    }
+    match.end = idx;
+
+    return rule.guard == nullptr || rule.guard(*this, match);
+}
+
+void PeepholeOptimizer::count_label_refs(const vector<AsmLine>& code) {
+    this->label_ref_counts.clear();
+    for (const AsmLine& line : code) {
+        if (line.kind != LineKind::Instruction) {
+            continue;
+        }
+        if (line.instruction.dst.kind == OperandKind::Label) {
+            this->label_ref_counts[get_label_key(line.instruction.dst)]++;
+        }
+        if (line.instruction.src.kind == OperandKind::Label) {
+            this->label_ref_counts[get_label_key(line.instruction.src)]++;
+        }
+    }
+}
+
+int PeepholeOptimizer::count_instructions(const vector<AsmLine>& code) {
+    return count_if(code.begin(), code.end(), [](const AsmLine& line) {
+        return line.kind == LineKind::Instruction;
+    });
+}
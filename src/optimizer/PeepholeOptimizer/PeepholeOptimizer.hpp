@@ -0,0 +1,123 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../../code-generator/AsmBuffer/AsmBuffer.hpp"
+#include "../../code-generator/CodeCache/CodeCache.hpp"
+#include "../../compiler-context/CompilerStats/CompilerStats.hpp"
+#include "../../worker-pool/include.hpp"
+
+using namespace std;
+
+/**
+ * @brief Operand of a pattern line. An exact pattern matches only its operand. A variable matches any
+ * operand and binds it, every other occurrence of the variable in the rule must then be the same operand.
+ */
+struct OperandPattern {
+    bool is_var;
+    int var;
+    Operand operand;
+
+    static OperandPattern exact(const Operand&);
+    static OperandPattern var_of(int);
+};
+
+enum class OpcodeMatch : unsigned char {
+    Exact, AnyOp, CondJump, InverseOfCondJump
+};
+
+/**
+ * @brief Line of a rule pattern or replacement, an instruction or a label whose dst is the label. In a
+ * pattern, AnyOp matches any instruction and CondJump any conditional jump. In a replacement, the opcode of
+ * the matched conditional jump is reused through InverseOfCondJump.
+ */
+struct LinePattern {
+    LineKind kind;
+    OpcodeMatch opcode_match;
+    Opcode opcode;
+    OperandPattern dst;
+    OperandPattern src;
+};
+
+const int MAX_PATTERN_VARS = 3;
+
+/**
+ * @brief Lines matched by a rule, with the operands bound to the variables of the rule.
+ */
+struct RuleMatch {
+    Operand vars[MAX_PATTERN_VARS];
+    bool is_bound[MAX_PATTERN_VARS];
+    Opcode cond_jump;
+    // the matched lines, comments in between are not part of the window
+    vector<int> line_idxs;
+    // index of the line after the window
+    int end;
+};
+
+class PeepholeOptimizer;
+
+/**
+ * @brief Rewrite of a window of consecutive instructions and labels into the replacement lines. The guard,
+ * if any, has to accept the match, for conditions that cannot be written as a pattern.
+ */
+struct PeepholeRule {
+    string name;
+    vector<LinePattern> pattern;
+    vector<LinePattern> replacement;
+    bool (*guard)(const PeepholeOptimizer&, const RuleMatch&);
+};
+
+/**
+ * @brief Window-based peephole optimizer over the code section. Every pass tries the rules of the rule
+ * table at each line, and replaces the windows they match. Passes are repeated until none of the rules
+ * match, as a rewrite can expose new matches. Replaced lines are removed from the code, comments inside a
+ * window are kept. Counts the hits of each rule.
+ *
+ * Windows never span procedures, so each procedure is rewritten on its own, on a pool of worker threads,
+ * and reaches the same code as if all were rewritten together. The program takes as many passes as its
+ * procedure that takes the most.
+ *
+ * With a code cache, the rewritten lines of a procedure and its counts are read from the cache when its lines
+ * are the same as when they were written, with the labels renumbered.
+ */
+class PeepholeOptimizer {
+    // number of threads the procedures are rewritten on
+    int job_count;
+    // cache of the rewritten procedures, nullptr if none
+    CodeCache* code_cache_ptr;
+    const vector<AsmLine>* code_ptr;
+    // references of the labels by jumps, keyed on the label kind and number
+    unordered_map<long long, int> label_ref_counts;
+
+    vector<int> hit_counts;
+    int pass_count;
+    int instructions_before;
+    int instructions_after;
+
+public:
+    PeepholeOptimizer(int = 1, CodeCache* = nullptr);
+
+    void optimize(vector<AsmLine>&);
+
+    int get_label_ref_count(const Operand&) const;
+
+    bool are_flags_dead_at(int) const;
+
+    void write_stats(ostream&) const;
+
+    void fill_stats(CompilerStats&) const;
+
+private:
+    void optimize_proc(vector<AsmLine>&);
+
+    void optimize_cached_proc(vector<AsmLine>&);
+
+    bool do_pass(vector<AsmLine>&);
+
+    bool match_rule(const PeepholeRule&, int, RuleMatch&) const;
+
+    void count_label_refs(const vector<AsmLine>&);
+
+    static int count_instructions(const vector<AsmLine>&);
+};
@@ -0,0 +1,5 @@
+#pragma once
+// headers
+#include "PeepholeOptimizer/PeepholeOptimizer.hpp"
+#include "DeadCodeEliminator/DeadCodeEliminator.hpp"
+#include "Inliner/Inliner.hpp"
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SourceBuffer.hpp"
+
+using namespace std;
+
+// NUL bytes the scanner needs after the scanned text
+const size_t SCAN_PADDING = 2;
+
+SourceBuffer::SourceBuffer()
+    : scan_buffer(nullptr), size(0), mapped_size(0), owned_buffer() {
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (this->mapped_size > 0) {
+        munmap(this->scan_buffer, this->mapped_size);
+    }
+}
+
+/**
+ * @brief Loads the source program.
+ *
+ * @param path Path of the source file, "-" for stdin
+ * @return true When the program is loaded
+ * @return false When the source file could not be opened or mapped
+ */
+bool SourceBuffer::open(const string& path) {
+    if (path == "-") {
+        return this->read_stdin();
+    }
+    return this->map_file(path);
+}
+
+/**
+ * @brief Returns the buffer to be scanned in place, text followed by two NUL bytes. The scanner
+ * temporarily writes into it.
+ */
+char* SourceBuffer::get_scan_buffer() {
+    return this->scan_buffer;
+}
+
+/**
+ * @brief Returns the size of the scan buffer, including the two NUL bytes.
+ */
+size_t SourceBuffer::get_scan_buffer_size() {
+    return this->size + SCAN_PADDING;
+}
+
+size_t SourceBuffer::get_size() {
+    return this->size;
+}
+
+/**
+ * @brief Returns a non-owning view of the text of a span, valid as long as the buffer lives.
+ */
+string_view SourceBuffer::get_text(const SourceSpan& span) {
+    return string_view(this->scan_buffer + span.begin, span.end - span.begin);
+}
+
+/**
+ * @brief Maps the source file privately, so the scanner's writes never reach the file. The file is mapped
+ * over a zeroed anonymous mapping of the padded size, which provides the NUL padding even when the file
+ * size is a multiple of the page size.
+ *
+ * @param path Path of the source file
+ * @return true When the file is mapped
+ * @return false Otherwise
+ */
+bool SourceBuffer::map_file(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return false;
+    }
+
+    this->size = file_stat.st_size;
+    this->mapped_size = this->size + SCAN_PADDING;
+    void* region = mmap(nullptr, this->mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        this->mapped_size = 0;
+        close(fd);
+        return false;
+    }
+
+    if (
+        this->size > 0 &&
+        mmap(region, this->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED
+    ) {
+        munmap(region, this->mapped_size);
+        this->mapped_size = 0;
+        close(fd);
+        return false;
+    }
+
+    close(fd); // mapping stays valid after closing
+    this->scan_buffer = static_cast<char*>(region);
+    return true;
+}
+
+/**
+ * @brief Reads all of stdin into the owned buffer, stdin cannot be mapped.
+ */
+bool SourceBuffer::read_stdin() {
+    this->owned_buffer.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    this->size = this->owned_buffer.size();
+    this->owned_buffer.resize(this->size + SCAN_PADDING, '\0');
+    this->scan_buffer = this->owned_buffer.data();
+    return !cin.bad();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../ast/SourceSpan/SourceSpan.hpp"
+
+using namespace std;
+
+/**
+ * @brief Source program held in memory for the scanner to scan in place. A source file is memory mapped,
+ * so it is never read or copied, stdin is read into an owned buffer. The buffer is followed by the two
+ * NUL bytes the scanner needs to scan it in place. Lexemes and AST nodes refer to the text by spans.
+ */
+class SourceBuffer {
+    char* scan_buffer;
+    size_t size;
+    size_t mapped_size;
+    vector<char> owned_buffer;
+
+public:
+    SourceBuffer();
+
+    ~SourceBuffer();
+
+    bool open(const string&);
+
+    char* get_scan_buffer();
+
+    size_t get_scan_buffer_size();
+
+    size_t get_size();
+
+    string_view get_text(const SourceSpan&);
+
+private:
+    bool map_file(const string&);
+
+    bool read_stdin();
+};
@@ -0,0 +1,3 @@
+#pragma once
+// headers
+#include "SourceBuffer/SourceBuffer.hpp"
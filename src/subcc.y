@@ -4,146 +4,149 @@
     #include <cstring>
     #include <cstdio>
     #include <string>
+    #include <string_view>
     #include <fstream>
     #include <sstream>
     #include <vector>
+    #include <map>
     #include <algorithm>
+    #include <filesystem>
     #include "./symbol-table/include.hpp"
+    #include "./ast/include.hpp"
+    #include "./code-generator/include.hpp"
+    #include "./optimizer/include.hpp"
+    #include "./source-buffer/include.hpp"
+    #include "./arena/include.hpp"
+    #include "./compiler-context/include.hpp"
+    #include "./worker-pool/include.hpp"
 
     using namespace std;
 
-    enum Phase {
-        Analysis, Synthesis
-    };
-
-    Phase phase;
-
-    extern FILE* yyin;
-    extern int line_count;
-
-    int yyparse();
-    int yylex();
-    void yyerror(char* str);
-
-    FILE* input_file;
-    ofstream log_file, error_file;
-
-    int error_count = 0;
-    const int SYM_TABLE_BUCKETS = 10;
-    SymbolTable symbol_table(SYM_TABLE_BUCKETS);
-
-    const string INT_TYPE = "int";
-    const string INT_ARRAY_TYPE = "int_arr";
-    const string FLOAT_TYPE = "float";
-    const string FLOAT_ARRAY_TYPE = "float_arr";
-    const string VOID_TYPE = "void";
-
-    SymbolInfo* current_func_sym_ptr =  nullptr;
-    vector<SymbolInfo*> params_for_func_scope;
-
-    const string TEMP_CODE_FILE_NAME = "_code.asm", CODE_FILE_NAME = "code.asm", 
-        OPTIM_CODE_FILE_NAME = "optimized_code.asm";
-    const string SOURCE_MAIN_FUNC_NAME = "__main__";
-
-    ofstream code_file;
-    const int DW_SZ = 2;
-
-    vector<SymbolInfo*> globals;
-    int current_stack_offset;
-
-    enum Label {
-        FOR_LOOP_CONDITION, FOR_LOOP_INCREMENT, FOR_LOOP_BODY, FOR_LOOP_END, WHILE_LOOP_CONDITION, 
-        WHILE_LOOP_BODY, WHILE_LOOP_END, ELSE_BODY, IF_ELSE_END, CMP_TRUE, CMP_FALSE, SHORT_CIRC
-    };
-
-    // number of label-requiring-statements encountered
-    int label_count = 0;
-    // depth of nested label-requiring-statements
-    int label_depth = 0;
-
     /**
         Analysis utils
     **/
     bool is_sym_func(SymbolInfo*);
     bool is_func_sym_defined(SymbolInfo*);
     bool is_func_signatures_match(SymbolInfo*, SymbolInfo*);
-    bool insert_into_symtable(string, string, string, vector<string> = {});
-    bool insert_into_symtable(SymbolInfo*);
-    bool insert_var_list_into_symtable(string, vector<string>);
-    void write_log(string, SymbolInfo*);
-    void write_error_log(string, string = "ERROR");
-    void write_symtable_in_log(SymbolTable&);
+    bool insert_into_symtable(CompilerContext&, int, string, SemanticType);
+    bool insert_into_symtable(CompilerContext&, SymbolInfo*);
+    bool insert_var_list_into_symtable(CompilerContext&, SemanticType, vector<ASTNode*>&);
+    void alloc_var_storage(CompilerContext&, CodeGenInfo*, int);
+    void resolve_var_storage(ASTNode*, SymbolInfo*);
+    vector<SemanticType> get_children_types(ASTNode*);
+    string_view lexeme(CompilerContext&, const SourceSpan&);
+    void write_log(CompilerContext&, string, const SourceSpan&);
+    void write_symtable_in_log(CompilerContext&);
 
     /**
         Synthesis utils
     **/
-    string get_label(Label, int=-1);
-    string _get_var_ref(SymbolInfo*);
-    vector<string> _get_activation_record_teardown_code();
-    void _alloc_int_var(string);
-    void _alloc_int_array(string, int);
-    void write_code(const string&, int=0);
-    void write_code(const vector<string>&, int=0);
-    void append_print_proc_def_to_codefile();
-    void structure_main_asm_codefile();
+    string structure_main_asm_code(AsmBuffer&, StringInterner&);
 
     /**
         Optimization utils
     **/
-    void peephole_optimization();
-    void do_peephole(vector<string>&);
-    void write_optimized_code_to_file(vector<string>&);
-    vector<string> load_code_into_mem();
-    
+    void peephole_optimization(CompilerContext&, AsmBuffer&, CodeCache*);
+
     /**
         General utils
     **/
-    bool starts_with(const string&, const string&);
-    vector<string> split_str(const string, const string);
-    string vec_to_str(vector<string>);
-    vector<string> split(string, char = ' ');
-    void replace_substr(string&, const string, const string);
-    void trim(string&);
-    void copy_txt_file(ifstream&, ofstream&);
-    void delete_debug_files();
+    int compile(CompilerContext&, const string&);
+    void write_compiler_stats(CompilerContext&, const string&);
+    int compile_batch(const CompilerOptions&, const vector<string>&);
+    bool create_output_dir(const CompilerOptions&);
+    CompilerOptions get_output_dir_options(const CompilerOptions&);
+    CompilerOptions get_source_options(const CompilerOptions&, const string&);
+    string get_output_prefix(const CompilerOptions&, const string&);
+    string types_to_str(const vector<SemanticType>&);
+    bool parse_args(int, char*[], CompilerOptions&, vector<string>&);
+    void delete_debug_files(CompilerContext&);
 %}
 
+%code requires {
+    #include "./symbol-table/include.hpp"
+    #include "./ast/include.hpp"
+    #include "./compiler-context/include.hpp"
+
+    // handle of a reentrant scanner, as flex declares it
+    #ifndef YY_TYPEDEF_YY_SCANNER_T
+    #define YY_TYPEDEF_YY_SCANNER_T
+    typedef void* yyscan_t;
+    #endif
+
+    // location of each grammar symbol is its span in the source buffer
+    #define YYLLOC_DEFAULT(Current, Rhs, N) \
+        do { \
+            if (N) { \
+                (Current).begin = YYRHSLOC(Rhs, 1).begin; \
+                (Current).end = YYRHSLOC(Rhs, N).end; \
+            } else { \
+                (Current).begin = (Current).end = YYRHSLOC(Rhs, 0).end; \
+            } \
+        } while (0)
+}
+
+%define api.location.type {SourceSpan}
+%locations
+
+// the parser and the scanner keep no state of their own, a compilation is reached through its context
+%define api.pure full
+%parse-param {CompilerContext& ctx} {yyscan_t scanner}
+%lex-param {yyscan_t scanner}
+
+%code provides {
+    int yylex(YYSTYPE*, YYLTYPE*, yyscan_t);
+    void yyerror(YYLTYPE*, CompilerContext&, yyscan_t, const char*);
+    void write_error_log(CompilerContext&, string, string = "ERROR");
+}
+
+%code {
+    struct yy_buffer_state;
+    int scan_token(YYSTYPE*, YYLTYPE*, yyscan_t);
+    CompilerContext* yyget_extra(yyscan_t);
+    int yylex_init_extra(CompilerContext*, yyscan_t*);
+    int yylex_destroy(yyscan_t);
+    yy_buffer_state* yy_scan_buffer(char*, size_t, yyscan_t);
+    void yy_delete_buffer(yy_buffer_state*, yyscan_t);
+}
+
 %union {
     SymbolInfo* SymPtr;
-    // int will be used to keep track of labeled statements' opening and closing label id in between nested statements
-    int IntVal;
+    ASTNode* NodePtr;
+    int NameId;
 }
 
 %token
     LPAREN RPAREN SEMICOLON COMMA LCURL RCURL INT FLOAT VOID LTHIRD RTHIRD FOR IF ELSE WHILE
     PRINTLN RETURN ASSIGNOP NOT INCOP DECOP
 
-%token<SymPtr>
-    ID CONST_INT CONST_FLOAT LOGICOP RELOP ADDOP MULOP
+// ID carries the handle of its name, interned by the scanner
+%token<NameId>
+    ID
+
+// lexemes of these tokens are read from the source buffer by their location
+%token
+    CONST_INT CONST_FLOAT LOGICOP RELOP ADDOP MULOP
 
 %type<SymPtr>
-    start program unit var_declaration func_definition type_specifier parameter_list
+    type_specifier
+
+%type<NodePtr>
+    start program unit var_declaration func_definition parameter_list
     compound_statement statements declaration_list statement expression_statement expression
-    variable rel_expression simple_expression term unary_expression factor func_declaration 
+    variable rel_expression simple_expression term unary_expression factor func_declaration
     func_signature compound_statement_start func_signature_start
-    
-// requires both int and syminfoptr
-%type
     logic_expression if_condition argument_list arguments
 
-%destructor {
-    delete $$;
-} <SymPtr>
-
 %right COMMA
 %right ASSIGNOP
 %left LOGICOP
 %left RELOP
-%left ADDOP 
+%left ADDOP
 %left MULOP
 %right NOT UNARY  // dummy token to reduce unary ADDOP before arithmetic ADDOP
-%left INCOP DECOP LPAREN RPAREN LTHIRD RTHIRD 
- // each rule gets its precedence from the last terminal symbol mentioned in the components by default. 
+%left INCOP DECOP LPAREN RPAREN LTHIRD RTHIRD
+ // each rule gets its precedence from the last terminal symbol mentioned in the components by default.
 
  // ELSE has higher precedence than dummy token SHIFT_ELSE (telling to shift ELSE, rather than reduce lone if)
 %nonassoc SHIFT_ELSE
@@ -151,1489 +154,877 @@
 
 %%
 
-start: 
+start:
     program {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "start", $1->get_semantic_type());
+        ctx.ast_root = $1;
 
-            string production = "start : program";
-            write_log(production, $$);
+        string production = "start : program";
+        write_log(ctx, production, @$);
 
-            write_symtable_in_log(symbol_table);
+        write_symtable_in_log(ctx);
 
-            YYACCEPT;
-        } else if (phase == Synthesis) {
-            append_print_proc_def_to_codefile();
-            YYACCEPT;
-        }
+        YYACCEPT;
     }
     ;
 
-program: 
+program:
     program unit {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "\n" + $2->get_symbol(), "program", VOID_TYPE);
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child($2);
 
-            string production = "program : program unit";
-            write_log(production, $$);
+        string production = "program : program unit";
+        write_log(ctx, production, @$);
 
-            write_symtable_in_log(symbol_table);
-        } else if (phase == Synthesis) {
-
-        }
-    }   
+        write_symtable_in_log(ctx);
+    }
     | unit {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "program", VOID_TYPE);
-
-            string production = "program : unit";
-            write_log(production, $$);
+        $$ = ctx.arena.create<ASTNode>(NodeKind::Program, @$, SemanticType::Void);
+        $$->add_child($1);
 
-            write_symtable_in_log(symbol_table);
-        } else if (phase == Synthesis) {
+        string production = "program : unit";
+        write_log(ctx, production, @$);
 
-        }
+        write_symtable_in_log(ctx);
     }
     ;
 
 unit:
     var_declaration {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "unit", VOID_TYPE);
+        $$ = $1;
 
-            string production = "unit : var_declaration";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "unit : var_declaration";
+        write_log(ctx, production, @$);
     }
     | func_declaration {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "unit", VOID_TYPE);
-
-            string production = "unit : func_declaration";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
 
-        }
+        string production = "unit : func_declaration";
+        write_log(ctx, production, @$);
     }
     | func_definition {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "unit", VOID_TYPE);
+        $$ = $1;
 
-            string production = "unit : func_definition";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            write_code("");
-        }
+        string production = "unit : func_definition";
+        write_log(ctx, production, @$);
     }
     ;
 
-func_declaration: 
+func_declaration:
     func_signature SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + ";", "func_declaration", VOID_TYPE);
-            // declaration, so no scope will be created, so have to manually insert the built func sym
-            insert_into_symtable(current_func_sym_ptr);
-
-            delete current_func_sym_ptr;
-            current_func_sym_ptr = nullptr;
-            params_for_func_scope.clear();
-
-            string production = "func_declaration : type_specifier ID LPAREN parameter_list RPAREN SEMICOLON";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            delete current_func_sym_ptr;
-            current_func_sym_ptr = nullptr;
-            params_for_func_scope.clear();
-        }
+        $$ = $1;
+        $$->set_span(@$);
+        // declaration, so no scope will be created, so have to manually insert the built func sym
+        insert_into_symtable(ctx, ctx.current_func_sym_ptr);
+
+        ctx.current_func_sym_ptr = nullptr;
+        ctx.params_for_func_scope.clear();
+
+        string production = "func_declaration : type_specifier ID LPAREN parameter_list RPAREN SEMICOLON";
+        write_log(ctx, production, @$);
     }
     ;
 
 func_definition:
     func_signature compound_statement {
-        if (phase == Analysis) {
-            if ($1->get_semantic_type() != VOID_TYPE && $2->get_semantic_type() == VOID_TYPE) {
-                write_error_log(current_func_sym_ptr->get_symbol() + 
-                    " with non void return type has to return something");
-            }
-
-            $$ = new SymbolInfo($1->get_symbol() +  "\n" + $2->get_symbol(), "func_definition", VOID_TYPE);
-
-            string production = "func_definition : type_specifier ID LPAREN parameter_list RPAREN compound_statement";
-            write_log(production, $$);
+        if ($1->get_semantic_type() != SemanticType::Void && $2->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, ctx.string_interner.get_string(ctx.current_func_sym_ptr->get_symbol_id()) +
+                " with non void return type has to return something");
+        }
 
-            current_func_sym_ptr->add_data("defined"); // to catch multiple definition error, but allow definition after declaration
-            current_func_sym_ptr = nullptr;
-        } else if (phase == Synthesis) {
-            if (current_func_sym_ptr->get_semantic_type() == VOID_TYPE) {
-                vector<string> code = _get_activation_record_teardown_code();
-                write_code(code, label_depth);
-            }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::FuncDefinition, @$, $1->get_semantic_type(), $1->get_name_id());
+        $$->adopt_children($1);
+        $$->add_child($2);
+        $$->set_count((-ctx.current_stack_offset) - 1); // slots of the frame, reserved at the entry
 
-            write_code("ENDP", --label_depth);
+        string production = "func_definition : type_specifier ID LPAREN parameter_list RPAREN compound_statement";
+        write_log(ctx, production, @$);
 
-            delete current_func_sym_ptr;
-            current_func_sym_ptr = nullptr;
-            params_for_func_scope.clear();
-            symbol_table.exit_scope();
-        }
+        ctx.current_func_sym_ptr->set_defined(true); // to catch multiple definition error, but allow definition after declaration
+        ctx.current_func_sym_ptr = nullptr;
     }
     ;
 
 func_signature:
     func_signature_start parameter_list RPAREN {
-        if (phase == Analysis) {
-            string return_type = $1->get_semantic_type();
-            string func_name = $1->get_symbol();
+        SemanticType return_type = $1->get_semantic_type();
+        int func_name_id = $1->get_name_id();
 
-            vector<string> param_type_list = $2->get_all_data(); 
-            if (param_type_list.empty()) {
-                param_type_list.push_back(VOID_TYPE); // if empty MUST HAVE VOID to know its a func
-            }
+        const FuncSignature* signature_ptr = ctx.signature_interner.intern(return_type, get_children_types($2));
 
-            $$ = new SymbolInfo(return_type + " " + func_name + "(" + $2->get_symbol() + 
-                ")", "func_signature", return_type, param_type_list);
+        $$ = $1;
+        $$->set_span(@$);
+        $$->adopt_children($2);
 
-            // definition will insert in compound_statement, declaration will insert in func_declaration
-            current_func_sym_ptr = new SymbolInfo(func_name, "ID", return_type, param_type_list);
-        } else if (phase == Synthesis) {
-
-        }
+        // definition will insert in compound_statement, declaration will insert in func_declaration
+        ctx.current_func_sym_ptr = ctx.arena.create<SymbolInfo>(func_name_id, "ID", return_type, signature_ptr);
     }
     | func_signature_start parameter_list error RPAREN {
-        if (phase == Analysis) {
-            string func_name = $1->get_symbol();
-            string return_type = $1->get_semantic_type();
+        SemanticType return_type = $1->get_semantic_type();
+        int func_name_id = $1->get_name_id();
 
-            vector<string> param_type_list = $2->get_all_data(); 
-            if (param_type_list.empty()) {
-                param_type_list.push_back(VOID_TYPE); // if empty MUST HAVE VOID to know its a func
-            }
+        const FuncSignature* signature_ptr = ctx.signature_interner.intern(return_type, get_children_types($2));
 
-            $$ = new SymbolInfo(return_type + " " + func_name + "(" + $2->get_symbol() + 
-                " [SYNTAX_ERR] )", "func_signature", return_type, param_type_list);
+        $$ = $1;
+        $$->set_span(@$);
+        $$->adopt_children($2);
 
-            current_func_sym_ptr = new SymbolInfo(func_name, "ID", return_type, param_type_list);
-        
-            // yyerror("resumed at RPAREN");
-            yyerrok;
-        } else if (phase == Synthesis) {
+        ctx.current_func_sym_ptr = ctx.arena.create<SymbolInfo>(func_name_id, "ID", return_type, signature_ptr);
 
-        }
+        // yyerror("resumed at RPAREN");
+        yyerrok;
     }
     ;
 
 func_signature_start:
     type_specifier ID LPAREN {
-        if (phase == Analysis) {
-            string return_type = $1->get_symbol();
-            string func_name = $2->get_symbol();
-            $$ = new SymbolInfo(func_name, "func_signature_start", return_type);
-        } else if (phase == Synthesis) {
-            string ret_type = $1->get_symbol();
-            string func_name = $2->get_symbol();
-
-            current_func_sym_ptr = new SymbolInfo(func_name, "ID", ret_type);
-        }
+        SemanticType return_type = $1->get_semantic_type();
+        $$ = ctx.arena.create<ASTNode>(NodeKind::FuncDeclaration, @$, return_type, $2);
     }
 
 parameter_list:
     parameter_list COMMA type_specifier ID {
-        if (phase == Analysis) {
-            string param_type = $3->get_symbol();
-            string param_name = $4->get_symbol();
-
-            vector<string> param_type_list = $1->get_all_data(); // for $$ symbol info data list
-            if (param_type != VOID_TYPE) {
-                param_type_list.push_back(param_type);
-                params_for_func_scope.push_back(new SymbolInfo(param_name, "ID", param_type));
-            } else {
-                write_error_log("parameters cannot be void type");
-            }
-
-            $$ = new SymbolInfo($1->get_symbol() + "," + param_type + " " + 
-                param_name, "parameter_list", VOID_TYPE, param_type_list);
-
-            string production = "parameter_list : parameter_list COMMA type_specifier ID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string param_type = $3->get_symbol();
-            string param_name = $4->get_symbol();
-            current_func_sym_ptr->add_data(param_type);
-            
-            params_for_func_scope.push_back(new SymbolInfo(param_name, "ID", param_type)); // .clear() calls delete
+        SemanticType param_type = $3->get_semantic_type();
+        int param_name_id = $4;
+
+        $$ = $1;
+        $$->set_span(@$);
+        if (param_type != SemanticType::Void) {
+            $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Parameter, SourceSpan{ @3.begin, @4.end }, param_type,
+                param_name_id));
+            ctx.params_for_func_scope.push_back(ctx.arena.create<SymbolInfo>(param_name_id, "ID", param_type));
+        } else {
+            write_error_log(ctx, "parameters cannot be void type");
         }
+
+        string production = "parameter_list : parameter_list COMMA type_specifier ID";
+        write_log(ctx, production, @$);
     }
     | parameter_list COMMA type_specifier {
-        if (phase == Analysis) {
-            string param_type = $3->get_symbol();
-
-            vector<string> param_type_list = $1->get_all_data();
-            if (param_type != VOID_TYPE) {
-                param_type_list.push_back(param_type);
-            } else {
-                write_error_log("parameters cannot be void type");
-            }
-
-            $$ = new SymbolInfo($1->get_symbol() + "," + param_type, "parameter_list", VOID_TYPE, param_type_list);
-
-            string production = "parameter_list : parameter_list COMMA type_specifier";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        SemanticType param_type = $3->get_semantic_type();
 
+        $$ = $1;
+        $$->set_span(@$);
+        if (param_type != SemanticType::Void) {
+            $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Parameter, @3, param_type));
+        } else {
+            write_error_log(ctx, "parameters cannot be void type");
         }
+
+        string production = "parameter_list : parameter_list COMMA type_specifier";
+        write_log(ctx, production, @$);
     }
     | type_specifier ID {
-        if (phase == Analysis) {
-            string param_type = $1->get_symbol();
-            string param_name = $2->get_symbol();
-
-            vector<string> param_type_list;
-            if (param_type != VOID_TYPE) {
-                param_type_list.push_back(param_type);
-                params_for_func_scope.push_back(new SymbolInfo(param_name, "ID", param_type));
-            } else {
-                write_error_log("parameters cannot be void type");
-            }
+        SemanticType param_type = $1->get_semantic_type();
+        int param_name_id = $2;
 
-            $$ = new SymbolInfo(param_type + " " + param_name, "parameter_list", VOID_TYPE, 
-                param_type_list);
-
-            string production = "parameter_list : type_specifier ID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string param_type = $1->get_symbol();
-            string param_name = $2->get_symbol();
-            current_func_sym_ptr->add_data(param_type);
-            
-            params_for_func_scope.push_back(new SymbolInfo(param_name, "ID", param_type));
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        if (param_type != SemanticType::Void) {
+            $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Parameter, @$, param_type, param_name_id));
+            ctx.params_for_func_scope.push_back(ctx.arena.create<SymbolInfo>(param_name_id, "ID", param_type));
+        } else {
+            write_error_log(ctx, "parameters cannot be void type");
         }
+
+        string production = "parameter_list : type_specifier ID";
+        write_log(ctx, production, @$);
     }
     | type_specifier {
-        if (phase == Analysis) {
-            string param_type = $1->get_symbol();
-
-            vector<string> param_type_list;
-            if (param_type != VOID_TYPE) {
-                param_type_list.push_back(param_type);
-            }
-            
-            $$ = new SymbolInfo($1->get_symbol(), "parameter_list", VOID_TYPE, 
-                param_type_list);
-
-            string production = "parameter_list : type_specifier";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        SemanticType param_type = $1->get_semantic_type();
 
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        if (param_type != SemanticType::Void) {
+            $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Parameter, @$, param_type));
         }
+
+        string production = "parameter_list : type_specifier";
+        write_log(ctx, production, @$);
     }
     | %empty {
-        if (phase == Analysis) {
-            // empty param list will be added VOID_TYPE in function_signture
-            $$ = new SymbolInfo("", "parameter_list", VOID_TYPE);
-            string production = "parameter_list : epsilon";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            // empty param list will be added VOID_TYPE in function_signture
-            current_func_sym_ptr->add_data(VOID_TYPE);
-        }
+        // functions without parameters get an empty parameter list in their signature
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        string production = "parameter_list : epsilon";
+        write_log(ctx, production, @$);
     }
     ;
 
 compound_statement:
     compound_statement_start statements RCURL {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "\n" + $2->get_symbol() + "\n}", "compound_statement", 
-                $2->get_semantic_type());
+        $$ = $2;
+        $$->set_span(@$);
 
-            string production = "compound_statement : LCURL statements RCURL";
-            write_log(production, $$);
+        string production = "compound_statement : LCURL statements RCURL";
+        write_log(ctx, production, @$);
 
-            write_symtable_in_log(symbol_table);
-            symbol_table.exit_scope();
-        } else if (phase == Synthesis) {
-            symbol_table.exit_scope();
-        }
+        write_symtable_in_log(ctx);
+        ctx.symbol_table.exit_scope();
     }
     | compound_statement_start RCURL {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "\n}", "compound_statement", VOID_TYPE);
+        $$ = $1;
+        $$->set_span(@$);
 
-            string production = "compound_statement : LCURL RCURL";
-            write_log(production, $$);
+        string production = "compound_statement : LCURL RCURL";
+        write_log(ctx, production, @$);
 
-            write_symtable_in_log(symbol_table);
-            symbol_table.exit_scope();
-        } else if (phase == Synthesis) {
-            symbol_table.exit_scope();
-        }
+        write_symtable_in_log(ctx);
+        ctx.symbol_table.exit_scope();
     }
     | error RCURL {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("{\n[SYNTAX_ERR]\n}", "compound_statement", VOID_TYPE);
-
-            write_symtable_in_log(symbol_table);
-            symbol_table.exit_scope();
+        $$ = ctx.arena.create<ASTNode>(NodeKind::CompoundStatement, @$, SemanticType::Void);
 
-            // yyerror("resumed at RCULR");
-            yyerrok;
-        } else if (phase == Synthesis) {
+        write_symtable_in_log(ctx);
+        ctx.symbol_table.exit_scope();
 
-        }
+        // yyerror("resumed at RCULR");
+        yyerrok;
     }
     ;
 
 compound_statement_start:
     LCURL {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("{", "LCURL", VOID_TYPE);
-            SymbolInfo* existing_symbol_ptr = symbol_table.lookup(current_func_sym_ptr->get_symbol());
+        $$ = ctx.arena.create<ASTNode>(NodeKind::CompoundStatement, @$, SemanticType::Void);
+
+        if (ctx.symbol_table.get_current_scope_depth() > 1) {
+            // block inside a function body
+            ctx.symbol_table.enter_scope();
+        } else {
+            SymbolInfo* existing_symbol_ptr = ctx.symbol_table.lookup(ctx.current_func_sym_ptr->get_symbol_id());
             if (
-                existing_symbol_ptr != nullptr && is_sym_func(existing_symbol_ptr) && 
+                existing_symbol_ptr != nullptr && is_sym_func(existing_symbol_ptr) &&
                 !is_func_sym_defined(existing_symbol_ptr)
             ) {
                 // previously declared but not defined, okay
-                if (!is_func_signatures_match(current_func_sym_ptr, existing_symbol_ptr)) {
-                    write_error_log(current_func_sym_ptr->get_symbol() + 
+                if (!is_func_signatures_match(ctx.current_func_sym_ptr, existing_symbol_ptr)) {
+                    write_error_log(ctx, ctx.string_interner.get_string(ctx.current_func_sym_ptr->get_symbol_id()) +
                         " definition does not match declaration signature");
                 }
-            } else if (insert_into_symtable(current_func_sym_ptr)) {
-                SymbolInfo* old_func_sym_ptr = current_func_sym_ptr;
-                current_func_sym_ptr = symbol_table.lookup(current_func_sym_ptr->get_symbol());
-                delete old_func_sym_ptr;
-            } 
+            } else if (insert_into_symtable(ctx, ctx.current_func_sym_ptr)) {
+                ctx.current_func_sym_ptr = ctx.symbol_table.lookup(ctx.current_func_sym_ptr->get_symbol_id());
+            }
 
-            symbol_table.enter_scope();
+            ctx.symbol_table.enter_scope();
 
-            for (SymbolInfo* param_symbol : params_for_func_scope) {
-                insert_into_symtable(param_symbol);
+            // params are above the return IP, which is at offset 0 (BP), locals are below
+            ctx.current_stack_offset = ctx.params_for_func_scope.size();
+            for (SymbolInfo* param_symbol : ctx.params_for_func_scope) {
+                param_symbol->get_codegen_info_ptr()->set_is_local(true);
+                param_symbol->get_codegen_info_ptr()->set_stack_offset(ctx.current_stack_offset--);
+                insert_into_symtable(ctx, param_symbol);
             }
+            ctx.current_stack_offset--; // one extra position stores the return IP (at BP, offset=0)
 
-            params_for_func_scope.clear();
-        } else if (phase == Synthesis) {
-            // start of new scope, but need to check if start of new function before setting up symbol table
-            symbol_table.enter_scope();
-
-            if (label_depth == 0) {
-                // only global functions allowed (depth=0)
-                current_stack_offset = params_for_func_scope.size(); // offset 0 is for return IP, paramsize+1 is for old BP. 
-                for (SymbolInfo* param_symbol : params_for_func_scope) {
-                    param_symbol->get_codegen_info_ptr()->set_is_local(true);
-                    param_symbol->get_codegen_info_ptr()->set_stack_offset(current_stack_offset--);
-                    insert_into_symtable(param_symbol);
-                }
-                current_stack_offset--; // one extra position stores the return IP (at BP, offset=0)
-        
-                string func_name = current_func_sym_ptr->get_symbol();
-                func_name = func_name == "main" ? SOURCE_MAIN_FUNC_NAME : func_name;
-                string code = func_name + " PROC";
-                write_code(code, label_depth++);
-
-                code = "MOV BP, SP"; // set new BP, with params above, locals below - return IP pointed at
-                write_code(code, label_depth);
-            }
+            ctx.params_for_func_scope.clear();
         }
     }
     | error LCURL {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("[SYNTAX_ERR] {", "LCURL", VOID_TYPE);    
-            symbol_table.enter_scope();
-
-            for (SymbolInfo* param_symbol : params_for_func_scope) {
-                insert_into_symtable(param_symbol);
-            }
-
-            params_for_func_scope.clear();
-            yyerrok;
-        } else if (phase == Synthesis) {
+        $$ = ctx.arena.create<ASTNode>(NodeKind::CompoundStatement, @$, SemanticType::Void);
+        ctx.symbol_table.enter_scope();
 
+        for (SymbolInfo* param_symbol : ctx.params_for_func_scope) {
+            insert_into_symtable(ctx, param_symbol);
         }
+
+        ctx.params_for_func_scope.clear();
+        yyerrok;
     }
     ;
 
 var_declaration:
     type_specifier declaration_list SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + " " + $2->get_symbol() + ";\n", "var_declaration", VOID_TYPE);
+        $$ = ctx.arena.create<ASTNode>(NodeKind::VarDeclaration, @$, SemanticType::Void);
 
-            string var_type = $1->get_symbol();
-            vector<string> var_names = split($2->get_symbol(), ',');
-            insert_var_list_into_symtable(var_type, var_names);
+        SemanticType var_type = $1->get_semantic_type();
+        insert_var_list_into_symtable(ctx, var_type, $2->get_children());
+        $$->adopt_children($2);
 
-            string production = "var_declaration : type_specifier declaration_list SEMICOLON";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "var_declaration : type_specifier declaration_list SEMICOLON";
+        write_log(ctx, production, @$);
     }
     | error SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("[SYNTAX_ERR] ;\n", "var_declaration", VOID_TYPE);
-            yyerrok;
-        } else if (phase == Synthesis) {
-
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::VarDeclaration, @$, SemanticType::Void);
+        yyerrok;
     }
     ;
 
 type_specifier:
     INT {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("int", "type_specifier", VOID_TYPE);
+        $$ = ctx.arena.create<SymbolInfo>(ctx.string_interner.intern("int"), "type_specifier", SemanticType::Int);
 
-            string production = "type_specifier : INT";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            $$ = new SymbolInfo(INT_TYPE, "type_specifier");
-        }
+        string production = "type_specifier : INT";
+        write_log(ctx, production, @$);
     }
     | FLOAT {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("float", "type_specifier", VOID_TYPE);
+        $$ = ctx.arena.create<SymbolInfo>(ctx.string_interner.intern("float"), "type_specifier", SemanticType::Float);
 
-            string production = "type_specifier : FLOAT";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            $$ = new SymbolInfo(FLOAT_TYPE, "type_specifier");
-        }
+        string production = "type_specifier : FLOAT";
+        write_log(ctx, production, @$);
     }
     | VOID {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("void", "type_specifier", VOID_TYPE);
+        $$ = ctx.arena.create<SymbolInfo>(ctx.string_interner.intern("void"), "type_specifier", SemanticType::Void);
 
-            string production = "type_specifier : VOID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            $$ = new SymbolInfo(VOID_TYPE, "type_specifier");
-        }
+        string production = "type_specifier : VOID";
+        write_log(ctx, production, @$);
     }
     ;
 
+ // declarators are created with SemanticType::Void, or SemanticType::IntArray for arrays, the declared type is set
+ // on insertion
 declaration_list:
     declaration_list COMMA ID {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "," + $3->get_symbol(), "declaration_list", VOID_TYPE);
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Declarator, @3, SemanticType::Void, $3));
 
-            string production = "declaration_list : declaration_list COMMA ID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            _alloc_int_var($3->get_symbol());
-        }
+        string production = "declaration_list : declaration_list COMMA ID";
+        write_log(ctx, production, @$);
     }
     | declaration_list COMMA ID LTHIRD CONST_INT RTHIRD {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "," + $3->get_symbol() + 
-                "[" + $5->get_symbol() + "]", "declaration_list", VOID_TYPE);
-
-            string production = "declaration_list : declaration_list COMMA ID LTHIRD CONST_INT RTHIRD";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            _alloc_int_array($3->get_symbol(), stoi($5->get_symbol()));
-        }
+        ASTNode* declarator_ptr = ctx.arena.create<ASTNode>(NodeKind::Declarator, SourceSpan{ @3.begin, @6.end },
+            SemanticType::IntArray, $3);
+        declarator_ptr->set_count(stoi(string(lexeme(ctx, @5))));
+
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child(declarator_ptr);
+
+        string production = "declaration_list : declaration_list COMMA ID LTHIRD CONST_INT RTHIRD";
+        write_log(ctx, production, @$);
     }
     | ID {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "declaration_list", VOID_TYPE);
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Declarator, @$, SemanticType::Void, $1));
 
-            string production = "declaration_list : ID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            _alloc_int_var($1->get_symbol());
-        }
+        string production = "declaration_list : ID";
+        write_log(ctx, production, @$);
     }
     | ID LTHIRD CONST_INT RTHIRD {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "[" + $3->get_symbol() + "]", "declaration_list", VOID_TYPE);
+        ASTNode* declarator_ptr = ctx.arena.create<ASTNode>(NodeKind::Declarator, @$, SemanticType::IntArray, $1);
+        declarator_ptr->set_count(stoi(string(lexeme(ctx, @3))));
 
-            string production = "declaration_list : ID LTHIRD CONST_INT RTHIRD";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            _alloc_int_array($1->get_symbol(), stoi($3->get_symbol()));
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        $$->add_child(declarator_ptr);
+
+        string production = "declaration_list : ID LTHIRD CONST_INT RTHIRD";
+        write_log(ctx, production, @$);
     }
     | declaration_list error COMMA ID {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "," + $4->get_symbol(), "declaration_list", VOID_TYPE);
-
-            string production = "declaration_list : ID LTHIRD CONST_INT RTHIRD";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child(ctx.arena.create<ASTNode>(NodeKind::Declarator, @4, SemanticType::Void, $4));
 
-        }
+        string production = "declaration_list : ID LTHIRD CONST_INT RTHIRD";
+        write_log(ctx, production, @$);
     }
     ;
 
 statements:
     statement {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "statements", $1->get_semantic_type());
+        $$ = ctx.arena.create<ASTNode>(NodeKind::CompoundStatement, @$, $1->get_semantic_type());
+        $$->add_child($1);
 
-            string production = "statements : statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "statements : statement";
+        write_log(ctx, production, @$);
     }
     | statements statement {
-        if (phase == Analysis) {
-            string statement_type = VOID_TYPE;
-            if  ($1->get_semantic_type() == FLOAT_TYPE || $2->get_semantic_type() == FLOAT_TYPE) {
-                statement_type = FLOAT_TYPE;
-            } else if ($1->get_semantic_type() == INT_TYPE || $2->get_semantic_type() == INT_TYPE) {
-                statement_type = INT_TYPE;
-            }
+        SemanticType statement_type = SemanticType::Void;
+        if  ($1->get_semantic_type() == SemanticType::Float || $2->get_semantic_type() == SemanticType::Float) {
+            statement_type = SemanticType::Float;
+        } else if ($1->get_semantic_type() == SemanticType::Int || $2->get_semantic_type() == SemanticType::Int) {
+            statement_type = SemanticType::Int;
+        }
 
-            $$ = new SymbolInfo($1->get_symbol() + "\n" + $2->get_symbol(), "statements", statement_type);
-            
-            string production = "statements : statements statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child($2);
+        $$->set_semantic_type(statement_type);
 
-        }
+        string production = "statements : statements statement";
+        write_log(ctx, production, @$);
     }
     ;
 
 statement:
     var_declaration {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "statement", VOID_TYPE);
-
-            string production = "statement : var_declaration";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
 
-        }
+        string production = "statement : var_declaration";
+        write_log(ctx, production, @$);
     }
     | expression_statement {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "statement", VOID_TYPE);
-
-            string production = "statement : expression_statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
+        $$->set_semantic_type(SemanticType::Void);
 
-        }
+        string production = "statement : expression_statement";
+        write_log(ctx, production, @$);
     }
     | compound_statement {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "statement", $1->get_semantic_type());
+        $$ = $1;
 
-            string production = "statement : compound_statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "statement : compound_statement";
+        write_log(ctx, production, @$);
     }
-    | FOR LPAREN expression_statement {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            vector<string> code{
-                "; FOR LOOP START", 
-                get_label(FOR_LOOP_CONDITION) + ":"
-            };
-            // $S will be used as a label identifier, so we can label corresponding opening and closing labels with same id
-            write_code(code, label_depth);
-
-            $<IntVal>$ = label_count - 1; 
-        }
-    } expression_statement {
-        if (phase == Analysis) {
-            if ($5->get_semantic_type() == VOID_TYPE) {
-                write_error_log("for conditional expression cannot be void type");
-            }
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>4;
-            vector<string> code{
-                "; FOR LOOP CONDITION CHECK",
-                "CMP AX, 0", 
-                "JNE " + get_label(FOR_LOOP_BODY, CURR_LABEL_ID), 
-                "JMP " + get_label(FOR_LOOP_END, CURR_LABEL_ID),
-                get_label(FOR_LOOP_INCREMENT, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, label_depth);
-
-            $<IntVal>$ = $<IntVal>4;
-        }
-    } expression RPAREN {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>6;
-            vector<string> code{
-                "JMP " + get_label(FOR_LOOP_CONDITION, CURR_LABEL_ID),
-                get_label(FOR_LOOP_BODY, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, label_depth++);
-
-            $<IntVal>$ = $<IntVal>6;
-        }
-    } statement {
-        if (phase == Analysis) {    
-            $$ = new SymbolInfo("for (" + $3->get_symbol() + " " + $5->get_symbol() + " " + 
-                $7->get_symbol() + ")\n" + $10->get_symbol(), "statement", $10->get_semantic_type());
-
-            string production = "statement : FOR LPAREN expression_statement expression_statement expression RPAREN statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>9;
-            vector<string> code{
-                "JMP " + get_label(FOR_LOOP_INCREMENT, CURR_LABEL_ID), 
-                get_label(FOR_LOOP_END, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, --label_depth);
+    | FOR LPAREN expression_statement expression_statement {
+        if ($4->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "for conditional expression cannot be void type");
         }
+    } expression RPAREN statement {
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ForStatement, @$, $8->get_semantic_type());
+        $$->add_child($3);
+        $$->add_child($4);
+        $$->add_child($6);
+        $$->add_child($8);
+
+        string production = "statement : FOR LPAREN expression_statement expression_statement expression RPAREN statement";
+        write_log(ctx, production, @$);
     }
-    | if_condition statement 
+    | if_condition statement
     %prec SHIFT_ELSE {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($<SymPtr>1->get_symbol() + "\n" + $2->get_symbol(), "statement", 
-                $2->get_semantic_type());
-
-            string production = "statement : IF LPAREN expression RPAREN statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>1;
-            vector<string> code{
-                get_label(ELSE_BODY, CURR_LABEL_ID) + ":", // if_condition always assumes if-else, so dummy else label
-                get_label(IF_ELSE_END, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, --label_depth);    
-        }
-    }
-    | if_condition statement ELSE {
-        if (phase == Analysis) {
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child($2);
+        $$->set_semantic_type($2->get_semantic_type());
 
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>1;
-            vector<string> code{
-                "JMP " + get_label(IF_ELSE_END, CURR_LABEL_ID), // if body execution ends in jumping over else body
-                get_label(ELSE_BODY, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, label_depth-1);
-
-            $<IntVal>$ = $<IntVal>1;
+        string production = "statement : IF LPAREN expression RPAREN statement";
+        write_log(ctx, production, @$);
+    }
+    | if_condition statement ELSE statement {
+        SemanticType statement_type = SemanticType::Void;
+        if  ($2->get_semantic_type() == SemanticType::Float || $4->get_semantic_type() == SemanticType::Float) {
+            statement_type = SemanticType::Float;
+        } else if ($2->get_semantic_type() == SemanticType::Int || $4->get_semantic_type() == SemanticType::Int) {
+            statement_type = SemanticType::Int;
         }
-    } statement {
-        if (phase == Analysis) {
-            string statement_type = VOID_TYPE;
-            if  ($2->get_semantic_type() == FLOAT_TYPE || $5->get_semantic_type() == FLOAT_TYPE) {
-                statement_type = FLOAT_TYPE;
-            } else if ($2->get_semantic_type() == INT_TYPE || $5->get_semantic_type() == INT_TYPE) {
-                statement_type = INT_TYPE;
-            }
 
-            $$ = new SymbolInfo($<SymPtr>1->get_symbol() + "\n" + $2->get_symbol() + " else " + 
-                $5->get_symbol(), "statement", statement_type);
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child($2);
+        $$->add_child($4);
+        $$->set_semantic_type(statement_type);
 
-            string production = "statement : IF LPAREN expression RPAREN statement ELSE statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>4;
-            string code = get_label(IF_ELSE_END, CURR_LABEL_ID) + ":";
-            write_code(code, --label_depth);
-        }
+        string production = "statement : IF LPAREN expression RPAREN statement ELSE statement";
+        write_log(ctx, production, @$);
     }
-    | WHILE LPAREN {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            vector<string> code{
-                "; WHILE LOOP START",
-                get_label(WHILE_LOOP_CONDITION) + ":"
-            };
-            write_code(code, label_depth);
-
-            $<IntVal>$ = label_count - 1;
-        }
-    } expression RPAREN {
-        if (phase == Analysis) {
-            if ($4->get_semantic_type() == VOID_TYPE) {
-                write_error_log("while loop expression cannot be void type");
-            }
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>3;
-            vector<string> code{
-                "; WHILE LOOP CONDITION CHECK",
-                "CMP AX, 0", 
-                "JNE " + get_label(WHILE_LOOP_BODY, CURR_LABEL_ID), 
-                "JMP " + get_label(WHILE_LOOP_END, CURR_LABEL_ID), 
-                get_label(WHILE_LOOP_BODY, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, label_depth++);
-
-            $<IntVal>$ = $<IntVal>3;
+    | WHILE LPAREN expression RPAREN {
+        if ($3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "while loop expression cannot be void type");
         }
     } statement {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("while (" + $4->get_symbol() + ")\n" + $7->get_symbol(), "statement", 
-                $7->get_semantic_type());
-
-            string production = "statement : WHILE LPAREN expression RPAREN statement";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            const int CURR_LABEL_ID = $<IntVal>6;
-            vector<string> code{
-                "JMP " + get_label(WHILE_LOOP_CONDITION, CURR_LABEL_ID), 
-                get_label(WHILE_LOOP_END, CURR_LABEL_ID) + ":"
-            };
-            write_code(code, --label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::WhileStatement, @$, $6->get_semantic_type());
+        $$->add_child($3);
+        $$->add_child($6);
+
+        string production = "statement : WHILE LPAREN expression RPAREN statement";
+        write_log(ctx, production, @$);
     }
     | PRINTLN LPAREN variable RPAREN SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("printf(" + $3->get_symbol() + ");", "statement", VOID_TYPE);
-
-            string production = "statement : PRINTLN LPAREN ID RPAREN SEMICOLON";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            SymbolInfo* var_sym = symbol_table.lookup($3->get_symbol());
-            string var_ref = _get_var_ref(var_sym);
-            vector<string> code{
-                "; PRINT STATEMENT VAR " + var_sym->get_symbol(), 
-                "MOV AX, " + var_ref, 
-                "CALL PRINT_INT_IN_AX"
-            };
-            write_code(code, label_depth);    
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::PrintlnStatement, @$, SemanticType::Void);
+        $$->add_child($3);
+
+        string production = "statement : PRINTLN LPAREN ID RPAREN SEMICOLON";
+        write_log(ctx, production, @$);
     }
     | RETURN expression SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("return " + $2->get_symbol() + ";", "statement", $2->get_semantic_type());
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ReturnStatement, @$, $2->get_semantic_type());
+        $$->add_child($2);
 
-            string production = "statement : RETURN expression SEMICOLON";
-            write_log(production, $$);
+        string production = "statement : RETURN expression SEMICOLON";
+        write_log(ctx, production, @$);
 
-            string expression_type = $2->get_semantic_type();
-            string func_return_type = VOID_TYPE;
-            if (current_func_sym_ptr != nullptr) {
-                func_return_type = current_func_sym_ptr->get_semantic_type();
-            }
+        SemanticType expression_type = $2->get_semantic_type();
+        SemanticType func_return_type = SemanticType::Void;
+        if (ctx.current_func_sym_ptr != nullptr) {
+            func_return_type = ctx.current_func_sym_ptr->get_semantic_type();
+        }
 
-            if (func_return_type == FLOAT_TYPE && expression_type == INT_TYPE) {
-                // okay
-            } else if (func_return_type == INT_TYPE && expression_type == FLOAT_TYPE) {
-                write_error_log("Returning float type from a function with int return type", "WARNING");
-            } else if (func_return_type != expression_type) {
-                write_error_log("Cannot return " + expression_type + " from a function of " + 
-                    func_return_type + " return type");
-            }
-        } else if (phase == Synthesis) {
-            vector<string> code = _get_activation_record_teardown_code();
-            write_code(code, label_depth);
+        if (func_return_type == SemanticType::Float && expression_type == SemanticType::Int) {
+            // okay
+        } else if (func_return_type == SemanticType::Int && expression_type == SemanticType::Float) {
+            write_error_log(ctx, "Returning float type from a function with int return type", "WARNING");
+        } else if (func_return_type != expression_type) {
+            write_error_log(ctx, "Cannot return " + get_type_name(expression_type) + " from a function of " +
+                get_type_name(func_return_type) + " return type");
         }
     }
     ;
 
 if_condition:
     IF LPAREN expression RPAREN {
-        if (phase == Analysis) {
-            if ($3->get_semantic_type() == VOID_TYPE) {
-                write_error_log("if expression cannot be void type");
-            }
-            $<SymPtr>$ = new SymbolInfo("if (" + $3->get_symbol() + ")", "if_condition", VOID_TYPE);
-        } else if (phase == Synthesis) {
-            vector<string> code{
-                "; IF STATEMENT START",
-                "CMP AX, 0", 
-                "JE " + get_label(ELSE_BODY)
-            };
-            write_code(code, label_depth++);
-
-            $<IntVal>$ = label_count - 1;
+        if ($3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "if expression cannot be void type");
         }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::IfStatement, @$, SemanticType::Void);
+        $$->add_child($3);
     }
 
 expression_statement:
     SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo(";\n", "expression_statement", VOID_TYPE);
-
-            string production = "expression_statement : SEMICOLON";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ExpressionStatement, @$, SemanticType::Void);
 
-        }
+        string production = "expression_statement : SEMICOLON";
+        write_log(ctx, production, @$);
     }
     | expression SEMICOLON {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + ";\n", "expression_statement", $1->get_semantic_type());
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ExpressionStatement, @$, $1->get_semantic_type());
+        $$->add_child($1);
 
-            string production = "expression_statement : expression SEMICOLON";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            
-        }
+        string production = "expression_statement : expression SEMICOLON";
+        write_log(ctx, production, @$);
     }
     ;
 
 variable:
     ID {
-        if (phase == Analysis) {
-            string var_name = $1->get_symbol();
-            SymbolInfo* var_sym_ptr = symbol_table.lookup(var_name);
-            string var_type = INT_TYPE;
+        const string& var_name = ctx.string_interner.get_string($1);
+        SymbolInfo* var_sym_ptr = ctx.symbol_table.lookup($1);
+        SemanticType var_type = SemanticType::Int;
 
-            if (var_sym_ptr == nullptr) {
-                write_error_log(var_name + " does not exist");
-            } else {
-                var_type = var_sym_ptr->get_semantic_type();
-            }
+        if (var_sym_ptr == nullptr) {
+            write_error_log(ctx, var_name + " does not exist");
+        } else {
+            var_type = var_sym_ptr->get_semantic_type();
+        }
 
-            if (var_type == INT_ARRAY_TYPE) {
-                write_error_log(var_name + " is an array and has to be indexed");
-                var_type = INT_TYPE;
-            } else if (var_type == FLOAT_ARRAY_TYPE) {
-                write_error_log(var_name + " is an array and has to be indexed");
-                var_type = FLOAT_TYPE;
-            }
+        if (var_type == SemanticType::IntArray) {
+            write_error_log(ctx, var_name + " is an array and has to be indexed");
+            var_type = SemanticType::Int;
+        } else if (var_type == SemanticType::FloatArray) {
+            write_error_log(ctx, var_name + " is an array and has to be indexed");
+            var_type = SemanticType::Float;
+        }
 
-            $$ = new SymbolInfo($1->get_symbol(), "variable", var_type);
+        $$ = ctx.arena.create<ASTNode>(NodeKind::Variable, @$, var_type, $1);
+        resolve_var_storage($$, var_sym_ptr);
 
-            string production = "variable : ID";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            // can be l value or r value - so not resolving now, just inheritting symbol name to find in sym table.
-            $$ = $1;
-        }
+        string production = "variable : ID";
+        write_log(ctx, production, @$);
     }
     | ID LTHIRD expression RTHIRD {
-        if (phase == Analysis) {
-            if ($3->get_semantic_type() != INT_TYPE) {
-                write_error_log("array index can only be int type");
-            }
-
-            string var_name = $1->get_symbol();
-            SymbolInfo* var_sym_ptr = symbol_table.lookup(var_name);
-            string var_type = INT_ARRAY_TYPE;
+        if ($3->get_semantic_type() != SemanticType::Int) {
+            write_error_log(ctx, "array index can only be int type");
+        }
 
-            if (var_sym_ptr == nullptr) {
-                write_error_log(var_name + " does not exist");
-            } else {
-                var_type = var_sym_ptr->get_semantic_type();
-            }
+        const string& var_name = ctx.string_interner.get_string($1);
+        SymbolInfo* var_sym_ptr = ctx.symbol_table.lookup($1);
+        SemanticType var_type = SemanticType::IntArray;
 
-            if (var_type == INT_TYPE || var_type == FLOAT_TYPE) {
-                write_error_log(var_name + " is not an array and cannot be indexed");
-                var_type = INT_ARRAY_TYPE;
-            }
+        if (var_sym_ptr == nullptr) {
+            write_error_log(ctx, var_name + " does not exist");
+        } else {
+            var_type = var_sym_ptr->get_semantic_type();
+        }
 
-            if (var_type == INT_ARRAY_TYPE) {
-                var_type = INT_TYPE;
-            } else {
-                var_type = FLOAT_TYPE;
-            }
+        if (var_type == SemanticType::Int || var_type == SemanticType::Float) {
+            write_error_log(ctx, var_name + " is not an array and cannot be indexed");
+            var_type = SemanticType::IntArray;
+        }
 
-            $$ = new SymbolInfo($1->get_symbol() + "[" + $3->get_symbol() + "]", "variable", var_type);
-
-            string production = "variable : ID LTHIRD expression RTHIRD";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            // expression value on AX, since its an index, move it to SI, in word size
-            vector<string> code{
-                "MOV BX, " + to_string(DW_SZ),
-                "MUL BX",
-                "MOV SI, AX" 
-            };
-            write_code(code, 1);
-            $$ = new SymbolInfo(*$1); 
+        if (var_type == SemanticType::IntArray) {
+            var_type = SemanticType::Int;
+        } else {
+            var_type = SemanticType::Float;
         }
+
+        $$ = ctx.arena.create<ASTNode>(NodeKind::Variable, @$, var_type, $1);
+        $$->add_child($3);
+        resolve_var_storage($$, var_sym_ptr);
+
+        string production = "variable : ID LTHIRD expression RTHIRD";
+        write_log(ctx, production, @$);
     }
     ;
 
 expression:
     logic_expression {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($<SymPtr>1->get_symbol(), "expression", $<SymPtr>1->get_semantic_type());
-
-            string production = "expression : logic_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
 
-        }
+        string production = "expression : logic_expression";
+        write_log(ctx, production, @$);
     }
     | variable ASSIGNOP logic_expression {
-        if (phase == Analysis) {
-            string type = $1->get_semantic_type();
-
-            if ($<SymPtr>3->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Void type cannot be assigned to any type");
-            } else if ($1->get_semantic_type() == FLOAT_TYPE && $<SymPtr>3->get_semantic_type() == INT_TYPE) {
-                // okay  
-            } else if ($1->get_semantic_type() == INT_TYPE && $<SymPtr>3->get_semantic_type() == FLOAT_TYPE) {
-                write_error_log("Assigning float to int", "WARNING");
-            } else if ($1->get_semantic_type() != $<SymPtr>3->get_semantic_type()) {
-                write_error_log("Cannot assign " + $<SymPtr>3->get_semantic_type() + " to " + $1->get_semantic_type());
-            }
-
-            $$ = new SymbolInfo($1->get_symbol() + " = " + $<SymPtr>3->get_symbol(), "expression", type);
+        SemanticType type = $1->get_semantic_type();
 
-            string production = "expression : variable ASSIGNOP logic_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            // variable can be an array, if so, index is in SI.
-            SymbolInfo* var_sym_ptr = symbol_table.lookup($1->get_symbol());
-            string var_ref = _get_var_ref(var_sym_ptr);
-            string code = "MOV " + var_ref + ", AX";
-            write_code(code, label_depth);
+        if ($3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Void type cannot be assigned to any type");
+        } else if ($1->get_semantic_type() == SemanticType::Float && $3->get_semantic_type() == SemanticType::Int) {
+            // okay
+        } else if ($1->get_semantic_type() == SemanticType::Int && $3->get_semantic_type() == SemanticType::Float) {
+            write_error_log(ctx, "Assigning float to int", "WARNING");
+        } else if ($1->get_semantic_type() != $3->get_semantic_type()) {
+            write_error_log(ctx, "Cannot assign " + get_type_name($3->get_semantic_type()) + " to " +
+                get_type_name($1->get_semantic_type()));
         }
+
+        $$ = ctx.arena.create<ASTNode>(NodeKind::Assignment, @$, type);
+        $$->add_child($1);
+        $$->add_child($3);
+
+        string production = "expression : variable ASSIGNOP logic_expression";
+        write_log(ctx, production, @$);
     }
     ;
 
 logic_expression:
     rel_expression {
-        if (phase == Analysis) {
-            $<SymPtr>$ = new SymbolInfo($1->get_symbol(), "logic_expression", $1->get_semantic_type());
+        $$ = $1;
 
-            string production = "logic_expression : rel_expression";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            
-        }
+        string production = "logic_expression : rel_expression";
+        write_log(ctx, production, @$);
     }
-    | rel_expression LOGICOP {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            vector<string> code;
-
-            if ($2->get_symbol() == "&&") {
-                code.push_back("CMP AX, 0");
-            } else if ($2->get_symbol() == "||") {
-                code.push_back("CMP AX, 1");
-            }
-            code.insert(code.end(), {
-                "JE " + get_label(SHORT_CIRC), 
-                "PUSH AX" // if not short circuited
-            });
-
-            write_code(code, label_depth);
-
-            $<IntVal>$ = label_count - 1;
+    | rel_expression LOGICOP rel_expression {
+        if ($1->get_semantic_type() == SemanticType::Void || $3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Logical operation not defined on void type");
         }
-    } rel_expression {
-        if (phase == Analysis) {
-            if ($1->get_semantic_type() == VOID_TYPE || $4->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Logical operation not defined on void type");
-            }
 
-            $<SymPtr>$ = new SymbolInfo($1->get_symbol() + " " + $2->get_symbol() + " " +
-                $4->get_symbol(), "logic_expression", INT_TYPE);
-
-            string production = "logic_expression : rel_expression LOGICOP rel_expression";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            vector<string> code{
-                "MOV BX, AX", 
-                "POP AX"
-            };
-            if ($2->get_symbol() == "&&") {
-                code.push_back("AND AX, BX");
-            } else if ($2->get_symbol() == "||") {
-                code.push_back("OR AX, BX");
-            }
-            code.push_back(get_label(SHORT_CIRC, $<IntVal>3) + ":");
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::LogicExpression, @$, SemanticType::Int,
+            ctx.string_interner.intern(lexeme(ctx, @2)));
+        $$->add_child($1);
+        $$->add_child($3);
+
+        string production = "logic_expression : rel_expression LOGICOP rel_expression";
+        write_log(ctx, production, @$);
     }
     ;
 
 rel_expression:
     simple_expression {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "rel_expression", $1->get_semantic_type());
+        $$ = $1;
 
-            string production = "rel_expression : simple_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "rel_expression : simple_expression";
+        write_log(ctx, production, @$);
     }
-    | simple_expression {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            vector<string> code{
-                "; COMPARISON START",
-                "PUSH AX"
-            };
-            write_code(code, label_depth);
+    | simple_expression RELOP simple_expression {
+        if ($1->get_semantic_type() == SemanticType::Void || $3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Relational operation not defined on void type");
         }
-    } RELOP simple_expression {
-        if (phase == Analysis) {
-            if ($1->get_semantic_type() == VOID_TYPE || $3->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Relational operation not defined on void type");
-            }
 
-            $$ = new SymbolInfo($1->get_symbol() + " " + $3->get_symbol() + " " + 
-                $4->get_symbol(), "rel_expression", INT_TYPE);
-
-            string production = "rel_expression : simple_expression RELOP simple_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string relop = $3->get_symbol();
-            vector<string> code = {
-                "MOV BX, AX", 
-                "POP AX",
-                "CMP AX, BX", 
-                "MOV AX, 0" // default false
-            };
-
-            const size_t CURR_LABEL_ID = label_count;
-
-            if (relop == "<") {
-                code.push_back("JL " + get_label(CMP_TRUE));
-            } else if (relop == "<=") {
-                code.push_back("JLE " + get_label(CMP_TRUE));
-            } else if (relop == ">") {
-                code.push_back("JG " + get_label(CMP_TRUE));
-            } else if (relop == ">=") {
-                code.push_back("JGE " + get_label(CMP_TRUE));
-            } else if (relop == "==") {
-                code.push_back("JE " + get_label(CMP_TRUE));
-            } else if (relop == "!=") {
-                code.push_back("JNE " + get_label(CMP_TRUE));
-            } // label_count incremented
-
-            code.push_back("JMP " + get_label(CMP_FALSE, CURR_LABEL_ID)); // default false
-
-            code.push_back(get_label(CMP_TRUE, CURR_LABEL_ID) + ":");
-            code.push_back("MOV AX, 1");
-
-            code.push_back(get_label(CMP_FALSE, CURR_LABEL_ID) + ":"); // default false
-            code.push_back("; COMPARISON END");
-
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::RelExpression, @$, SemanticType::Int,
+            ctx.string_interner.intern(lexeme(ctx, @2)));
+        $$->add_child($1);
+        $$->add_child($3);
+
+        string production = "rel_expression : simple_expression RELOP simple_expression";
+        write_log(ctx, production, @$);
     }
     ;
 
 simple_expression:
     term {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "simple_expression", $1->get_semantic_type());
+        $$ = $1;
 
-            string production = "simple_expression : term";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "simple_expression : term";
+        write_log(ctx, production, @$);
     }
-    | simple_expression {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            string code = "PUSH AX";
-            write_code(code, label_depth);
+    | simple_expression ADDOP term {
+        SemanticType type = SemanticType::Int;
+        if ($1->get_semantic_type() == SemanticType::Void || $3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Addition not defined on void type");
+        } else if ($1->get_semantic_type() == SemanticType::Float || $3->get_semantic_type() == SemanticType::Float) {
+            type = SemanticType::Float;
         }
-    } ADDOP term {
-        if (phase == Analysis) {
-            string type = INT_TYPE;
-            if ($1->get_semantic_type() == VOID_TYPE || $3->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Addition not defined on void type");
-            } else if ($1->get_semantic_type() == FLOAT_TYPE || $3->get_semantic_type() == FLOAT_TYPE) {
-                type = FLOAT_TYPE;
-            }
 
-            $$ = new SymbolInfo($1->get_symbol() + " " + $3->get_symbol() + " " + 
-                $4->get_symbol(), "simple_expression", type);
-
-            string production = "simple_expression : simple_expression ADDOP term";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string addop = $3->get_symbol();
-            vector<string> code{
-                "MOV BX, AX", 
-                "POP AX"
-            };
-
-            if (addop == "+") {
-                code.push_back("ADD AX, BX");
-            } else if (addop == "-") {
-                code.push_back("SUB AX, BX");
-            }
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::AddExpression, @$, type, ctx.string_interner.intern(lexeme(ctx, @2)));
+        $$->add_child($1);
+        $$->add_child($3);
+
+        string production = "simple_expression : simple_expression ADDOP term";
+        write_log(ctx, production, @$);
     }
     ;
 
 term:
     unary_expression {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "term", $1->get_semantic_type());
-
-            string production = "term : unary_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
 
-        }
+        string production = "term : unary_expression";
+        write_log(ctx, production, @$);
     }
-    | term {
-        if (phase == Analysis) {
+    | term MULOP unary_expression {
+        SemanticType type = SemanticType::Int;
+        if ($1->get_semantic_type() == SemanticType::Void || $3->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Multiplication not defined on void type");
+        } else if (
+            lexeme(ctx, @2) != "%" &&
+            ($1->get_semantic_type() == SemanticType::Float || $3->get_semantic_type() == SemanticType::Float)
+        ) {
+            type = SemanticType::Float;
+        }
 
-        } else if (phase == Synthesis) {
-            string code = "PUSH AX";
-            write_code(code, 1);
+        if (lexeme(ctx, @2) == "%" && ($1->get_semantic_type() != SemanticType::Int || $3->get_semantic_type() != SemanticType::Int)) {
+            write_error_log(ctx, "modulo operation only defined on int types");
         }
-    } MULOP unary_expression {
-        if (phase == Analysis) {
-            string type = INT_TYPE;
-            if ($1->get_semantic_type() == VOID_TYPE || $3->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Multiplication not defined on void type");
-            } else if (
-                $3->get_symbol() != "%" && 
-                ($1->get_semantic_type() == FLOAT_TYPE || $4->get_semantic_type() == FLOAT_TYPE)
-            ) {
-                type = FLOAT_TYPE;
-            }
 
-            if ($3->get_symbol() == "%" && ($1->get_semantic_type() != INT_TYPE || $4->get_semantic_type() != INT_TYPE)) {
-                write_error_log("modulo operation only defined on int types");
-            }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::MulExpression, @$, type, ctx.string_interner.intern(lexeme(ctx, @2)));
+        $$->add_child($1);
+        $$->add_child($3);
 
-            $$ = new SymbolInfo($1->get_symbol() + " " + $3->get_symbol() + " " +  $4->get_symbol(),
-                "term", type);
-
-            string production = "term : term MULOP unary_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string mulop = $3->get_symbol();
-            vector<string> code = {
-                "MOV BX, AX", 
-                "POP AX",
-            }; 
-
-            if (mulop == "*") {
-                code.push_back("IMUL BX"); // result in DX:AX, we'll take AX
-            } else if (mulop == "/") {
-                code.push_back("MOV DX, 0");
-                code.push_back("IDIV BX"); // AX quo, DX rem
-            } else if (mulop == "%") {
-                code.push_back("MOV DX, 0");
-                code.push_back("IDIV BX");
-                code.push_back("MOV AX, DX");
-            }
-            write_code(code, 1);
-        }
+        string production = "term : term MULOP unary_expression";
+        write_log(ctx, production, @$);
     }
     ;
 
 unary_expression:
-    ADDOP unary_expression 
+    ADDOP unary_expression
     %prec UNARY {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + $2->get_symbol(), "unary_expression", $2->get_semantic_type());
-
-            string production = "unary_expression : ADDOP unary_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string addop = $1->get_symbol();
-            if (addop == "-") {
-                string code = "NEG AX";
-                write_code(code, label_depth);
-            }
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::UnaryExpression, @$, $2->get_semantic_type(),
+            ctx.string_interner.intern(lexeme(ctx, @1)));
+        $$->add_child($2);
+
+        string production = "unary_expression : ADDOP unary_expression";
+        write_log(ctx, production, @$);
     }
     | NOT unary_expression {
-        if (phase == Analysis) {
-            if ($2->get_semantic_type() == VOID_TYPE) {
-                write_error_log("Not operation cannot be performed on void type");
-            }
-            
-            $$ = new SymbolInfo("!" + $2->get_symbol(), "unary_expression", INT_TYPE);
-
-            string production = "unary_expression : NOT unary_expression";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            vector<string> code = {
-                "CMP AX, 0",
-                "MOV AX, 0", 
-                "SETE AL"
-            };
-            write_code(code, 1);
+        if ($2->get_semantic_type() == SemanticType::Void) {
+            write_error_log(ctx, "Not operation cannot be performed on void type");
         }
+
+        $$ = ctx.arena.create<ASTNode>(NodeKind::NotExpression, @$, SemanticType::Int);
+        $$->add_child($2);
+
+        string production = "unary_expression : NOT unary_expression";
+        write_log(ctx, production, @$);
     }
     | factor {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "factor", $1->get_semantic_type());
-
-            string production = "unary_expression : factor";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $1;
 
-        }
+        string production = "unary_expression : factor";
+        write_log(ctx, production, @$);
     }
     ;
 
 factor:
     variable {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "factor", $1->get_semantic_type());
-
-            string production = "factor : variable";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            // when variable reduces to factor, it's symbol table info is no longer needed, just the value on AX. 
-            SymbolInfo* var_sym_ptr = symbol_table.lookup($1->get_symbol());
-            string var_ref = _get_var_ref(var_sym_ptr);
-            string code = "MOV AX, " + var_ref;
-            write_code(code, label_depth);
-        }
+        $$ = $1;
+
+        string production = "factor : variable";
+        write_log(ctx, production, @$);
     }
-    | ID LPAREN {
-        if (phase == Analysis) {
-
-        } else if (phase == Synthesis) {
-            // the definition code for the procedure we are calling is independent, written with its own current_stack_offset, 
-            string func_name = $1->get_symbol();
-            vector<string> code{
-                "; ACTIVATION RECORD SETUP FOR FUNCTION " + func_name,
-                "PUSH BP", 
-            };
-            write_code(code, label_depth);
-        }
-    } argument_list RPAREN {
-        if (phase == Analysis) {
-            string func_name = $1->get_symbol();
-            SymbolInfo* func_sym_ptr = symbol_table.lookup(func_name);
-            string return_type = VOID_TYPE;
-            vector<string> param_type_list = {};
-
-            if (func_sym_ptr == nullptr) {
-                write_error_log(func_name + " does not exist and cannot be called");
-            } else if (!is_sym_func(func_sym_ptr)) {
-                write_error_log(func_name + " is not callable");
-            } else {
-                return_type = func_sym_ptr->get_semantic_type();
-                param_type_list = func_sym_ptr->get_all_data();
-                if (!is_func_sym_defined(func_sym_ptr)) {
-                    param_type_list = vector<string>(param_type_list.begin(), param_type_list.end());
-                } else {
-                    param_type_list = vector<string>(param_type_list.begin(), param_type_list.end()-1);
-                }
+    | ID LPAREN argument_list RPAREN {
+        const string& func_name = ctx.string_interner.get_string($1);
+        SymbolInfo* func_sym_ptr = ctx.symbol_table.lookup($1);
+        SemanticType return_type = SemanticType::Void;
 
-                vector<string> arg_types = $<SymPtr>4->get_all_data();
-
-                if (param_type_list[0] == VOID_TYPE && !arg_types.empty()) {
-                    // catches VOID_TYPE argument error
-                    write_error_log(func_name + " expects 0 arguments, but got " + to_string(arg_types.size()));
-                } else if (param_type_list[0] != VOID_TYPE && param_type_list.size() != arg_types.size()) {
-                    write_error_log(func_name + " expects " + to_string(param_type_list.size()) + 
-                        " arguments, but got " + to_string(arg_types.size()));
-                } else if (param_type_list[0] != VOID_TYPE && param_type_list != arg_types) {
-                    write_error_log(func_name + " has parameters of type: " + vec_to_str(param_type_list) +
-                        ", but got arguments of type: " + vec_to_str(arg_types));
-                }
+        if (func_sym_ptr == nullptr) {
+            write_error_log(ctx, func_name + " does not exist and cannot be called");
+        } else if (!is_sym_func(func_sym_ptr)) {
+            write_error_log(ctx, func_name + " is not callable");
+        } else {
+            return_type = func_sym_ptr->get_semantic_type();
+            const vector<SemanticType>& param_types = func_sym_ptr->get_signature()->param_types;
+            vector<SemanticType> arg_types = get_children_types($3);
+
+            if (param_types.empty() && !arg_types.empty()) {
+                // catches void argument error
+                write_error_log(ctx, func_name + " expects 0 arguments, but got " + to_string(arg_types.size()));
+            } else if (!param_types.empty() && param_types.size() != arg_types.size()) {
+                write_error_log(ctx, func_name + " expects " + to_string(param_types.size()) +
+                    " arguments, but got " + to_string(arg_types.size()));
+            } else if (!param_types.empty() && param_types != arg_types) {
+                write_error_log(ctx, func_name + " has parameters of type: " + types_to_str(param_types) +
+                    ", but got arguments of type: " + types_to_str(arg_types));
             }
-
-            $$ = new SymbolInfo($1->get_symbol() + "(" + $<SymPtr>3->get_symbol() + ")", "factor", return_type);
-
-            string production = "factor : ID LPAREN argument_list RPAREN";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string func_name = $1->get_symbol();
-            size_t arg_count = $<IntVal>4;
-            vector<string> code(arg_count, "POP BX"); // pop args
-            code.insert(code.begin(), "CALL " + func_name);
-            code.insert(code.end(), {
-                "POP BP", // restore old BP
-                "; EXECUTION COMPLETE FOR FUNCTION " + func_name
-            });
-            write_code(code, label_depth);
         }
+
+        $$ = ctx.arena.create<ASTNode>(NodeKind::Call, @$, return_type, $1);
+        $$->adopt_children($3);
+
+        string production = "factor : ID LPAREN argument_list RPAREN";
+        write_log(ctx, production, @$);
     }
     | LPAREN expression RPAREN {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo("(" + $2->get_symbol() + ")", "factor", $2->get_semantic_type());
-
-            string production = "factor : LPAREN expression RPAREN";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
+        $$ = $2;
+        $$->set_span(@$);
 
-        }
+        string production = "factor : LPAREN expression RPAREN";
+        write_log(ctx, production, @$);
     }
     | CONST_INT {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "factor", INT_TYPE);
-
-            string production = "factor : CONST_INT";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            string code = "MOV AX, " + $1->get_symbol();
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ConstInt, @$, SemanticType::Int,
+            ctx.string_interner.intern(lexeme(ctx, @1)));
+
+        string production = "factor : CONST_INT";
+        write_log(ctx, production, @$);
     }
     | CONST_FLOAT {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol(), "factor", FLOAT_TYPE);
+        $$ = ctx.arena.create<ASTNode>(NodeKind::ConstFloat, @$, SemanticType::Float,
+            ctx.string_interner.intern(lexeme(ctx, @1)));
 
-            string production = "factor : CONST_FLOAT";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-
-        }
+        string production = "factor : CONST_FLOAT";
+        write_log(ctx, production, @$);
     }
     | variable INCOP {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "++", "factor", $1->get_semantic_type());
-
-            string production = "factor : variable INCOP";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            SymbolInfo* var_sym_ptr = symbol_table.lookup($1->get_symbol());
-            string var_ref = _get_var_ref(var_sym_ptr);
-            vector<string> code = {
-                "MOV AX, " + var_ref, 
-                "MOV BX, AX", 
-                "INC BX", 
-                "MOV " + var_ref + ", BX"
-            };
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::PostIncrement, @$, $1->get_semantic_type());
+        $$->add_child($1);
+
+        string production = "factor : variable INCOP";
+        write_log(ctx, production, @$);
     }
     | variable DECOP {
-        if (phase == Analysis) {
-            $$ = new SymbolInfo($1->get_symbol() + "--", "factor", $1->get_semantic_type());
-
-            string production = "factor : variable DECOP";
-            write_log(production, $$);
-        } else if (phase == Synthesis) {
-            SymbolInfo* var_sym_ptr = symbol_table.lookup($1->get_symbol());
-            string var_ref = _get_var_ref(var_sym_ptr);
-            vector<string> code = {
-                "MOV AX, " + var_ref, 
-                "MOV BX, AX",
-                "DEC BX",
-                "MOV " + var_ref + ", BX"
-            };
-            write_code(code, label_depth);
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::PostDecrement, @$, $1->get_semantic_type());
+        $$->add_child($1);
+
+        string production = "factor : variable DECOP";
+        write_log(ctx, production, @$);
     }
     ;
 
 argument_list:
     arguments {
-        if (phase == Analysis) {
-            $<SymPtr>$ = new SymbolInfo($<SymPtr>1->get_symbol(), "argument_list", VOID_TYPE, 
-                $<SymPtr>1->get_all_data());
-
-            string production = "argument_list : arguments";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            $<IntVal>$ = $<IntVal>1; // arg count
-        }
+        $$ = $1;
+
+        string production = "argument_list : arguments";
+        write_log(ctx, production, @$);
     }
     | %empty {
-        if (phase == Analysis) {
-            // empty params have void type data, but empty args don't
-            $<SymPtr>$ = new SymbolInfo("", "argument_list", VOID_TYPE); 
-
-            string production = "argument_list : ";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            $<IntVal>$ = 0;
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+
+        string production = "argument_list : ";
+        write_log(ctx, production, @$);
     }
     ;
 
 arguments:
     arguments COMMA logic_expression {
-        if (phase == Analysis) {
-            // if logic_expression has VOID_TYPE, function call will report that error
-            vector<string> arg_type_data = $<SymPtr>1->get_all_data();
-            arg_type_data.push_back($<SymPtr>3->get_semantic_type());
-
-            $<SymPtr>$ = new SymbolInfo($<SymPtr>1->get_symbol() + "," + $<SymPtr>3->get_symbol(), "arguments", VOID_TYPE, 
-                arg_type_data);
-
-            string production = "arguments : arguments COMMA logic_expression";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            string code = "PUSH AX";
-            write_code(code, label_depth);
-            $<IntVal>$ = $<IntVal>1 + 1; // return total arg count
-        }
+        // if logic_expression is void, function call will report that error
+        $$ = $1;
+        $$->set_span(@$);
+        $$->add_child($3);
+
+        string production = "arguments : arguments COMMA logic_expression";
+        write_log(ctx, production, @$);
     }
     | logic_expression {
-        if (phase == Analysis) {
-            $<SymPtr>$ = new SymbolInfo($<SymPtr>1->get_symbol(), "arguments", VOID_TYPE, 
-                {$<SymPtr>1->get_semantic_type()});
-
-            string production = "arguments : logic_expression";
-            write_log(production, $<SymPtr>$);
-        } else if (phase == Synthesis) {
-            string code = "PUSH AX";
-            write_code(code, label_depth);
-            $<IntVal>$ = 1;
-        }
+        $$ = ctx.arena.create<ASTNode>(NodeKind::List, @$, SemanticType::Void);
+        $$->add_child($1);
+
+        string production = "arguments : logic_expression";
+        write_log(ctx, production, @$);
     }
     ;
 
 %%
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    CompilerOptions options;
+    vector<string> source_file_names;
+    if (!parse_args(argc, argv, options, source_file_names)) {
         cout << "ERROR: Parser needs input file as argument\n";
+        cout << "Usage: " << argv[0] << " [-j N] [--out-dir DIR] [--code-out FILE] [--optimized-out FILE]"
+            " [--peephole-stats] [--inline-report] [--fast-call] [--buffer-output] [--cache-dir DIR [--cache-verify]"
+            " [--cache-stats]] [--time-passes] [--stats] [--stats-json] SOURCE_FILE\n";
+        cout << "       " << argv[0] << " [-j N] [--out-dir DIR] [--peephole-stats] [--inline-report] [--fast-call]"
+            " [--buffer-output] [--cache-dir DIR [--cache-verify] [--cache-stats]] [--time-passes] [--stats]"
+            " [--stats-json] SOURCE_FILE...\n";
         return 1;
     }
 
-    // Analysis
-    phase = Analysis;
-
-    input_file = fopen(argv[1], "r");
-    log_file.open("log.txt");
-    error_file.open("error.txt");
-
-    if (!input_file || !log_file || !error_file) {
-        cerr << "ERROR: Could not open file\n";
-        return 1;
+    if (source_file_names.size() > 1) {
+        return compile_batch(options, source_file_names);
     }
-
-    yyin = input_file;
-    yyparse();
-    log_file << "Total lines: " << --line_count << endl;
-    log_file << "Total errors: " << error_count << endl;
-
-    log_file.close();
-    error_file.close();
-
-    if (error_count > 0) {
-        error_file.open("error.txt");
-        cout << error_file.rdbuf();
-        error_file.close();
-        cout << "COMPILATION FAILED: There are errors in your program" << endl;
-        delete_debug_files();
-        return 0;
-    }
-
-    delete_debug_files();
-
-    // Synthesis
-    phase = Synthesis;
-
-    fseek(input_file, 0, SEEK_SET); // reset file cursor
-    code_file.open(TEMP_CODE_FILE_NAME);
-
-    if (!input_file || !code_file) {
-        cout << "ERROR: Could not open input or code file\n";
+    if (!create_output_dir(options)) {
         return 1;
     }
-
-    symbol_table.exit_scope();
-    symbol_table.enter_scope();
-    current_func_sym_ptr = nullptr;
-
-    yyin = input_file;
-    yyparse();
-
-    fclose(input_file);
-    code_file.close();
-
-    structure_main_asm_codefile();
-    peephole_optimization();
-
-    return 0;
+    CompilerContext ctx(get_output_dir_options(options));
+    return compile(ctx, source_file_names[0]);
 }
 
 
@@ -1642,358 +1033,193 @@ int main(int argc, char* argv[]) {
     Analysis utils
 **/
 
-void yyerror(char* s) {
-    write_error_log(s, "SYNTAX_ERR");
+void yyerror(YYLTYPE*, CompilerContext& ctx, yyscan_t, const char* s) {
+    write_error_log(ctx, s, "SYNTAX_ERR");
 }
 
 bool is_sym_func(SymbolInfo* syminfo) {
-    return !syminfo->get_all_data().empty();
+    return syminfo->get_signature() != nullptr;
 }
 
 bool is_func_sym_defined(SymbolInfo* syminfo) {
-    return syminfo->get_all_data()[syminfo->get_all_data().size()-1] == "defined";
+    return syminfo->is_defined();
 }
 
 bool is_func_signatures_match(SymbolInfo* func_sym_ptr1, SymbolInfo* func_sym_ptr2) {
-    vector<string> param_type_list1 = func_sym_ptr1->get_all_data();
-    vector<string> param_type_list2 = func_sym_ptr2->get_all_data();
-    if (param_type_list1[param_type_list1.size()-1] == "defined") {
-        param_type_list1 = vector<string>(param_type_list1.begin(), param_type_list1.end()-1);
-    }
-    if (param_type_list2[param_type_list2.size()-1] == "defined") {
-        param_type_list2 = vector<string>(param_type_list2.begin(), param_type_list2.end()-1);
-    }
-
-    return func_sym_ptr1->get_symbol() == func_sym_ptr2->get_symbol() && 
-        func_sym_ptr1->get_semantic_type() == func_sym_ptr2->get_semantic_type() &&
-        param_type_list1 == param_type_list2;
+    // signatures are interned, equal signatures are the same object
+    return func_sym_ptr1->get_symbol_id() == func_sym_ptr2->get_symbol_id() &&
+        func_sym_ptr1->get_signature() == func_sym_ptr2->get_signature();
 }
 
-bool insert_into_symtable(string symbol, string token_type, string semantic_type, vector<string> data) {
-    if (!symbol_table.insert(symbol, token_type, semantic_type, data)) {
-        write_error_log("Symbol name " + symbol + " already exists");
+bool insert_into_symtable(CompilerContext& ctx, int symbol_id, string token_type, SemanticType semantic_type) {
+    if (!ctx.symbol_table.insert(symbol_id, token_type, semantic_type)) {
+        write_error_log(ctx, "Symbol name " + ctx.string_interner.get_string(symbol_id) + " already exists");
         return false;
     }
     return true;
 }
 
-bool insert_into_symtable(SymbolInfo* syminfo) {
-    return symbol_table.insert_copy(syminfo);
+bool insert_into_symtable(CompilerContext& ctx, SymbolInfo* syminfo) {
+    return ctx.symbol_table.insert_copy(syminfo);
 }
 
-bool insert_var_list_into_symtable(string var_type, vector<string> var_names) {
+/**
+    Inserts the declared variables into the symbol table, sets the declared type of each declarator and
+    allocates storage for it.
+
+    @param var_type Declared type of the variables
+    @param declarators Declarator nodes of the variables, arrays have SemanticType::IntArray
+    @return true if all variables were inserted
+**/
+bool insert_var_list_into_symtable(CompilerContext& ctx, SemanticType var_type, vector<ASTNode*>& declarators) {
     bool is_all_success = true;
-    for (string var_name : var_names) {
-        if (var_name.find("[") < var_name.length()) {
-            // variable is array
-            var_name = var_name.substr(0, var_name.find("["));
-            if (var_type == INT_TYPE) {
-                is_all_success = is_all_success && insert_into_symtable(var_name, "ID", INT_ARRAY_TYPE);
-            } else if (var_type == FLOAT_TYPE) {
-                is_all_success = is_all_success && insert_into_symtable(var_name, "ID", FLOAT_ARRAY_TYPE);
+    for (ASTNode* declarator_ptr : declarators) {
+        int var_name_id = declarator_ptr->get_name_id();
+        bool is_array = declarator_ptr->get_semantic_type() == SemanticType::IntArray;
+        SemanticType declared_type = var_type;
+        if (is_array) {
+            if (var_type == SemanticType::Int) {
+                declared_type = SemanticType::IntArray;
+            } else if (var_type == SemanticType::Float) {
+                declared_type = SemanticType::FloatArray;
+            } else {
+                continue;
             }
-        } else {
-            is_all_success = is_all_success && insert_into_symtable(var_name, "ID", var_type);
         }
-    }
-    return is_all_success;
-}
-
-void write_log(string production, SymbolInfo* matched_sym_ptr) {
-    log_file << "Line " << to_string(line_count) << ": " << production << endl;
-    log_file << matched_sym_ptr->get_symbol() << endl;
-}
 
-void write_error_log(string log_str, string tag) {
-    error_count++;
-    log_file << "[" << tag << "] Line " << to_string(line_count) << ": " << log_str << endl; 
-    error_file << "[" << tag << "] Line " << to_string(line_count) << ": " << log_str << endl; 
-}
+        declarator_ptr->set_semantic_type(declared_type);
+        if (!insert_into_symtable(ctx, var_name_id, "ID", declared_type)) {
+            is_all_success = false;
+            continue;
+        }
 
-void write_symtable_in_log(SymbolTable& symtable) {
-    ostringstream osstrm;
-    osstrm << symtable;
-    log_file << osstrm.str() << endl;
+        CodeGenInfo* var_cgi_ptr = declarator_ptr->get_codegen_info_ptr();
+        alloc_var_storage(ctx, var_cgi_ptr, is_array ? declarator_ptr->get_count() : 1);
+        *ctx.symbol_table.lookup(var_name_id)->get_codegen_info_ptr() = *var_cgi_ptr;
+    }
+    return is_all_success;
 }
 
-
-
-/**
-    Synthesis utils
-**/
-
 /**
-    Generates label, with new id if label id is not provided or with provided id otherwise. 
-    If new label is generated, global label_count is incremented. 
+    Allocates storage for a variable. Variables outside functions are global, inside functions they are
+    placed on the stack of the current function.
 
-    @param Label Label type to generate
-    @param label_id Label id to append after label name
-    @return The label string with id appended
+    @param var_cgi_ptr Code gen info of the variable to be allocated
+    @param word_count Number of words the variable occupies
 **/
-string get_label(Label label, int label_id) {
-    if (label_id < 0) {
-        label_id = label_count++; // no label_id provided, generate new label_id
-    }
-
-    string label_str;
-    switch(label) {
-        case FOR_LOOP_CONDITION:
-            label_str = "FOR_LOOP_CND_";
-            break;
-        case FOR_LOOP_INCREMENT:
-            label_str = "FOR_LOOP_INC_";
-            break;
-        case FOR_LOOP_BODY:
-            label_str = "FOR_LOOP_BODY_";
-            break;
-        case FOR_LOOP_END:
-            label_str = "FOR_LOOP_END_";
-            break;
-        case WHILE_LOOP_CONDITION:
-            label_str = "WHILE_LOOP_CND_";
-            break;
-        case WHILE_LOOP_BODY:
-            label_str = "WHILE_LOOP_BODY_";
-            break;
-        case WHILE_LOOP_END:
-            label_str = "WHILE_LOOP_END_";
-            break;
-        case ELSE_BODY:
-            label_str = "ELSE_BODY_";
-            break;
-        case IF_ELSE_END:
-            label_str = "IF_ELSE_END_";
-            break;
-        case CMP_TRUE:
-            label_str = "CMP_TRUE_";
-            break;
-        case CMP_FALSE:
-            label_str = "CMP_FALSE_";
-            break;
-        case SHORT_CIRC:
-            label_str = "SHORT_CIRC_";
-    }
-
-    return label_str + to_string(label_id);
+void alloc_var_storage(CompilerContext& ctx, CodeGenInfo* var_cgi_ptr, int word_count) {
+    if (ctx.symbol_table.get_current_scope_depth() == 1) {
+        var_cgi_ptr->set_is_local(false);
+        return;
+    }
+
+    var_cgi_ptr->set_is_local(true);
+    var_cgi_ptr->set_stack_offset(ctx.current_stack_offset);
+    ctx.current_stack_offset -= word_count; // stack grows downward
 }
 
 /**
-    Resolves the identifier of a variable in assembly, based on if it's local or global and if it's an array or 
-    not. 
+    Copies the storage of the variable symbol found in the symbol table into the variable node.
 
-    @param var_sym_ptr Pointer to the SymbolInfo of the variable from the symbol table whose identifier needs to be resolved.
-    @return string Identifier that can be included in assembly code
+    @param var_ptr Variable node
+    @param var_sym_ptr Symbol of the variable, nullptr if not found
 **/
-string _get_var_ref(SymbolInfo* var_sym_ptr) {
-    string var_type = var_sym_ptr->get_semantic_type();
-    CodeGenInfo* var_cgi_ptr = var_sym_ptr->get_codegen_info_ptr();
-    string var_ref;
-    if (var_cgi_ptr->is_local()) {
-        var_ref = "BP+" + to_string(DW_SZ * var_cgi_ptr->get_stack_offset());
-        if (var_type == INT_ARRAY_TYPE) {
-            var_ref += "-SI"; // array index in SI from expression
-        }
-        var_ref = "[" + var_ref + "]";
-    } else {
-        var_ref = var_sym_ptr->get_symbol();
-        if (var_type == INT_ARRAY_TYPE) {
-            var_ref += "[SI]"; // array indec in SI from expression
-        }
+void resolve_var_storage(ASTNode* var_ptr, SymbolInfo* var_sym_ptr) {
+    if (var_sym_ptr == nullptr) {
+        return;
     }
-    return var_ref;
+
+    CodeGenInfo* var_cgi_ptr = var_sym_ptr->get_codegen_info_ptr();
+    var_ptr->get_codegen_info_ptr()->set_is_local(var_cgi_ptr->is_local());
+    var_ptr->get_codegen_info_ptr()->set_stack_offset(var_cgi_ptr->get_stack_offset());
 }
 
 /**
-    @brief Returns code for popping local variables, with return using IP on stack top. 
+    @brief Returns the semantic types of the children of a node, i.e. parameter types or argument types.
 **/
-vector<string> _get_activation_record_teardown_code() {
-    // return expression already in AX, don't touch AX, pop locals off stack.
-    // symbol table count incudes params and local vars. params will be popped off by caller action code
-    size_t local_decl_count = (-current_stack_offset) - 1;
-    vector<string> code(local_decl_count, "POP BX");
-    code.push_back("RET"); // will find IP on top
-    return code;
+vector<SemanticType> get_children_types(ASTNode* node_ptr) {
+    vector<SemanticType> types;
+    for (ASTNode* child_ptr : node_ptr->get_children()) {
+        types.push_back(child_ptr->get_semantic_type());
+    }
+    return types;
 }
 
 /**
-    Writes allocation asm code of int variable into code_file based on if the variable is a local or global. 
-    Also inserts new symbol for the allocated variable in the symbol table.
-
-    @param var_name name of the variable to be allocated  
+    @brief Returns a view of the lexeme of a token in the source buffer, no copy of it is made.
 **/
-void _alloc_int_var(string var_name) {
-    SymbolInfo* var_sym_ptr = new SymbolInfo(var_name, "ID", INT_TYPE); // can do this because that's the only type
-
-    if (current_func_sym_ptr == nullptr) {
-        // global
-        string code = var_name + " DW 0";
-        var_sym_ptr->get_codegen_info_ptr()->add_code(code);
-        // write data segment code at the end
-        globals.push_back(new SymbolInfo(*var_sym_ptr)); // .clear() calls delete
-    } else {
-        // local
-        vector<string> code{
-            "; INITIALIZING BASIC VARIABLE " + var_name + " at stack offset " + to_string(current_stack_offset), 
-            "PUSH 0"
-        };
-        var_sym_ptr->get_codegen_info_ptr()->set_is_local(true);
-        var_sym_ptr->get_codegen_info_ptr()->set_stack_offset(current_stack_offset--); // stack grows downward
-        write_code(code, label_depth);
-    }
-    insert_into_symtable(var_sym_ptr);
-    delete var_sym_ptr;
+string_view lexeme(CompilerContext& ctx, const SourceSpan& token_span) {
+    return ctx.source_buffer.get_text(token_span);
 }
 
 /**
-    Writes allocation asm code of int array into code_file based on if the array is a local or global. 
-    Also inserts new symbol for the allocated array in the symbol table.
+    Writes the matched production and the matched source text to the log. The text is written straight
+    from the source buffer, no copy of it is made.
 
-    @param arr_name name of the array to be allocated  
-    @param arr_size size of the array
+    @param production Matched production
+    @param matched_span Span of the matched source text
 **/
-void _alloc_int_array(string arr_name, int arr_size) {
-    string arr_sz_str = to_string(arr_size);
-    SymbolInfo* arr_sym_ptr = new SymbolInfo(arr_name, "ID", INT_ARRAY_TYPE, { arr_sz_str });
-
-    if (current_func_sym_ptr == nullptr) {
-        // global
-        string code = arr_name + " DW " + arr_sz_str + " DUP(0)";
-        arr_sym_ptr->get_codegen_info_ptr()->add_code(code);
-        globals.push_back(new SymbolInfo(*arr_sym_ptr));
-    } else {
-        // local
-        vector<string> code(arr_size, "PUSH 0");
-        code.insert(code.begin(), "; INTIALIZING ARRAY VARIABLE " + arr_name + "[" + arr_sz_str + "]" + 
-            " at stack offset " + to_string(current_stack_offset));
-        arr_sym_ptr->get_codegen_info_ptr()->set_is_local(true);
-        arr_sym_ptr->get_codegen_info_ptr()->set_stack_offset(current_stack_offset);
-        current_stack_offset -= arr_size; // stack grows downward
-        write_code(code, label_depth);
-    }
-
-    insert_into_symtable(arr_sym_ptr);
-    delete arr_sym_ptr;
+void write_log(CompilerContext& ctx, string production, const SourceSpan& matched_span) {
+    ctx.log_file << "Line " << to_string(ctx.line_count) << ": " << production << endl;
+    ctx.log_file << ctx.source_buffer.get_text(matched_span) << endl;
 }
 
-void write_code(const string& code, int indentation) {
-    string indent = "";
-    for (int i = 0; i < indentation; i++) {
-        indent += "\t";
-    }
-    code_file << indent << code << endl;
+void write_error_log(CompilerContext& ctx, string log_str, string tag) {
+    ctx.error_count++;
+    ctx.log_file << "[" << tag << "] Line " << to_string(ctx.line_count) << ": " << log_str << endl;
+    ctx.error_file << "[" << tag << "] Line " << to_string(ctx.line_count) << ": " << log_str << endl;
 }
 
-void write_code(const vector<string>& code, int indentation) {
-    for (string code_line : code) {
-        write_code(code_line, indentation);
-    }
+void write_symtable_in_log(CompilerContext& ctx) {
+    ctx.stats.start_phase("Symbol table logging");
+    ostringstream osstrm;
+    osstrm << ctx.symbol_table;
+    ctx.log_file << osstrm.str() << endl;
+    ctx.stats.stop_phase();
 }
 
-void structure_main_asm_codefile() {
-    // open actual code file for writing
-    code_file.open(CODE_FILE_NAME);
-
-    if (!code_file) {
-        cerr << "Error: Could not open code file to write data segment" << endl;
-        return;
+/**
+    Reads the next token from the scanner for the parser, counting the tokens and timing the scanner. Only
+    the wall clock is read around each token, the time is summed in the context and added as a phase once
+    the parse is done.
+**/
+int yylex(YYSTYPE* yylval_ptr, YYLTYPE* yylloc_ptr, yyscan_t scanner) {
+    CompilerContext& ctx = *yyget_extra(scanner);
+    chrono::steady_clock::time_point start;
+    if (ctx.stats.is_timed) {
+        start = chrono::steady_clock::now();
     }
-
-    // write data segment on new code file
-    write_code(".MODEL SMALL");
-    write_code(".STACK 300H");
-    write_code(".DATA");
-    vector<string> code;
-    for (SymbolInfo* global_sym_ptr : globals) {
-        code.push_back(global_sym_ptr->get_codegen_info_ptr()->get_all_code()[0]);
+    int token = scan_token(yylval_ptr, yylloc_ptr, scanner);
+    if (ctx.stats.is_timed) {
+        ctx.lexing_time += chrono::steady_clock::now() - start;
     }
-    write_code(code, 1);
-    globals.clear();
-
-    // write __main__ function
-    code.clear();
-    code.insert(code.end(), {
-        ".CODE", 
-        "MAIN PROC" 
-    });
-    write_code(code);
-    code.clear();
-    code.insert(code.end(), {
-        "MOV AX, @DATA", 
-        "MOV DS, AX", 
-        "MOV BP, SP",
-        "CALL " + SOURCE_MAIN_FUNC_NAME, 
-        "MOV AH, 4CH", 
-        "INT 21H", // end prog
-    });
-    write_code(code, 1);
-    write_code("ENDP MAIN");
-
-    // append old code file to new code file
-    ifstream temp_code_file(TEMP_CODE_FILE_NAME);
-    if (temp_code_file.good()) {
-        copy_txt_file(temp_code_file, code_file);
-    } else {
-        cerr << "Error: Could not copy temp code file" << endl;
-        return;
+    if (token != YYEOF) {
+        ctx.stats.token_count++;
     }
+    return token;
+}
 
-    write_code("END MAIN");
 
-    // delete old code file
-    temp_code_file.close();
-    if (remove(TEMP_CODE_FILE_NAME.c_str()) != 0) {
-        cerr << "Error: Could not delete temp code file" << endl;
-    }
-}
 
-void append_print_proc_def_to_codefile() {
-    write_code("PRINT_INT_IN_AX PROC");
-    // divide and push the remainder
-    vector<string> code{
-        "MOV CX, 0",
-        "TEST AX, AX",
-        "JNS POSITIVE_NUM",
-        "MOV BX, 1",
-        "NEG AX",
-        "JMP OUTPUT_STACK_START",
-
-        "POSITIVE_NUM:",
-        "MOV BX, 0",
-        
-        "OUTPUT_STACK_START:",
-        "INC CX",
-        "PUSH CX",
-        "MOV CX, 10",
-        "MOV DX, 0",
-        "DIV CX",
-        "POP CX",
-        "PUSH DX",
-        "CMP AX, 0",
-        "JNE OUTPUT_STACK_START",
-        "CMP BX, 1",
-        "JNE STACK_PRINT_LOOP",
-        "MOV DX, -3",
-        "PUSH DX",
-        "INC CX",
-        
-        "STACK_PRINT_LOOP:",
-        "POP DX",
-        "ADD DL, '0'",
-        "MOV AH, 2",
-        "INT 21H", 
-        "LOOP STACK_PRINT_LOOP",
-        
-        "MOV DL, 10", 
-        "MOV AH, 2",
-        "INT 21H",
-        "MOV DL, 13", 
-        "MOV AH, 2",
-        "INT 21H",
-
-        "RET"    
-    };
-    write_code(code, 1);
-    write_code("ENDP");
+/**
+    Synthesis utils
+**/
+
+/**
+    Prints the final program: data segment with the globals, followed by the code segment, that starts with
+    the MAIN procedure that calls the source main function.
+
+    @param asm_buffer Data and code sections written by the code generator
+    @param string_interner Interner of the names and comments of the code
+    @return string Text of the program
+**/
+string structure_main_asm_code(AsmBuffer& asm_buffer, StringInterner& string_interner) {
+    string all_code = ".MODEL SMALL\n.STACK 300H\n.DATA\n";
+    asm_buffer.print_data_section(all_code, string_interner);
+    all_code += ".CODE\n";
+    asm_buffer.print_code_section(all_code, string_interner);
+    all_code += "END MAIN\n";
+    return all_code;
 }
 
 
@@ -2002,171 +1228,372 @@ void append_print_proc_def_to_codefile() {
     Optimization utils
 **/
 
-void peephole_optimization() {
-    vector<string> all_code = load_code_into_mem();
-
-    // do optim
-    do_peephole(all_code);
+/**
+    Runs the peephole optimizer on the code section in place, then writes the optimized code file.
 
-    write_optimized_code_to_file(all_code);
+    @param asm_buffer Data and code sections written by the code generator
+    @param code_cache_ptr Cache of the rewritten procedures, nullptr if none
+**/
+void peephole_optimization(CompilerContext& ctx, AsmBuffer& asm_buffer, CodeCache* code_cache_ptr) {
+    ctx.stats.start_phase("Peephole optimization");
+    PeepholeOptimizer peephole_optimizer(ctx.options.job_count, code_cache_ptr);
+    peephole_optimizer.optimize(asm_buffer.get_code_section());
+    ctx.stats.stop_phase();
+    peephole_optimizer.fill_stats(ctx.stats);
+    if (ctx.options.is_peephole_stats_shown) {
+        peephole_optimizer.write_stats(*ctx.message_stream);
+    }
+
+    ctx.stats.start_phase("Optimized code writing");
+    string optim_code = structure_main_asm_code(asm_buffer, ctx.string_interner);
+    if (!AsmBuffer::write_to_file(ctx.options.optim_code_file_name, optim_code)) {
+        *ctx.failure_stream << "Could not open optimized code file\n";
+    }
+    ctx.stats.stop_phase();
 }
 
-void do_peephole(vector<string>& all_code) {
-    bool skip_mode = false;
-    string curr_line, prev_line = all_code[0];
 
-    for (int i = 1, prev_idx = 0; i < all_code.size(); i++) {
-        if (all_code[i].find(";") != string::npos) {
-            continue;
-        }
 
-        curr_line = all_code[i];
-        prev_line = all_code[prev_idx];
-        trim(curr_line); // preserving original indentation on all_code
-        trim(prev_line);
-
-        if (starts_with("JMP", curr_line) || starts_with("RET", curr_line)) {
-            // skip until next label, or end of function
-            i++;
-            while (
-                (all_code[i].find(':') == string::npos) &&
-                (all_code[i].find("ENDP") == string::npos)
-            ) {
-                all_code[i] = "; PEEPHOLE " + all_code[i];
-                i++;
-            }
-        } else if (starts_with("MOV", curr_line) && starts_with("MOV", prev_line)) {
-            curr_line.erase(0, 4); // removing "MOV "
-            vector<string> curr_line_regs = split_str(curr_line, ", ");
-
-            prev_line.erase(0, 4); 
-            vector<string> prev_line_regs = split_str(prev_line, ", ");
-            
-            if (curr_line_regs[0] == prev_line_regs[1] && curr_line_regs[1] == prev_line_regs[0]) {
-                all_code[i] = "; PEEPHOLE " + all_code[i];
-            }
-        } else if (starts_with("ADD", curr_line)) {
-            curr_line.erase(0, 4); // removing "ADD "
-            vector<string> operands = split_str(curr_line, ", ");
-            if (operands[1] == "0") {
-                all_code[i] = "; PEEPHOLE " + all_code[i];
-            }
-        } else if (starts_with("PUSH", curr_line) && starts_with("POP", prev_line)) {
-            prev_line.erase(0, 4); // removing "POP "
-            curr_line.erase(0, 5); // removing "PUSH "
-            
-            if (curr_line == prev_line) {
-                all_code[prev_idx] = "; PEEPHOLE" + all_code[prev_idx];
-                all_code[i] = "; PEEPHOLE" + all_code[i];
-            }
-        } else if (starts_with("POP", curr_line) && starts_with("PUSH", prev_line)) {
-            prev_line.erase(0, 5); // removing "PUSH "
-            curr_line.erase(0, 4); // removing "POP "
-            
-            if (curr_line == prev_line) {
-                all_code[prev_idx] = "; PEEPHOLE" + all_code[prev_idx];
-                all_code[i] = "; PEEPHOLE" + all_code[i];
-            }
-        }
+/** 
+    General utils
+**/
+
+/**
+    Compiles a source program with the options of the context: Analysis, inlining, dead code elimination,
+    Synthesis and peephole optimization. All state of the compilation lives in the context, so contexts on
+    different threads compile independently.
 
-        prev_idx = i;
+    @param ctx Context of the compilation, not used for another one
+    @param source_file_name Source file, "-" for stdin
+    @return Exit status, 0 also if the program has errors
+**/
+int compile(CompilerContext& ctx, const string& source_file_name) {
+    // Analysis: single pass over the input, builds the AST. "-" reads the program from stdin.
+    ctx.stats.start_phase("Source loading");
+    bool is_source_loaded = ctx.source_buffer.open(source_file_name);
+    ctx.log_file.open(ctx.options.log_file_name);
+    ctx.error_file.open(ctx.options.error_file_name);
+    ctx.stats.stop_phase();
+
+    if (!is_source_loaded || !ctx.log_file || !ctx.error_file) {
+        *ctx.failure_stream << "ERROR: Could not open file\n";
+        return 1;
     }
-}
 
-void write_optimized_code_to_file(vector<string>& all_code) {
-    ofstream optim_code_file(OPTIM_CODE_FILE_NAME);
-    if (!optim_code_file) {
-        cerr << "Could not open optimized code file\n";
-        return;
+    ctx.stats.start_phase("Analysis");
+    yyscan_t scanner;
+    yylex_init_extra(&ctx, &scanner);
+    yy_buffer_state* scan_buffer = yy_scan_buffer(
+        ctx.source_buffer.get_scan_buffer(), ctx.source_buffer.get_scan_buffer_size(), scanner
+    );
+    yyparse(ctx, scanner);
+    yy_delete_buffer(scan_buffer, scanner);
+    yylex_destroy(scanner);
+    ctx.stats.add_phase_time("Lexing", ctx.lexing_time);
+    ctx.log_file << "Total lines: " << --ctx.line_count << endl;
+    ctx.log_file << "Total errors: " << ctx.error_count << endl;
+
+    ctx.log_file.close();
+    ctx.error_file.close();
+    ctx.stats.stop_phase();
+    ctx.stats.symbol_table_stats = ctx.symbol_table.get_stats();
+
+    if (ctx.error_count > 0) {
+        ctx.error_file.open(ctx.options.error_file_name);
+        *ctx.message_stream << ctx.error_file.rdbuf();
+        ctx.error_file.close();
+        *ctx.message_stream << "COMPILATION FAILED: There are errors in your program" << endl;
+        delete_debug_files(ctx);
+        ctx.arena.release();
+        write_compiler_stats(ctx, source_file_name);
+        return 0;
     }
 
-    for (string& line : all_code) {
-        optim_code_file << line << endl;
+    delete_debug_files(ctx);
+
+    // calls of small functions are replaced by their bodies, the functions may become unreachable
+    ctx.stats.start_phase("Inlining");
+    Inliner inliner(ctx.arena, ctx.string_interner);
+    inliner.inline_calls(ctx.ast_root);
+    ctx.stats.stop_phase();
+    if (ctx.options.is_inline_report_shown) {
+        inliner.write_report(*ctx.message_stream);
+    }
+
+    // unreachable functions, unused globals and statements that never run are not generated
+    ctx.stats.start_phase("Dead code elimination");
+    DeadCodeEliminator dead_code_eliminator(ctx.arena, ctx.string_interner);
+    dead_code_eliminator.eliminate(ctx.ast_root);
+    ctx.stats.stop_phase();
+
+    // Synthesis: code generation from the AST, into memory. Unchanged functions are read from the code cache.
+    ctx.stats.start_phase("Code generation");
+    CodeCache code_cache(ctx.options.cache_dir_name, ctx.options.is_cache_verified, ctx.string_interner);
+    CodeCache* code_cache_ptr = ctx.options.cache_dir_name.empty() ? nullptr : &code_cache;
+    AsmBuffer asm_buffer;
+    CodeGenerator code_generator(
+        asm_buffer, ctx.string_interner, ctx.options.is_fast_call, ctx.options.is_output_buffered,
+        ctx.options.job_count, code_cache_ptr
+    );
+    code_generator.generate(ctx.ast_root);
+    ctx.arena.release();
+    ctx.stats.stop_phase();
+
+    ctx.stats.start_phase("Code writing");
+    bool is_code_written = AsmBuffer::write_to_file(ctx.options.code_file_name,
+        structure_main_asm_code(asm_buffer, ctx.string_interner));
+    ctx.stats.stop_phase();
+    if (!is_code_written) {
+        *ctx.message_stream << "ERROR: Could not write code file\n";
+        return 1;
     }
-    optim_code_file.close();
-}
 
-vector<string> load_code_into_mem() {
-    vector<string> all_code;
-    ifstream code_file(CODE_FILE_NAME);
-    string line;
-    if (code_file.good()) {
-        while (getline(code_file, line)) {
-            all_code.push_back(line);
-        }
-    } else {
-        cerr << "Could not open code file to load into memory for optimization\n";
+    peephole_optimization(ctx, asm_buffer, code_cache_ptr);
+    if (code_cache_ptr != nullptr && (ctx.options.is_cache_stats_shown || ctx.options.is_cache_verified)) {
+        code_cache.write_stats(*ctx.message_stream);
     }
-    code_file.close();
-    return all_code;
-}
+    write_compiler_stats(ctx, source_file_name);
 
+    return 0;
+}
 
+/**
+    Prints the times of the phases and the counts of the work of a compilation, and writes them to the stats
+    file, as the options ask.
 
-/** 
-    General utils
+    @param source_file_name Source file of the compilation
 **/
+void write_compiler_stats(CompilerContext& ctx, const string& source_file_name) {
+    ctx.stats.arena_allocation_count = ctx.arena.get_allocation_count();
+    ctx.stats.arena_block_count = ctx.arena.get_block_count();
+    if (ctx.options.is_time_passes_shown) {
+        ctx.stats.write_times(*ctx.message_stream);
+    }
+    if (ctx.options.is_stats_shown) {
+        ctx.stats.write_counts(*ctx.message_stream);
+    }
+    if (ctx.options.is_stats_json_written) {
+        ofstream stats_file(ctx.options.stats_file_name);
+        ctx.stats.write_json(stats_file, source_file_name);
+        if (!stats_file) {
+            *ctx.failure_stream << "Could not write stats file\n";
+        }
+    }
+}
 
-string vec_to_str(vector<string> strings) {
+string types_to_str(const vector<SemanticType>& types) {
     stringstream ss;
-    for (string str : strings) {
-        ss << str << " ";
+    for (SemanticType type : types) {
+        ss << get_type_name(type) << " ";
     }
     return ss.str();
 }
 
-vector<string> split(string str, char delim) {
-    stringstream sstrm(str);
-    string split_str;
-    vector<string> split_strs;
+/**
+    Compiles many source programs, each with its own context, on a pool of worker threads that take the next
+    program whenever they finish one, so long and short programs balance across the threads. The outputs of
+    each program are named after it, and no program is compiled if two would write the same outputs. The
+    messages of each program are printed in the order of the programs once all are compiled, followed by a
+    summary of the programs that failed.
+
+    @param options Options of all the programs
+    @param source_file_names Source files
+    @return 0 if every program is compiled without errors, 1 otherwise
+**/
+int compile_batch(const CompilerOptions& options, const vector<string>& source_file_names) {
+    int source_count = source_file_names.size();
+    vector<int> statuses(source_count), error_counts(source_count);
+    vector<ostringstream> message_streams(source_count), failure_streams(source_count);
+
+    // e.g. a/prog.c and b/prog.c with an output directory, or prog.c and prog.sc in the same directory
+    map<string, int> output_source_indices;
+    for (int i = 0; i < source_count; i++) {
+        string output_prefix = get_output_prefix(options, source_file_names[i]);
+        error_code path_error;
+        string prefix_key = filesystem::weakly_canonical(output_prefix, path_error).string();
+        prefix_key = path_error ? output_prefix : prefix_key;
+        auto prefix_iter = output_source_indices.find(prefix_key);
+        if (prefix_iter != output_source_indices.end()) {
+            cerr << "ERROR: " << source_file_names[prefix_iter->second] << " and " << source_file_names[i] <<
+                " would both be compiled to " << output_prefix << ".asm\n";
+            return 1;
+        }
+        output_source_indices[prefix_key] = i;
+    }
+
+    if (!create_output_dir(options)) {
+        return 1;
+    }
+
+    WorkerPool(options.job_count).run(source_count, [&](int i) {
+        CompilerContext ctx(get_source_options(options, source_file_names[i]));
+        ctx.message_stream = &message_streams[i];
+        ctx.failure_stream = &failure_streams[i];
+        statuses[i] = compile(ctx, source_file_names[i]);
+        error_counts[i] = ctx.error_count;
+    });
 
-    while (getline(sstrm, split_str, delim)) {
-        split_strs.push_back(split_str);    
+    vector<int> failed_indices;
+    for (int i = 0; i < source_count; i++) {
+        if (!message_streams[i].str().empty() || !failure_streams[i].str().empty()) {
+            cout << "==> " << source_file_names[i] << " <==" << endl;
+            cout << message_streams[i].str();
+            cerr << failure_streams[i].str();
+        }
+        if (statuses[i] != 0 || error_counts[i] > 0) {
+            failed_indices.push_back(i);
+        }
     }
 
-    return split_strs; 
+    cout << "Compiled " << source_count << " programs, " << failed_indices.size() << " failed" << endl;
+    for (int i : failed_indices) {
+        cout << "FAILED: " << source_file_names[i] << " (";
+        if (statuses[i] != 0) {
+            cout << "could not be compiled";
+        } else {
+            cout << error_counts[i] << (error_counts[i] == 1 ? " error" : " errors");
+        }
+        cout << ")" << endl;
+    }
+    return failed_indices.empty() ? 0 : 1;
 }
 
-bool starts_with(const string& start, const string& subject) {
-    return subject.find(start) == 0;
+/**
+    Creates the output directory, if one is set and it does not exist.
+
+    @param options Options of the compilation
+    @return false if the directory could not be created
+**/
+bool create_output_dir(const CompilerOptions& options) {
+    error_code dir_error;
+    if (!options.output_dir_name.empty() && !filesystem::create_directories(options.output_dir_name, dir_error) &&
+        dir_error) {
+        cerr << "ERROR: Could not create output directory\n";
+        return false;
+    }
+    return true;
 }
 
-vector<string> split_str(const string str, const string delim) {
-    vector<string> split;
-    int str_start = 0;
-    for (int delim_pos = str.find(delim); delim_pos != string::npos; delim_pos = str.find(delim, str_start)) {
-        split.push_back(str.substr(str_start, delim_pos - str_start));
-        str_start = delim_pos + delim.length();
+/**
+    Places the outputs of a single program in the output directory, if one is set, under the names they have
+    without it.
+
+    @param options Options of the program
+    @return Options of the program, with the outputs in the output directory
+**/
+CompilerOptions get_output_dir_options(const CompilerOptions& options) {
+    CompilerOptions dir_options = options;
+    if (options.output_dir_name.empty()) {
+        return dir_options;
     }
-    if (str_start < str.size()) {
-        split.push_back(str.substr(str_start));
+
+    filesystem::path output_path(options.output_dir_name);
+    for (string* file_name_ptr : {&dir_options.code_file_name, &dir_options.optim_code_file_name,
+        &dir_options.log_file_name, &dir_options.error_file_name, &dir_options.stats_file_name}) {
+        *file_name_ptr = (output_path / *file_name_ptr).string();
     }
-    return split;
+    return dir_options;
 }
 
-void replace_substr(string& subject, const string target, const string replacement) {
-    size_t pos = 0;
-    while ((pos = subject.find(target, pos)) != string::npos) {
-        subject.replace(pos, target.length(), replacement);
-        pos += replacement.length();
-    }
+/**
+    Names the outputs of a program of a batch after its source file: the code files, the debug files and the
+    stats file of dir/prog.c are dir/prog.asm, dir/prog_optimized.asm, dir/prog.log.txt, dir/prog.error.txt
+    and dir/prog.stats.json, in the output directory instead of dir if one is set.
+
+    @param options Options of the batch
+    @param source_file_name Source file of the program
+    @return Options of the program
+**/
+CompilerOptions get_source_options(const CompilerOptions& options, const string& source_file_name) {
+    string output_prefix = get_output_prefix(options, source_file_name);
+
+    // the programs are already compiled in parallel, each one on a single thread
+    CompilerOptions source_options = options;
+    source_options.job_count = 1;
+    source_options.code_file_name = output_prefix + ".asm";
+    source_options.optim_code_file_name = output_prefix + "_optimized.asm";
+    source_options.log_file_name = output_prefix + ".log.txt";
+    source_options.error_file_name = output_prefix + ".error.txt";
+    source_options.stats_file_name = output_prefix + ".stats.json";
+    return source_options;
 }
 
-void trim(string& str) {
-    string ws = " \t";
-    str.erase(0, str.find_first_not_of(ws));
-    str.erase(str.find_last_not_of(ws) + 1);
+/**
+    @param options Options of the batch
+    @param source_file_name Source file of a program
+    @return Path the outputs of the program are named by, dir/prog for dir/prog.c
+**/
+string get_output_prefix(const CompilerOptions& options, const string& source_file_name) {
+    filesystem::path source_path(source_file_name);
+    filesystem::path output_path = options.output_dir_name.empty() ?
+        source_path.parent_path() : filesystem::path(options.output_dir_name);
+    return (output_path / source_path.stem()).string();
 }
 
-void copy_txt_file(ifstream& from_file, ofstream& to_file) {
-    string line;
-    while (getline(from_file, line)) {
-        to_file << line << endl;
+/**
+    Reads the command line: options set the output files, the remaining arguments are the source files. The
+    output files can only be set for a single source file, "-" can only be the single source file.
+
+    @param argc Number of arguments
+    @param argv Arguments
+    @param options Set from the options
+    @param source_file_names Set to the source files, "-" for stdin
+    @return false if the arguments are malformed
+**/
+bool parse_args(int argc, char* argv[], CompilerOptions& options, vector<string>& source_file_names) {
+    bool is_output_file_set = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--code-out" && i + 1 < argc) {
+            options.code_file_name = argv[++i];
+            is_output_file_set = true;
+        } else if (arg == "--optimized-out" && i + 1 < argc) {
+            options.optim_code_file_name = argv[++i];
+            is_output_file_set = true;
+        } else if (arg == "--peephole-stats") {
+            options.is_peephole_stats_shown = true;
+        } else if (arg == "--inline-report") {
+            options.is_inline_report_shown = true;
+        } else if (arg == "--fast-call") {
+            options.is_fast_call = true;
+        } else if (arg == "--buffer-output") {
+            options.is_output_buffered = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            char* end_ptr;
+            options.job_count = strtol(argv[++i], &end_ptr, 10);
+            if (*end_ptr != '\0' || options.job_count < 1) {
+                return false;
+            }
+        } else if (arg == "--out-dir" && i + 1 < argc) {
+            options.output_dir_name = argv[++i];
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            options.cache_dir_name = argv[++i];
+        } else if (arg == "--cache-verify") {
+            options.is_cache_verified = true;
+        } else if (arg == "--cache-stats") {
+            options.is_cache_stats_shown = true;
+        } else if (arg == "--time-passes") {
+            options.is_time_passes_shown = true;
+        } else if (arg == "--stats") {
+            options.is_stats_shown = true;
+        } else if (arg == "--stats-json") {
+            options.is_stats_json_written = true;
+        } else if (arg == "-" || arg[0] != '-') {
+            source_file_names.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+
+    if (source_file_names.size() > 1) {
+        bool is_stdin_read = find(source_file_names.begin(), source_file_names.end(), "-") != source_file_names.end();
+        return !is_output_file_set && !is_stdin_read;
     }
+    return !source_file_names.empty();
 }
 
-void delete_debug_files() {
-    if (remove("error.txt") != 0 || remove("log.txt") != 0) {
-        cerr << "Error: Could not delete debug files" << endl;
+void delete_debug_files(CompilerContext& ctx) {
+    if (remove(ctx.options.error_file_name.c_str()) != 0 || remove(ctx.options.log_file_name.c_str()) != 0) {
+        *ctx.failure_stream << "Error: Could not delete debug files" << endl;
     }   
 }
\ No newline at end of file
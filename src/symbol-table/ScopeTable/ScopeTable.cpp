@@ -3,56 +3,56 @@
 
 using namespace std;
 
-ScopeTable::ScopeTable(const int total_buckets, ScopeTable* parent_scope_ptr)
-    : hashtable(new SymbolInfoHashTable(total_buckets)), num_deleted_children(0) {
+ScopeTable::ScopeTable(const int total_buckets, ScopeTable* parent_scope_ptr, StringInterner& string_interner)
+    : hashtable(new SymbolInfoHashTable(total_buckets, string_interner)), num_deleted_children(0) {
     this->hashtable->enclosing_scope_table_ptr = this;
     this->set_parent_scope_ptr_with_id_currentid(parent_scope_ptr);
 
-    // cout << "New ScopeTable with id " << this->id << " created\n";
+    // cout << "New ScopeTable with id " << this->get_id() << " created\n";
 }
 
 ScopeTable::~ScopeTable() {
     delete this->hashtable;
-    // cout << "ScopeTable with id " << this->id << " removed\n";
+    // cout << "ScopeTable with id " << this->get_id() << " removed\n";
 }
 
 /**
  * @brief Allocates symbol info with provided args. Hashes them into the chain of the proper bucket.
  *
- * @param symbol Name of the token to be allocated
+ * @param symbol_id Handle of the name of the token to be allocated
  * @param token_type Type of the token to be allocated
  * @return true When insertion is successful.
  * @return false When insertion is not successful. (collision)
  */
-bool ScopeTable::insert(const string& symbol, const string& token_type) {
-    return this->hashtable->insert(symbol, token_type);
+bool ScopeTable::insert(int symbol_id, const string& token_type) {
+    return this->hashtable->insert(symbol_id, token_type);
 }
 
 /**
  * @brief Allocates symbol info with provided args. Hashes them into the chain of the proper bucket.
  *
- * @param symbol Name of the token to be allocated
+ * @param symbol_id Handle of the name of the token to be allocated
  * @param token_type Type of the token to be allocated
  * @param semantic_type Type for semantic analysis
  * @return true When insertion is successful.
  * @return false When insertion is not successful. (collision)
  */
-bool ScopeTable::insert(const string& symbol, const string& token_type, string& semantic_type) {
-    return this->hashtable->insert(symbol, token_type, semantic_type);
+bool ScopeTable::insert(int symbol_id, const string& token_type, SemanticType semantic_type) {
+    return this->hashtable->insert(symbol_id, token_type, semantic_type);
 }
 
 /**
  * @brief Allocates symbol info with provided args. Hashes them into the chain of the proper bucket.
  *
- * @param symbol Name of the token to be allocated
+ * @param symbol_id Handle of the name of the token to be allocated
  * @param token_type Type of the token to be allocated
  * @param semantic_type Type for semantic analysis
- * @param data Additional data strings for semantic analysis
+ * @param signature Interned signature of a function
  * @return true When insertion is successful.
  * @return false When insertion is not successful. (collision)
  */
-bool ScopeTable::insert(const string& symbol, const string& token_type, string& semantic_type, vector<string>& data) {
-    return this->hashtable->insert(symbol, token_type, semantic_type, data);
+bool ScopeTable::insert(int symbol_id, const string& token_type, SemanticType semantic_type, const FuncSignature* signature) {
+    return this->hashtable->insert(symbol_id, token_type, semantic_type, signature);
 }
 
 /**
@@ -69,27 +69,35 @@ bool ScopeTable::insert_copy(SymbolInfo* syminfo_ptr) {
 /**
  * @brief Looks up the token by name.
  *
- * @param symbol Name of token to search.
+ * @param symbol_id Handle of the name of token to search.
  * @return SymbolInfo* Pointer to the searched token. If not found, nullptr is returned.
  */
-SymbolInfo* ScopeTable::lookup(const string& symbol) {
-    return this->hashtable->lookup(symbol);
+SymbolInfo* ScopeTable::lookup(int symbol_id) {
+    return this->hashtable->lookup(symbol_id);
 }
 
 /**
  * @brief Deallocates the token of the provided name.
  *
- * @param symbol Name of the token to be deleted
+ * @param symbol_id Handle of the name of the token to be deleted
  * @return true When deletion was successful
  * @return false When deletion was not successful (Not found)
  */
-bool ScopeTable::delete_symbolinfo(const string& symbol) {
-    return this->hashtable->delete_symbolinfo(symbol);
+bool ScopeTable::delete_symbolinfo(int symbol_id) {
+    return this->hashtable->delete_symbolinfo(symbol_id);
+}
+
+/**
+ * @brief Deallocates all tokens, so the scope table can be recycled for a new scope.
+ */
+void ScopeTable::clear() {
+    this->hashtable->clear();
+    this->num_deleted_children = 0;
 }
 
 /**
  * @brief Sets parent_scope_ptr attribute for this scope table. It also sets current_id (int)
- * and id (string) attribute for this scope table from the parent scope.
+ * and the sequence among the parent's children, that make up the id, from the parent scope.
  *
  * When parent scope ptr is set to nullptr, it is interpreted that the scope table has no parent
  * scope, therefore is of depth 1.
@@ -99,11 +107,10 @@ void ScopeTable::set_parent_scope_ptr_with_id_currentid(ScopeTable* parent_scope
 
     if (this->parent_scope_ptr != nullptr) {
         this->current_id = this->parent_scope_ptr->current_id + 1;
-        this->id = this->parent_scope_ptr->get_id() + "." +
-            to_string(this->parent_scope_ptr->get_num_deleted_children() + 1);
+        this->child_seq = this->parent_scope_ptr->get_num_deleted_children() + 1;
     } else {
         this->current_id = 1;
-        this->id = "1";
+        this->child_seq = 1;
     }
 }
 
@@ -119,8 +126,14 @@ ScopeTable* ScopeTable::get_parent_scope() {
     return this->parent_scope_ptr;
 }
 
+/**
+ * @brief Returns the dotted id of this scope table, the sequences of all enclosing scope tables and this.
+ */
 string ScopeTable::get_id() {
-    return this->id;
+    if (this->parent_scope_ptr == nullptr) {
+        return to_string(this->child_seq);
+    }
+    return this->parent_scope_ptr->get_id() + "." + to_string(this->child_seq);
 }
 
 int ScopeTable::get_current_id() {
@@ -131,11 +144,18 @@ int ScopeTable::get_size() {
     return this->hashtable->get_size();
 }
 
+/**
+ * @brief Adds the allocations and probes of the scope table, in all the scopes it was used for, to the counts.
+ */
+void ScopeTable::add_stats(SymbolTableStats& stats) {
+    this->hashtable->add_stats(stats);
+}
+
 void ScopeTable::print() {
     const string INDENT = "\t";
     cout << endl;
     cout << INDENT;
-    cout << "Scopetable # " << this->id << endl;
+    cout << "Scopetable # " << this->get_id() << endl;
     this->hashtable->print();
 }
 
@@ -143,7 +163,7 @@ ostream& operator<<(ostream& ostrm, ScopeTable& scope_table) {
     const string INDENT = "\t";
     ostrm << endl;
     ostrm << INDENT;
-    ostrm << "Scopetable # " << scope_table.id << endl;
+    ostrm << "Scopetable # " << scope_table.get_id() << endl;
     ostrm << *scope_table.hashtable;
     return ostrm;
 }
\ No newline at end of file
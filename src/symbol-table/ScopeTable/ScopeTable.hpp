@@ -5,24 +5,27 @@
 using namespace std;
 
 class SymbolInfoHashTable;
+struct SymbolTableStats;
 
 /**
  * @brief Wrapper class on the Hashtable that holds all the tokens for the current scope.
  * Holds the depth of this scope table in comparison to all previous scope tables.
  * Also has a more complete id that is unique to this scope tale, that represents the the
- * relative depth and sequence of this scope table in comparison to earlier scope tables.
+ * relative depth and sequence of this scope table in comparison to earlier scope tables. The id is
+ * only built when it is printed.
  *
  * Can perform insertion, lookup, deletion for the tokens in the hashtable.
  */
 class ScopeTable {
     SymbolInfoHashTable* hashtable;
     int current_id;
-    string id;
+    // sequence of this scope table among the children of its parent
+    int child_seq;
     ScopeTable* parent_scope_ptr;
     int num_deleted_children;
 
 public:
-    ScopeTable(int, ScopeTable*);
+    ScopeTable(int, ScopeTable*, StringInterner&);
 
     ~ScopeTable();
 
@@ -40,17 +43,21 @@ public:
 
     int get_size();
 
-    bool insert(const string&, const string&);
+    bool insert(int, const string&);
 
-    bool insert(const string&, const string&, string&);
+    bool insert(int, const string&, SemanticType);
 
-    bool insert(const string&, const string&, string&, vector<string>&);
+    bool insert(int, const string&, SemanticType, const FuncSignature*);
 
     bool insert_copy(SymbolInfo*);
 
-    SymbolInfo* lookup(const string&);
+    SymbolInfo* lookup(int);
 
-    bool delete_symbolinfo(const string&);
+    bool delete_symbolinfo(int);
+
+    void clear();
+
+    void add_stats(SymbolTableStats&);
 
     void print();
 
@@ -1,42 +1,29 @@
+#include <algorithm>
 #include "SymbolInfoHashTable.hpp"
 
 using namespace std;
 
-namespace printing_info {
-    int _chain_index = -1;
-}
-
-SymbolInfoHashTable::SymbolInfoHashTable(const int total_buckets)
-    : total_buckets(total_buckets), table(total_buckets, nullptr), size{0} {}
+const int MIN_NUM_SLOTS = 8;
+// table grows when more than MAX_LOAD_NUM / MAX_LOAD_DEN of the slots are occupied
+const int MAX_LOAD_NUM = 3, MAX_LOAD_DEN = 4;
 
-void _delete_chain(SymbolInfo* const chain_root) {
-    SymbolInfo* current = chain_root;
-    while (current != nullptr) {
-        SymbolInfo* next = current->next_syminfo_ptr;
-        delete current;
-        current = next;
+int _get_initial_num_slots(int total_buckets) {
+    int num_slots = MIN_NUM_SLOTS;
+    while (num_slots < total_buckets) {
+        num_slots *= 2;
     }
+    return num_slots;
 }
 
-SymbolInfoHashTable::~SymbolInfoHashTable() {
-    for (SymbolInfo* chain_root : this->table) {
-        _delete_chain(chain_root);
-    }
-}
+SymbolInfoHashTable::SymbolInfoHashTable(const int total_buckets, StringInterner& string_interner)
+    : total_buckets(total_buckets), string_interner(string_interner),
+    slots(_get_initial_num_slots(total_buckets), Slot{nullptr, 0, 0}), size{0},
+    next_insertion_seq{0}, allocation_count{0}, probe_count{0}, probed_slot_count{0} {}
 
-SymbolInfo* _find_syminfo_name_in_chain(const string& symbol, SymbolInfo* const chain_root) {
-    SymbolInfo* current = chain_root;
-    int idx = 0;
-    while (current != nullptr) {
-        if (current->get_symbol() == symbol) {
-            break;
-        }
-        current = current->next_syminfo_ptr;
-        idx++;
+SymbolInfoHashTable::~SymbolInfoHashTable() {
+    for (Slot& slot : this->slots) {
+        delete slot.syminfo_ptr;
     }
-    printing_info::_chain_index = idx;
-
-    return current;
 }
 
 int SymbolInfoHashTable::get_num_buckets() {
@@ -47,60 +34,37 @@ int SymbolInfoHashTable::get_size() {
     return this->size;
 }
 
-void _insert_at_the_end_of_chain(SymbolInfo* const insertion, vector<SymbolInfo*>& table, int bucket) {
-    SymbolInfo* current_sym_info = table[bucket];
-
-    int idx = 0;
-    if (current_sym_info == nullptr) {
-        table[bucket] = insertion;
-    } else {
-        idx++;
-        while (current_sym_info->next_syminfo_ptr != nullptr) {
-            idx++;
-            current_sym_info = current_sym_info->next_syminfo_ptr;
-        }
-        current_sym_info->next_syminfo_ptr = insertion;
-    }
-    printing_info::_chain_index = idx;
-}
-
-bool SymbolInfoHashTable::insert(const string& symbol, const string& token_type) {
-    int bucket = this->hash(symbol);
-    SymbolInfo* collision = _find_syminfo_name_in_chain(symbol, this->table[bucket]);
+bool SymbolInfoHashTable::insert(int symbol_id, const string& token_type) {
+    unsigned long symbol_hash = this->string_interner.get_hash(symbol_id);
+    int slot_idx = this->find_slot(symbol_id, symbol_hash);
 
-    if (collision == nullptr) {
-        SymbolInfo* insertion = new SymbolInfo(symbol, token_type);
-        _insert_at_the_end_of_chain(insertion, this->table, bucket);
-        this->size++;
+    if (this->slots[slot_idx].syminfo_ptr == nullptr) {
+        this->occupy_slot(slot_idx, new SymbolInfo(symbol_id, token_type), symbol_hash);
         return true;
     } else {
         return false;
     }
 }
 
-bool SymbolInfoHashTable::insert(const string& symbol, const string& token_type, string& semantic_type) {
-    int bucket = this->hash(symbol);
-    SymbolInfo* collision = _find_syminfo_name_in_chain(symbol, this->table[bucket]);
+bool SymbolInfoHashTable::insert(int symbol_id, const string& token_type, SemanticType semantic_type) {
+    unsigned long symbol_hash = this->string_interner.get_hash(symbol_id);
+    int slot_idx = this->find_slot(symbol_id, symbol_hash);
 
-    if (collision == nullptr) {
-        SymbolInfo* insertion = new SymbolInfo(symbol, token_type, semantic_type);
-        _insert_at_the_end_of_chain(insertion, this->table, bucket);
-        this->size++;
+    if (this->slots[slot_idx].syminfo_ptr == nullptr) {
+        this->occupy_slot(slot_idx, new SymbolInfo(symbol_id, token_type, semantic_type), symbol_hash);
         return true;
     } else {
         return false;
     }
 }
 
-bool SymbolInfoHashTable::insert(const string& symbol, const string& token_type, string& semantic_type, 
-    vector<string>& data) {
-    int bucket = this->hash(symbol);
-    SymbolInfo* collision = _find_syminfo_name_in_chain(symbol, this->table[bucket]);
+bool SymbolInfoHashTable::insert(int symbol_id, const string& token_type, SemanticType semantic_type, 
+    const FuncSignature* signature) {
+    unsigned long symbol_hash = this->string_interner.get_hash(symbol_id);
+    int slot_idx = this->find_slot(symbol_id, symbol_hash);
 
-    if (collision == nullptr) {
-        SymbolInfo* insertion = new SymbolInfo(symbol, token_type, semantic_type, data);
-        _insert_at_the_end_of_chain(insertion, this->table, bucket);
-        this->size++;
+    if (this->slots[slot_idx].syminfo_ptr == nullptr) {
+        this->occupy_slot(slot_idx, new SymbolInfo(symbol_id, token_type, semantic_type, signature), symbol_hash);
         return true;
     } else {
         return false;
@@ -108,113 +72,170 @@ bool SymbolInfoHashTable::insert(const string& symbol, const string& token_type,
 }
 
 bool SymbolInfoHashTable::insert_copy(SymbolInfo* syminfo_ptr) {
-    int bucket = this->hash(syminfo_ptr->get_symbol());
-    SymbolInfo* collision = _find_syminfo_name_in_chain(syminfo_ptr->get_symbol(), this->table[bucket]);
+    unsigned long symbol_hash = this->string_interner.get_hash(syminfo_ptr->get_symbol_id());
+    int slot_idx = this->find_slot(syminfo_ptr->get_symbol_id(), symbol_hash);
 
-    if (collision == nullptr) {
-        SymbolInfo* insertion = new SymbolInfo(*syminfo_ptr);
-        _insert_at_the_end_of_chain(insertion, this->table, bucket);
-        this->size++;
+    if (this->slots[slot_idx].syminfo_ptr == nullptr) {
+        this->occupy_slot(slot_idx, new SymbolInfo(*syminfo_ptr), symbol_hash);
         return true;
     } else {
         return false;
     }
 }
 
-SymbolInfo* SymbolInfoHashTable::lookup(const string& symbol) {
-    int bucket = this->hash(symbol);
-    SymbolInfo* target = _find_syminfo_name_in_chain(symbol, this->table[bucket]);
-
-    return target;
+SymbolInfo* SymbolInfoHashTable::lookup(int symbol_id) {
+    return this->slots[this->find_slot(symbol_id, this->string_interner.get_hash(symbol_id))].syminfo_ptr;
 }
 
-bool SymbolInfoHashTable::delete_symbolinfo(const string& symbol) {
-    int bucket = this->hash(symbol);
-
-    SymbolInfo* current = this->table[bucket];
-
-    bool is_successful_delete = false;
-
-    if (current != nullptr && current->get_symbol() == symbol) {
-        this->table[bucket] = current->next_syminfo_ptr;
-
-        delete current;
-        is_successful_delete = true;
-
-        printing_info::_chain_index = 0;
-    } else {
-        // keep track of prev to connect chain after removing target.
-        SymbolInfo* prev = nullptr;
+/**
+ * @brief Deletes the symbol and shifts back the symbols probed past it, so no probe sequence is broken
+ * and no tombstones are needed.
+ */
+bool SymbolInfoHashTable::delete_symbolinfo(int symbol_id) {
+    int hole = this->find_slot(symbol_id, this->string_interner.get_hash(symbol_id));
+    if (this->slots[hole].syminfo_ptr == nullptr) {
+        return false;
+    }
 
-        int idx = 0;
-        while (current != nullptr) {
-            if (current->get_symbol() == symbol) {
-                break;
-            }
-            prev = current;
-            current = current->next_syminfo_ptr;
-            idx++;
+    delete this->slots[hole].syminfo_ptr;
+    this->size--;
+
+    const int mask = this->slots.size() - 1;
+    for (int next = (hole + 1) & mask; this->slots[next].syminfo_ptr != nullptr; next = (next + 1) & mask) {
+        int home = this->slots[next].hash & mask;
+        // the symbol at next can fill the hole only if its home slot is not after the hole (cyclically)
+        bool is_home_after_hole = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!is_home_after_hole) {
+            this->slots[hole] = this->slots[next];
+            hole = next;
         }
+    }
+    this->slots[hole] = Slot{nullptr, 0, 0};
 
-        if (current != nullptr) {
-            prev->next_syminfo_ptr = current->next_syminfo_ptr;
+    return true;
+}
 
-            delete current;
-            is_successful_delete = true;
-            printing_info::_chain_index = idx;
+/**
+ * @brief Deletes all symbols. The slots are kept, so a recycled table does not grow again.
+ */
+void SymbolInfoHashTable::clear() {
+    for (Slot& slot : this->slots) {
+        delete slot.syminfo_ptr;
+        slot = Slot{nullptr, 0, 0};
+    }
+    this->size = 0;
+    this->next_insertion_seq = 0;
+}
+
+/**
+ * @brief Adds the allocations and probes of the table to the counts.
+ */
+void SymbolInfoHashTable::add_stats(SymbolTableStats& stats) {
+    stats.allocation_count += this->allocation_count;
+    stats.probe_count += this->probe_count;
+    stats.probed_slot_count += this->probed_slot_count;
+}
+
+/**
+ * @brief Probes for the symbol.
+ *
+ * @param symbol_id Handle of the symbol name
+ * @param symbol_hash Hash of the symbol name
+ * @return int Slot of the symbol if present, otherwise the empty slot where it would be inserted
+ */
+int SymbolInfoHashTable::find_slot(int symbol_id, unsigned long symbol_hash) {
+    const int mask = this->slots.size() - 1;
+    int slot_idx = symbol_hash & mask;
+    this->probe_count++;
+    this->probed_slot_count++;
+    while (this->slots[slot_idx].syminfo_ptr != nullptr) {
+        if (this->slots[slot_idx].syminfo_ptr->get_symbol_id() == symbol_id) {
+            break;
         }
+        slot_idx = (slot_idx + 1) & mask;
+        this->probed_slot_count++;
     }
+    return slot_idx;
+}
 
-    if (is_successful_delete) {
-        this->size--;
-    }
+void SymbolInfoHashTable::occupy_slot(int slot_idx, SymbolInfo* syminfo_ptr, unsigned long symbol_hash) {
+    this->slots[slot_idx] = Slot{syminfo_ptr, symbol_hash, this->next_insertion_seq++};
+    this->size++;
+    this->allocation_count++;
 
-    return is_successful_delete;
+    if (this->size * MAX_LOAD_DEN > (int) this->slots.size() * MAX_LOAD_NUM) {
+        this->grow();
+    }
 }
 
-int SymbolInfoHashTable::hash(const string& symbol) {
-    unsigned long hash = 0;
-    for (auto ch : symbol) {
-        hash = ch + (hash << 6) + (hash << 16) - hash;
+/**
+ * @brief Doubles the slots and reinserts all symbols, using the cached hashes.
+ */
+void SymbolInfoHashTable::grow() {
+    vector<Slot> old_slots(this->slots.size() * 2, Slot{nullptr, 0, 0});
+    old_slots.swap(this->slots);
+
+    const int mask = this->slots.size() - 1;
+    for (Slot& slot : old_slots) {
+        if (slot.syminfo_ptr != nullptr) {
+            int slot_idx = slot.hash & mask;
+            while (this->slots[slot_idx].syminfo_ptr != nullptr) {
+                slot_idx = (slot_idx + 1) & mask;
+            }
+            this->slots[slot_idx] = slot;
+        }
     }
-    return hash % this->total_buckets;
 }
 
-void _print_chain(SymbolInfo* const symbol_info_ptr) {
-    SymbolInfo* current = symbol_info_ptr;
-    while (current != nullptr) {
-        current = current->next_syminfo_ptr;
+/**
+ * @brief Returns the symbols grouped by bucket, each bucket in order of insertion.
+ */
+vector<vector<SymbolInfo*>> SymbolInfoHashTable::get_buckets() {
+    vector<Slot> occupied_slots;
+    for (Slot& slot : this->slots) {
+        if (slot.syminfo_ptr != nullptr) {
+            occupied_slots.push_back(slot);
+        }
     }
-}
+    sort(occupied_slots.begin(), occupied_slots.end(), [](const Slot& a, const Slot& b) {
+        return a.insertion_seq < b.insertion_seq;
+    });
 
-void _print_chain(SymbolInfo* const symbol_info_ptr, ostream& ostrm) {
-    SymbolInfo* current = symbol_info_ptr;
-    while (current != nullptr) {
-        ostrm << *current << " ";
+    vector<vector<SymbolInfo*>> buckets(this->total_buckets);
+    for (Slot& slot : occupied_slots) {
+        buckets[slot.hash % this->total_buckets].push_back(slot.syminfo_ptr);
+    }
+    return buckets;
+}
 
-        current = current->next_syminfo_ptr;
+void _print_chain(const vector<SymbolInfo*>& chain, StringInterner& string_interner, ostream& ostrm) {
+    for (SymbolInfo* syminfo_ptr : chain) {
+        ostrm << "<" << string_interner.get_string(syminfo_ptr->get_symbol_id()) << ", " <<
+            syminfo_ptr->get_token_type() << "> ";
     }
 }
 
 void SymbolInfoHashTable::print() {
     const string INDENT = "\t\t";
+    vector<vector<SymbolInfo*>> buckets = this->get_buckets();
     cout << endl;
     for (int i = 0; i < this->total_buckets; i++) {
         cout << INDENT;
         cout << "Bucket " << i << " : ";
-        _print_chain(this->table[i]);
+        _print_chain(buckets[i], this->string_interner, cout);
         cout << endl;
     }
 }
 
 ostream& operator<<(ostream& ostrm, SymbolInfoHashTable& hash_table) {
     const string INDENT = "\t\t";
+    vector<vector<SymbolInfo*>> buckets = hash_table.get_buckets();
     ostrm << endl;
     for (int i = 0; i < hash_table.total_buckets; i++) {
-        if (hash_table.table[i] != nullptr) {
+        if (!buckets[i].empty()) {
             ostrm << INDENT;
             ostrm << "Bucket " << i << " : ";
-            _print_chain(hash_table.table[i], ostrm);
+            _print_chain(buckets[i], hash_table.string_interner, ostrm);
             ostrm << endl;
         }
     }
@@ -12,16 +12,47 @@ using namespace std;
 class ScopeTable; 
 
 /**
- * @brief Implementation for the token hash table of a Scope Table.
+ * @brief Counts of the work of a symbol table: the symbols allocated, the scopes entered, and the probes for
+ * a symbol with the slots they looked at.
+ */
+struct SymbolTableStats {
+    unsigned long allocation_count;
+    unsigned long scope_count;
+    unsigned long probe_count;
+    unsigned long probed_slot_count;
+};
+
+/**
+ * @brief Implementation for the token hash table of a Scope Table, keyed on interned symbol names. Open
+ * addressing with linear probing, every slot caches the hash of its symbol, computed once by the string
+ * interner, and names are compared by handle. Slots are doubled when the load factor gets too high.
+ *
+ * The number of buckets is only used for printing: symbols are grouped into buckets, in order of
+ * insertion, as a separately chained table with that many buckets would hold them.
+ *
+ * The hashes and the names printed come from the string interner of the compilation.
+ *
+ * Counts its allocations and probes, a recycled table keeps counting.
  */
 class SymbolInfoHashTable {
+    struct Slot {
+        SymbolInfo* syminfo_ptr;
+        unsigned long hash;
+        unsigned long insertion_seq;
+    };
+
     const int total_buckets;
-    vector<SymbolInfo*> table;
+    StringInterner& string_interner;
+    vector<Slot> slots;
     int size;
+    unsigned long next_insertion_seq;
+    unsigned long allocation_count;
+    unsigned long probe_count;
+    unsigned long probed_slot_count;
 public:
     ScopeTable* enclosing_scope_table_ptr;
 
-    SymbolInfoHashTable(const int total_buckets);
+    SymbolInfoHashTable(const int total_buckets, StringInterner&);
 
     ~SymbolInfoHashTable();
 
@@ -29,22 +60,32 @@ public:
 
     int get_size();
 
-    bool insert(const string&, const string&);
+    bool insert(int, const string&);
 
-    bool insert(const string&, const string&, string&);
+    bool insert(int, const string&, SemanticType);
     
-    bool insert(const string&, const string&, string&, vector<string>&);
+    bool insert(int, const string&, SemanticType, const FuncSignature*);
 
     bool insert_copy(SymbolInfo*);
 
-    SymbolInfo* lookup(const string&);
+    SymbolInfo* lookup(int);
+
+    bool delete_symbolinfo(int);
 
-    bool delete_symbolinfo(const string&);
+    void clear();
+
+    void add_stats(SymbolTableStats&);
 
     void print();
 
     friend ostream& operator<<(ostream&, SymbolInfoHashTable&);
 
 private:
-    int hash(const string&);
-};
\ No newline at end of file
+    int find_slot(int, unsigned long);
+
+    void occupy_slot(int, SymbolInfo*, unsigned long);
+
+    void grow();
+
+    vector<vector<SymbolInfo*>> get_buckets();
+};
@@ -0,0 +1,31 @@
+#include "SignatureInterner.hpp"
+
+using namespace std;
+
+/**
+ * @brief Returns the interned signature with the given types, interning it if it is new.
+ *
+ * @param return_type Return type of the function
+ * @param param_types Parameter types of the function, empty if it has none
+ * @return const FuncSignature* Interned signature
+ */
+const FuncSignature* SignatureInterner::intern(SemanticType return_type, const vector<SemanticType>& param_types) {
+    vector<SemanticType> key;
+    key.reserve(param_types.size() + 1);
+    key.push_back(return_type);
+    key.insert(key.end(), param_types.begin(), param_types.end());
+
+    auto signature_iter = this->signature_ptrs.find(key);
+    if (signature_iter != this->signature_ptrs.end()) {
+        return signature_iter->second;
+    }
+
+    this->signatures.push_back(FuncSignature{return_type, param_types});
+    const FuncSignature* signature_ptr = &this->signatures.back();
+    this->signature_ptrs.emplace(move(key), signature_ptr);
+    return signature_ptr;
+}
+
+int SignatureInterner::get_size() {
+    return this->signatures.size();
+}
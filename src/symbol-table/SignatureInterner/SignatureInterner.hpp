@@ -0,0 +1,32 @@
+#pragma once
+#include <deque>
+#include <map>
+#include <vector>
+#include "../SymbolInfo/SemanticType.hpp"
+
+using namespace std;
+
+/**
+ * @brief Return type and parameter types of a function. Functions without parameters have an empty
+ * parameter list.
+ */
+struct FuncSignature {
+    SemanticType return_type;
+    vector<SemanticType> param_types;
+};
+
+/**
+ * @brief Stores each distinct function signature of the compilation once. Signatures are compared by
+ * comparing their pointers.
+ */
+class SignatureInterner {
+    // deque, so interned signatures never move
+    deque<FuncSignature> signatures;
+    // return type followed by the parameter types, to the interned signature
+    map<vector<SemanticType>, const FuncSignature*> signature_ptrs;
+
+public:
+    const FuncSignature* intern(SemanticType, const vector<SemanticType>&);
+
+    int get_size();
+};
@@ -0,0 +1,112 @@
+#include "StringInterner.hpp"
+
+using namespace std;
+
+const int INITIAL_NUM_SLOTS = 1024;
+
+StringInterner::StringInterner()
+    : chunks{}, size{ 0 }, slots(INITIAL_NUM_SLOTS, -1) {
+    this->intern("");
+}
+
+StringInterner::~StringInterner() {
+    for (Entry* chunk : this->chunks) {
+        delete[] chunk;
+    }
+}
+
+/**
+ * @brief Returns the handle of the name, interning it if it is new. A new name is written before the size
+ * that counts it, and before the lock is released.
+ *
+ * @param name Name to be interned, copied only if it is new
+ * @return int Handle of the name
+ */
+int StringInterner::intern(string_view name) {
+    lock_guard<mutex> guard(this->lock);
+    unsigned long name_hash = StringInterner::hash(name);
+    const int mask = this->slots.size() - 1;
+    int slot_idx = name_hash & mask;
+    while (this->slots[slot_idx] != -1) {
+        int handle = this->slots[slot_idx];
+        const Entry& entry = this->get_entry(handle);
+        if (entry.hash == name_hash && entry.name == name) {
+            return handle;
+        }
+        slot_idx = (slot_idx + 1) & mask;
+    }
+
+    // only interning writes the size, under the lock
+    int handle = this->size.load(memory_order_relaxed);
+    int chunk_idx = 0, chunk_start = 0;
+    while (handle >= chunk_start + (FIRST_CHUNK_SIZE << chunk_idx)) {
+        chunk_start += FIRST_CHUNK_SIZE << chunk_idx;
+        chunk_idx++;
+    }
+    if (this->chunks[chunk_idx] == nullptr) {
+        this->chunks[chunk_idx] = new Entry[FIRST_CHUNK_SIZE << chunk_idx];
+    }
+    this->chunks[chunk_idx][handle - chunk_start] = Entry{string(name), name_hash};
+    this->size.store(handle + 1, memory_order_release);
+    this->slots[slot_idx] = handle;
+
+    if ((handle + 1) * 2 > (int) this->slots.size()) {
+        this->grow();
+    }
+    return handle;
+}
+
+const string& StringInterner::get_string(int handle) const {
+    return this->get_entry(handle).name;
+}
+
+/**
+ * @brief Returns the hash of the name of the handle, computed when it was interned.
+ */
+unsigned long StringInterner::get_hash(int handle) const {
+    return this->get_entry(handle).hash;
+}
+
+/**
+ * @brief Returns the number of names interned, the entries of all the handles below it are seen written.
+ */
+int StringInterner::get_size() const {
+    return this->size.load(memory_order_acquire);
+}
+
+/**
+ * @brief sdbm hash of a name.
+ */
+unsigned long StringInterner::hash(string_view name) {
+    unsigned long hash = 0;
+    for (auto ch : name) {
+        hash = ch + (hash << 6) + (hash << 16) - hash;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns the entry of a handle, without the lock. A thread only gets a handle from intern, after the
+ * lock that was released once the entry was written, or from data published to it after the handle was
+ * interned, e.g. the AST the workers are started on. Either way the entry is seen written.
+ */
+const StringInterner::Entry& StringInterner::get_entry(int handle) const {
+    int chunk_idx = 0, chunk_start = 0;
+    while (handle >= chunk_start + (FIRST_CHUNK_SIZE << chunk_idx)) {
+        chunk_start += FIRST_CHUNK_SIZE << chunk_idx;
+        chunk_idx++;
+    }
+    return this->chunks[chunk_idx][handle - chunk_start];
+}
+
+void StringInterner::grow() {
+    this->slots.assign(this->slots.size() * 2, -1);
+    const int mask = this->slots.size() - 1;
+    for (int handle = 0; handle < this->size.load(memory_order_relaxed); handle++) {
+        int slot_idx = this->get_entry(handle).hash & mask;
+        while (this->slots[slot_idx] != -1) {
+            slot_idx = (slot_idx + 1) & mask;
+        }
+        this->slots[slot_idx] = handle;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// names of the first chunk of the interner, each chunk after it holds twice as many as the one before
+const int FIRST_CHUNK_SIZE = 256;
+// enough chunks for every handle below 2^31 - FIRST_CHUNK_SIZE
+const int MAX_NUM_CHUNKS = 23;
+
+/**
+ * @brief Stores each distinct name of the compilation once and hands out a stable small integer handle
+ * for it, along with the hash of the name computed once when it is interned. Names are compared by
+ * comparing handles. Handle 0 is the empty string.
+ *
+ * The functions of a program are generated on several threads, which intern and look up names
+ * concurrently. Names are appended to chunks that are never moved or freed before the interner, so looking
+ * up the name or the hash of a handle takes no lock: a handle only reaches a thread through intern, under the
+ * lock, or through data published to the thread after the name was written. Interning probes and updates
+ * the slots under the lock.
+ */
+class StringInterner {
+    struct Entry {
+        string name;
+        unsigned long hash;
+    };
+
+    // chunk i holds FIRST_CHUNK_SIZE * 2^i names, from handle FIRST_CHUNK_SIZE * (2^i - 1) on, allocated when
+    // the first of them is interned
+    Entry* chunks[MAX_NUM_CHUNKS];
+    atomic<int> size;
+    // handles in open addressing slots, -1 if empty
+    vector<int> slots;
+    mutex lock;
+
+public:
+    StringInterner();
+
+    ~StringInterner();
+
+    int intern(string_view);
+
+    const string& get_string(int) const;
+
+    unsigned long get_hash(int) const;
+
+    int get_size() const;
+
+    static unsigned long hash(string_view);
+
+private:
+    const Entry& get_entry(int) const;
+
+    void grow();
+};
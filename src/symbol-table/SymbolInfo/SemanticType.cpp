@@ -0,0 +1,13 @@
+#include "SemanticType.hpp"
+
+using namespace std;
+
+// indexed by the semantic type
+const string TYPE_NAMES[] = { "void", "int", "int_arr", "float", "float_arr" };
+
+/**
+ * @brief Returns the name of the type as it is written in error messages.
+ */
+const string& get_type_name(SemanticType type) {
+    return TYPE_NAMES[(int)type];
+}
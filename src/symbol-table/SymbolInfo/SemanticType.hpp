@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Semantic types shared by the symbol table, the AST and the code generator. Types are checked by
+ * comparing the enumerators, the names are only needed for error messages.
+ */
+enum class SemanticType : unsigned char {
+    Void, Int, IntArray, Float, FloatArray
+};
+
+const string& get_type_name(SemanticType);
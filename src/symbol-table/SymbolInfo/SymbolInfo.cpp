@@ -2,79 +2,62 @@
 
 using namespace std;
 
-SymbolInfo::SymbolInfo(const string& symbol, const string& token_type)
-    : symbol(symbol), token_type(token_type), next_syminfo_ptr{nullptr}, codegeninfo_ptr{nullptr} {
+SymbolInfo::SymbolInfo(int symbol_id, const string& token_type)
+    : symbol_id(symbol_id), semantic_type(SemanticType::Void), defined(false), token_type(token_type),
+    signature(nullptr), codegeninfo{} {
 }
 
-SymbolInfo::SymbolInfo(const string& symbol, const string& token_type, SymbolInfo* next_syminfo_ptr)
-    : SymbolInfo(symbol, token_type) {
-    this->next_syminfo_ptr = next_syminfo_ptr;
-}
-
-SymbolInfo::SymbolInfo(const string& symbol, const string& token_type, const string& semantic_type)
-    : SymbolInfo(symbol, token_type) {
+SymbolInfo::SymbolInfo(int symbol_id, const string& token_type, SemanticType semantic_type)
+    : SymbolInfo(symbol_id, token_type) {
     this->semantic_type = semantic_type;
 }
 
-SymbolInfo::SymbolInfo(const string& symbol, const string& token_type, const string& semantic_type,
-    const vector<string>& data)
-    : SymbolInfo(symbol, token_type, semantic_type) {
-    this->data = data;
-}
-
-SymbolInfo::SymbolInfo(const string& symbol, const string& token_type, const string& semantic_type,
-    const vector<string>& data, SymbolInfo* next_syminfo_ptr)
-    : SymbolInfo(symbol, token_type, semantic_type, data) {
-    this->next_syminfo_ptr = next_syminfo_ptr;
+SymbolInfo::SymbolInfo(int symbol_id, const string& token_type, SemanticType semantic_type,
+    const FuncSignature* signature)
+    : SymbolInfo(symbol_id, token_type, semantic_type) {
+    this->signature = signature;
 }
 
 SymbolInfo::SymbolInfo(const SymbolInfo& other) 
-    : SymbolInfo{other.symbol, other.token_type, other.semantic_type, other.data, other.next_syminfo_ptr} {
-        if (other.codegeninfo_ptr != nullptr) {
-            this->codegeninfo_ptr = new CodeGenInfo(*other.codegeninfo_ptr);
-        }
+    : SymbolInfo{other.symbol_id, other.token_type, other.semantic_type, other.signature} {
+        this->defined = other.defined;
+        this->codegeninfo = other.codegeninfo;
 }
 
-SymbolInfo::~SymbolInfo() {
-    delete this->codegeninfo_ptr;
-}
-
-string SymbolInfo::get_symbol() {
-    return this->symbol;
+/**
+ * @brief Returns the handle of the name in the string interner.
+ */
+int SymbolInfo::get_symbol_id() {
+    return this->symbol_id;
 }
 
 string SymbolInfo::get_token_type() {
     return this->token_type;
 }
 
-string SymbolInfo::get_semantic_type() {
+SemanticType SymbolInfo::get_semantic_type() {
     return this->semantic_type;
 }
 
-vector<string> SymbolInfo::get_all_data() {
-    return this->data;
+/**
+ * @brief Returns the interned signature of a function, nullptr if the symbol is not a function.
+ */
+const FuncSignature* SymbolInfo::get_signature() {
+    return this->signature;
 }
 
-CodeGenInfo* SymbolInfo::get_codegen_info_ptr() {
-    if (this->codegeninfo_ptr == nullptr) {
-        this->codegeninfo_ptr = new CodeGenInfo();
-    }
-    return this->codegeninfo_ptr;
+bool SymbolInfo::is_defined() {
+    return this->defined;
 }
 
-void SymbolInfo::set_all_data(vector<string> data) {
-    this->data = data;
+CodeGenInfo* SymbolInfo::get_codegen_info_ptr() {
+    return &this->codegeninfo;
 }
 
-void SymbolInfo::set_semantic_type(string semantic_type) {
+void SymbolInfo::set_semantic_type(SemanticType semantic_type) {
     this->semantic_type = semantic_type;
 }
 
-void SymbolInfo::add_data(string data_str) {
-    this->data.push_back(data_str);
+void SymbolInfo::set_defined(bool defined) {
+    this->defined = defined;
 }
-
-ostream& operator<<(ostream& ostrm, SymbolInfo& syminfo) {
-    ostrm << "<" << syminfo.get_symbol() << ", " << syminfo.get_token_type() << ">";
-    return ostrm;
-};
\ No newline at end of file
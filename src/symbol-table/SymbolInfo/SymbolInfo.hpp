@@ -1,47 +1,42 @@
 #pragma once
 #include <string>
 #include <ostream>
-#include <vector>
 #include "./CodeGenInfo/CodeGenInfo.hpp"
+#include "./SemanticType.hpp"
+#include "../StringInterner/StringInterner.hpp"
+#include "../SignatureInterner/SignatureInterner.hpp"
 
 using namespace std;
 
 /**
- * @brief Token class. Contains the name and type of the token. Also contains the pointer to the
- * next SymbolInfo in the chain for the separately chained hashtable of the Scope table.
+ * @brief Token class. Contains the name and type of the token.
  * 
- * Contains the name of the symbol, type of the token, semantic type and additional data strings 
- * for semantic analysis.
+ * Contains the name of the symbol, type of the token and semantic type for semantic analysis. The name is
+ * kept as its handle in the string interner. Functions also have their interned signature, and whether
+ * they are defined or only declared.
  */
 class SymbolInfo {
-    string symbol;
+    int symbol_id;
+    SemanticType semantic_type;
+    bool defined;
     string token_type;
-    string semantic_type;
-    vector<string> data;
+    const FuncSignature* signature;
 
-    CodeGenInfo* codegeninfo_ptr;
+    CodeGenInfo codegeninfo;
 
 public:
-    // Not allocated or destroyed inside SymbolInfo class. 
-    SymbolInfo* next_syminfo_ptr;
-
-    SymbolInfo(const string&, const string&);
-    SymbolInfo(const string&, const string&, SymbolInfo*);
-    SymbolInfo(const string&, const string&, const string&);
-    SymbolInfo(const string&, const string&, const string&, const vector<string>&);
-    SymbolInfo(const string&, const string&, const string&, const vector<string>&, SymbolInfo*);
+    SymbolInfo(int, const string&);
+    SymbolInfo(int, const string&, SemanticType);
+    SymbolInfo(int, const string&, SemanticType, const FuncSignature*);
     SymbolInfo(const SymbolInfo&);
-    ~SymbolInfo();
 
-    string get_symbol();
+    int get_symbol_id();
     string get_token_type();
-    string get_semantic_type();
-    vector<string> get_all_data();
-    CodeGenInfo* get_codegen_info_ptr(); // lazy init
-
-    void set_semantic_type(string type);
-    void set_all_data(vector<string>);
-    void add_data(string);
+    SemanticType get_semantic_type();
+    const FuncSignature* get_signature();
+    bool is_defined();
+    CodeGenInfo* get_codegen_info_ptr();
 
-    friend ostream& operator<<(ostream& ostrm, SymbolInfo& syminfo);
+    void set_semantic_type(SemanticType type);
+    void set_defined(bool);
 };
@@ -1,45 +1,67 @@
+#include <algorithm>
 #include "SymbolTable.hpp"
 
 using namespace std;
 
-SymbolTable::SymbolTable(int total_buckets)
-    : scope_tables(),
-    current_scope_table(nullptr),
-    total_buckets(total_buckets) {
+SymbolTable::SymbolTable(int total_buckets, StringInterner& string_interner)
+    : current_scope_table(nullptr),
+    scope_tables(),
+    total_buckets(total_buckets),
+    string_interner(string_interner),
+    scope_count(0) {
     this->enter_scope();
 }
 
 SymbolTable::~SymbolTable() {
-    ScopeTable* current = this->current_scope_table;
-
     while (this->scope_tables.size() != 0) {
         this->exit_scope();
     }
+
+    for (ScopeTable* scope_table : this->scope_table_pool) {
+        delete scope_table;
+    }
 }
 
 /**
- * @brief Pushes a new scope table on top of the scope table stack.
+ * @brief Pushes a new scope table on top of the scope table stack. Recycles a pooled scope table if
+ * there is one.
  */
 void SymbolTable::enter_scope() {
-    ScopeTable* new_scope_table = new ScopeTable(this->total_buckets, this->current_scope_table);
+    ScopeTable* new_scope_table;
+    if (this->scope_table_pool.empty()) {
+        new_scope_table = new ScopeTable(this->total_buckets, this->current_scope_table, this->string_interner);
+    } else {
+        new_scope_table = this->scope_table_pool.back();
+        this->scope_table_pool.pop_back();
+        new_scope_table->set_parent_scope_ptr_with_id_currentid(this->current_scope_table);
+    }
+
     this->scope_tables.push_back(new_scope_table);
+    this->scope_symbols.emplace_back();
+    this->scope_count++;
     this->current_scope_table = new_scope_table;
 }
 
 /**
- * @brief Pops the current top scope from the scope table stack.
- *
+ * @brief Pops the current top scope from the scope table stack, along with the bindings it introduced.
+ * The scope table is cleared and pooled.
  */
 void SymbolTable::exit_scope() {
     if (this->current_scope_table == nullptr) {
         return;
     }
 
+    for (SymbolInfo* syminfo_ptr : this->scope_symbols.back()) {
+        this->bindings[syminfo_ptr->get_symbol_id()].pop_back();
+    }
+    this->scope_symbols.pop_back();
+
     ScopeTable* old_current_scope_table = this->current_scope_table;
     this->current_scope_table = this->current_scope_table->get_parent_scope();
     this->scope_tables.pop_back();
 
-    delete old_current_scope_table;
+    old_current_scope_table->clear();
+    this->scope_table_pool.push_back(old_current_scope_table);
 
     if (this->current_scope_table != nullptr) {
         this->current_scope_table->set_num_deleted_children(
@@ -51,58 +73,58 @@ void SymbolTable::exit_scope() {
 /**
  * @brief Inserts the provided token into the current scope table.
  *
- * @param symbol Symbol name
+ * @param symbol_id Handle of the symbol name
  * @param token_type Token type
  * @return true When insertion is successful
  * @return false When insertion is not successful (collision or no scope table)
  */
-bool SymbolTable::insert(const string& symbol, const string& token_type) {
+bool SymbolTable::insert(int symbol_id, const string& token_type) {
     if (this->current_scope_table == nullptr) {
         return false;
     }
 
-    return this->current_scope_table->insert(symbol, token_type);
+    return this->bind(symbol_id, this->current_scope_table->insert(symbol_id, token_type));
 }
 
 /**
  * @brief Inserts the provided token into the current scope table.
  *
- * @param symbol Symbol name
+ * @param symbol_id Handle of the symbol name
  * @param token_type Token type
  * @param semantic_type Semantic type for semantic analysis
  * @return true When insertion is successful
  * @return false When insertion is not successful (collision or no scope table)
  */
-bool SymbolTable::insert(const string& symbol, const string& token_type,
-    string semantic_type) {
+bool SymbolTable::insert(int symbol_id, const string& token_type,
+    SemanticType semantic_type) {
     if (this->current_scope_table == nullptr) {
         return false;
     }
 
-    return this->current_scope_table->insert(symbol, token_type, semantic_type);
+    return this->bind(symbol_id, this->current_scope_table->insert(symbol_id, token_type, semantic_type));
 }
 
 /**
  * @brief Inserts the provided token into the current scope table.
  *
- * @param symbol Symbol name
+ * @param symbol_id Handle of the symbol name
  * @param token_type Token type
  * @param semantic_type Semantic type for semantic analysis
- * @param data Additional data strings for semantic analysis
+ * @param signature Interned signature of a function
  * @return true When insertion is successful
  * @return false When insertion is not successful (collision or no scope table)
  */
-bool SymbolTable::insert(const string& symbol, const string& token_type,
-    string semantic_type, vector<string> data) {
+bool SymbolTable::insert(int symbol_id, const string& token_type,
+    SemanticType semantic_type, const FuncSignature* signature) {
     if (this->current_scope_table == nullptr) {
         return false;
     }
 
-    return this->current_scope_table->insert(symbol, token_type, semantic_type, data);
+    return this->bind(symbol_id, this->current_scope_table->insert(symbol_id, token_type, semantic_type, signature));
 }
 
 /**
- * @brief Inserts a copy of the provided symbol ptr. Copies symbol name, token type semantic type, data[], 
+ * @brief Inserts a copy of the provided symbol ptr. Copies symbol name, token type semantic type, signature, 
  * and Code generation info. 
  * 
  * @param syminfo_ptr Pointer to the symbol to be inserted.
@@ -114,48 +136,47 @@ bool SymbolTable::insert_copy(SymbolInfo* syminfo_ptr) {
         return false;
     }
 
-    return this->current_scope_table->insert_copy(syminfo_ptr);
+    return this->bind(syminfo_ptr->get_symbol_id(), this->current_scope_table->insert_copy(syminfo_ptr));
 }
 
 /**
  * @brief Removes a token from the current scope table.
  *
- * @param symbol Symbol to delete
+ * @param symbol_id Handle of the symbol to delete
  * @return true When delete is successful
  * @return false When delete is not successful (Not found or no scope table)
  */
-bool SymbolTable::remove(const string& symbol) {
+bool SymbolTable::remove(int symbol_id) {
     if (this->current_scope_table == nullptr) {
         return false;
     }
 
-    return this->current_scope_table->delete_symbolinfo(symbol);
+    SymbolInfo* syminfo_ptr = this->current_scope_table->lookup(symbol_id);
+    if (syminfo_ptr == nullptr) {
+        return false;
+    }
+
+    // binding of the current scope is the innermost one
+    this->bindings[symbol_id].pop_back();
+    vector<SymbolInfo*>& current_scope_symbols = this->scope_symbols.back();
+    current_scope_symbols.erase(find(current_scope_symbols.begin(), current_scope_symbols.end(), syminfo_ptr));
+
+    return this->current_scope_table->delete_symbolinfo(symbol_id);
 }
 
 /**
- * @brief Searches for a token by name. Searches from the current scope. Traverses the scope stack
- * top to bottom until token is found. If not found, nullptr is returned.
+ * @brief Searches for a token by name. Finds the token of the innermost scope it is declared in, starting
+ * from the current scope. If not found, nullptr is returned.
  *
- * @param symbol Symbol name
+ * @param symbol_id Handle of the symbol name
  * @return SymbolInfo* Target token. If not found, nullptr is returned.
  */
-SymbolInfo* SymbolTable::lookup(const string& symbol) {
-    if (current_scope_table == nullptr) {
+SymbolInfo* SymbolTable::lookup(int symbol_id) {
+    if (symbol_id >= (int)this->bindings.size() || this->bindings[symbol_id].empty()) {
         return nullptr;
     }
 
-    SymbolInfo* target = nullptr;
-    ScopeTable* current_scope = this->current_scope_table;
-
-    while (current_scope != nullptr) {
-        target = current_scope->lookup(symbol);
-        if (target != nullptr) {
-            break;
-        }
-        current_scope = current_scope->get_parent_scope();
-    }
-
-    return target;
+    return this->bindings[symbol_id].back();
 }
 
 /**
@@ -167,6 +188,31 @@ int SymbolTable::get_current_scope_size() {
     return this->current_scope_table->get_size();
 }
 
+/**
+ * @brief Returns the depth of the current scope-table. The global scope has depth 1.
+ * 
+ * @return int depth of the current scope-table, 0 if there is no scope.
+ */
+int SymbolTable::get_current_scope_depth() {
+    return this->scope_tables.size();
+}
+
+/**
+ * @brief Returns the counts of the work of the symbol table so far, over the open and the pooled scope tables.
+ *
+ * @return SymbolTableStats counts of allocations, scopes entered and probes
+ */
+SymbolTableStats SymbolTable::get_stats() {
+    SymbolTableStats stats{0, this->scope_count, 0, 0};
+    for (ScopeTable* scope_table : this->scope_tables) {
+        scope_table->add_stats(stats);
+    }
+    for (ScopeTable* scope_table : this->scope_table_pool) {
+        scope_table->add_stats(stats);
+    }
+    return stats;
+}
+
 ostream& operator<<(ostream& ostrm, SymbolTable& symbol_table) {
     ostrm << "==========================Symbol Table==================================\n";
     for (auto rev_iter = symbol_table.scope_tables.rbegin(); rev_iter != symbol_table.scope_tables.rend(); rev_iter++) {
@@ -176,4 +222,23 @@ ostream& operator<<(ostream& ostrm, SymbolTable& symbol_table) {
     }
     ostrm << "==========================------X------=================================\n";
     return ostrm;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Pushes the binding of a symbol just inserted into the current scope table.
+ *
+ * @param symbol_id Handle of the symbol name
+ * @param is_inserted Result of the insertion
+ * @return bool Result of the insertion
+ */
+bool SymbolTable::bind(int symbol_id, bool is_inserted) {
+    if (is_inserted) {
+        SymbolInfo* syminfo_ptr = this->current_scope_table->lookup(symbol_id);
+        if (symbol_id >= (int)this->bindings.size()) {
+            this->bindings.resize(symbol_id + 1);
+        }
+        this->bindings[symbol_id].push_back(syminfo_ptr);
+        this->scope_symbols.back().push_back(syminfo_ptr);
+    }
+    return is_inserted;
+}
@@ -9,14 +9,28 @@ using namespace std;
  * scopes. Can create push new scope upon entering, pop old scope upon exitting. Can insert new token
  * remove token from current scope. Also can lookup token by name, inside current scope - and all 
  * scopes below it as long as token is not found.  
+ *
+ * Every name handle maps to the stack of its bindings in the open scopes, innermost on top, so a lookup is a
+ * single probe however deep the scope is. Exiting a scope pops the bindings it introduced. Exited scope
+ * tables are kept in a pool and recycled for new scopes.
+ *
+ * Counts the scopes entered, and the allocations and probes of its scope tables.
  */
 class SymbolTable {
     ScopeTable* current_scope_table;
     vector<ScopeTable*> scope_tables;
     const int total_buckets;
+    StringInterner& string_interner;
+
+    // binding stacks indexed by the interned handle of the name
+    vector<vector<SymbolInfo*>> bindings;
+    // symbols introduced by each scope of the scope table stack
+    vector<vector<SymbolInfo*>> scope_symbols;
+    vector<ScopeTable*> scope_table_pool;
+    unsigned long scope_count;
 
 public:
-    SymbolTable(int);
+    SymbolTable(int, StringInterner&);
 
     SymbolTable(int, ostream&);
 
@@ -26,19 +40,26 @@ public:
 
     void exit_scope();
 
-    bool insert(const string&, const string&);
+    bool insert(int, const string&);
 
-    bool insert(const string&, const string&, string);
+    bool insert(int, const string&, SemanticType);
 
-    bool insert(const string&, const string&, string, vector<string>);
+    bool insert(int, const string&, SemanticType, const FuncSignature*);
 
     bool insert_copy(SymbolInfo*);
 
-    bool remove(const string&);
+    bool remove(int);
 
-    SymbolInfo* lookup(const string&);
+    SymbolInfo* lookup(int);
 
     int get_current_scope_size();
 
+    int get_current_scope_depth();
+
+    SymbolTableStats get_stats();
+
     friend ostream& operator<<(ostream&, SymbolTable&);
+
+private:
+    bool bind(int, bool);
 };
\ No newline at end of file
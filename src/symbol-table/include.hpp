@@ -2,4 +2,7 @@
 // headers
 #include "ScopeTable/ScopeTable.hpp"
 #include "SymbolInfo/SymbolInfo.hpp"
-#include "SymbolTable/SymbolTable.hpp"
\ No newline at end of file
+#include "SymbolInfo/SemanticType.hpp"
+#include "SymbolTable/SymbolTable.hpp"
+#include "StringInterner/StringInterner.hpp"
+#include "SignatureInterner/SignatureInterner.hpp"
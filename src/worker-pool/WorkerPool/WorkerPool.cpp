@@ -0,0 +1,38 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "WorkerPool.hpp"
+
+using namespace std;
+
+/**
+ * @param job_count Most threads the tasks run on
+ */
+WorkerPool::WorkerPool(int job_count)
+    : job_count(job_count) {
+}
+
+/**
+ * @brief Runs the tasks, and returns once all of them are done.
+ *
+ * @param task_count Number of tasks
+ * @param task Called with the index of each task
+ */
+void WorkerPool::run(int task_count, const function<void(int)>& task) {
+    atomic<int> next_task_idx{ 0 };
+    auto run_tasks = [&]() {
+        for (int i = next_task_idx++; i < task_count; i = next_task_idx++) {
+            task(i);
+        }
+    };
+
+    vector<thread> workers;
+    for (int i = 1; i < min(this->job_count, task_count); i++) {
+        workers.emplace_back(run_tasks);
+    }
+    run_tasks();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <functional>
+
+using namespace std;
+
+/**
+ * @brief Runs independent tasks on up to job_count threads, the calling thread being one of them. Each thread
+ * takes the next task whenever it finishes one, so tasks of different lengths balance across the threads.
+ * With a single job or a single task, the tasks run on the calling thread, in order.
+ */
+class WorkerPool {
+    int job_count;
+
+public:
+    WorkerPool(int);
+
+    void run(int, const function<void(int)>&);
+};
@@ -0,0 +1,3 @@
+#pragma once
+// headers
+#include "WorkerPool/WorkerPool.hpp"